@@ -0,0 +1,81 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace MVT {
+	/// Subsystem the heap allocations of a thread are counted in, see `AllocationScope`. Jobs count in the category of
+	/// the thread that queued them.
+	enum class AllocationCategory : uint8_t {
+		Other, // Threads and scopes without a category.
+		Frame, // The render thread drawing a frame, and its jobs. Nothing once the frames reached a steady state.
+		Resources, // GPU objects (re)created from the frame: swapchain, pipelines, transient images, command buffers.
+		Streaming, // Texture residency changes.
+		Assets, // Loads and cooks, including the coroutines resumed by the render thread.
+		Count,
+	};
+
+	struct AllocationCounts {
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+	};
+
+	/// Counts the allocations of the global `operator new`, per category. The operators are only replaced when the build
+	/// defines `MVT_TRACK_ALLOCATIONS`, the counts stay at 0 otherwise.
+	class AllocationTracker {
+	public:
+#ifdef MVT_TRACK_ALLOCATIONS
+		static inline constexpr bool c_Enabled = true;
+#else
+		static inline constexpr bool c_Enabled = false;
+#endif
+
+	public:
+		[[nodiscard]] static AllocationCategory GetCategory() { return s_Category; }
+
+		/// Allocations so far, monotonic: the difference of two reads is what happened in between.
+		[[nodiscard]] static AllocationCounts GetCounts(AllocationCategory category);
+
+		[[nodiscard]] static const char *GetName(AllocationCategory category);
+
+		/// Called by `operator new`: must neither allocate nor throw.
+		static void Record(size_t bytes) noexcept {
+			Counter &counter = s_Counters[static_cast<size_t>(s_Category)];
+			counter.allocations.fetch_add(1, std::memory_order_relaxed);
+			counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+	private:
+		friend class AllocationScope;
+
+		struct alignas(64) Counter {
+			std::atomic<uint64_t> allocations{0};
+			std::atomic<uint64_t> bytes{0};
+		};
+
+		// Constant initialized: usable by the allocations made before `main`.
+		static std::array<Counter, static_cast<size_t>(AllocationCategory::Count)> s_Counters;
+		static inline thread_local AllocationCategory s_Category = AllocationCategory::Other;
+	};
+
+	/// Counts the allocations of the current thread in `category` until its destruction.
+	class AllocationScope {
+	public:
+		explicit AllocationScope(const AllocationCategory category) : m_Previous(AllocationTracker::s_Category) { AllocationTracker::s_Category = category; }
+
+		~AllocationScope() { AllocationTracker::s_Category = m_Previous; }
+
+		AllocationScope(const AllocationScope &) = delete;
+
+		AllocationScope &operator=(const AllocationScope &) = delete;
+
+	private:
+		AllocationCategory m_Previous;
+	};
+} // MVT
@@ -0,0 +1,103 @@
+//
+// Created by ianpo on 14/01/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include "MVT/FrameScheduler.hpp"
+
+namespace MVT {
+	/// From the cheapest to the most expensive.
+	enum class AntiAliasingMode : uint8_t {
+		None, // Performance mode, the scene is rendered straight into the swapchain image.
+		Fxaa, // Single sample scene, compute FXAA pass (see `fxaa.slang`) then a blit to the swapchain image.
+		Msaa, // Multisampled scene resolved in the swapchain image.
+	};
+
+	struct AntiAliasingSettings {
+		AntiAliasingMode mode = AntiAliasingMode::Msaa;
+		/// Sample count of the MSAA mode, clamped to what the device supports.
+		vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e4;
+		/// Step down to cheaper modes while the GPU frame time is over budget, and back up when there is headroom again.
+		/// The configured mode is the most expensive one used.
+		bool adaptive = false;
+		double budgetMilliseconds = 1000.0 / 60.0;
+	};
+
+	/// Choose the anti-aliasing mode from the settings, the device capabilities and the measured GPU frame times.
+	/// The available modes form a ladder, e.g. MSAA 8x, 4x, 2x, FXAA, None: the adaptive policy moves one step at a time.
+	class AntiAliasingPolicy {
+	public:
+		/// GPU frame times averaged before a decision.
+		static inline constexpr uint32_t c_SampleWindow = 60;
+		/// Frames ignored after a change, the first frames of a mode pay for its new attachments.
+		static inline constexpr uint32_t c_Cooldown = 120;
+		/// Step up only below this fraction of the budget, so the next step is unlikely to overshoot.
+		static inline constexpr double c_HeadroomRatio = 0.6;
+
+		struct Level {
+			AntiAliasingMode mode = AntiAliasingMode::None;
+			vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+		};
+
+	public:
+		AntiAliasingPolicy() = default;
+
+		/// `supportedSamples` is the intersection of the color and depth framebuffer sample counts.
+		AntiAliasingPolicy(const AntiAliasingSettings &settings, vk::SampleCountFlags supportedSamples, bool fxaaSupported);
+
+		[[nodiscard]] const Level &getLevel() const { return m_Levels[m_Current]; }
+
+		[[nodiscard]] AntiAliasingMode getMode() const { return getLevel().mode; }
+
+		/// Samples of the scene attachments, e1 unless the mode is MSAA.
+		[[nodiscard]] vk::SampleCountFlagBits getSamples() const { return getLevel().samples; }
+
+		/// Feed the GPU time of a frame. Return true when the level changed.
+		bool update(double gpuMilliseconds);
+
+		[[nodiscard]] static const char *GetName(AntiAliasingMode mode);
+
+	private:
+		AntiAliasingSettings m_Settings{};
+		std::vector<Level> m_Levels{Level{}}; // Cheapest first.
+		uint32_t m_Configured = 0;
+		uint32_t m_Current = 0;
+		double m_Accumulated = 0.0;
+		uint32_t m_Samples = 0;
+		uint32_t m_Cooldown = 0;
+	};
+
+	/// Compute FXAA over a single sample image. Reads the scene through a linear sampler and writes a storage image of
+	/// the same size, one descriptor set per frame slot rewritten when the slot records.
+	class FxaaPass {
+	public:
+		static inline constexpr vk::Format c_OutputFormat = vk::Format::eR16G16B16A16Sfloat;
+
+	public:
+		FxaaPass() = default;
+
+		FxaaPass(const vk::raii::Device &device, const std::vector<char> &spirv);
+
+		[[nodiscard]] bool isValid() const { return *m_Pipeline != VK_NULL_HANDLE; }
+
+		/// Filter the top left `extent` of images of `imageExtent`. `source` must be in `eShaderReadOnlyOptimal`, `destination`
+		/// in `eGeneral`. The slot's previous frame must have completed.
+		void record(const vk::raii::CommandBuffer &commandBuffer, uint32_t slot, vk::ImageView source, vk::ImageView destination, vk::Extent2D extent, vk::Extent2D imageExtent) const;
+
+		void clear();
+
+	private:
+		const vk::raii::Device *m_Device = nullptr;
+		vk::raii::DescriptorSetLayout m_DescriptorSetLayout = nullptr;
+		vk::raii::PipelineLayout m_PipelineLayout = nullptr;
+		vk::raii::Pipeline m_Pipeline = nullptr;
+		vk::raii::Sampler m_Sampler = nullptr;
+		vk::raii::DescriptorPool m_Pool = nullptr;
+		std::vector<vk::raii::DescriptorSet> m_Sets{}; // One per frame slot.
+	};
+} // MVT
@@ -4,13 +4,40 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <complex.h>
+#include <exception>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <SDL3/SDL.h>
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_raii.hpp>
 #include <vk_mem_alloc.h>
 
+#include "MVT/AllocationTracker.hpp"
+#include "MVT/AntiAliasing.hpp"
+#include "MVT/BindlessTable.hpp"
+#include "MVT/ComputeDownsampler.hpp"
+#include "MVT/DeletionQueue.hpp"
+#include "MVT/DrawQueue.hpp"
+#include "MVT/DynamicResolution.hpp"
+#include "MVT/Expected.hpp"
+#include "MVT/FrameAllocator.hpp"
+#include "MVT/FrameMailbox.hpp"
+#include "MVT/FrameScheduler.hpp"
+#include "MVT/FrameScratch.hpp"
+#include "MVT/GpuTimer.hpp"
+#include "MVT/KTX2.hpp"
+#include "MVT/Material.hpp"
 #include "MVT/Mesh.hpp"
+#include "MVT/ParallelRecorder.hpp"
+#include "MVT/RenderGraph.hpp"
+#include "MVT/StartupTrace.hpp"
+#include "MVT/Task.hpp"
+#include "MVT/TextureCooker.hpp"
+#include "MVT/TextureResidency.hpp"
 #include "MVT/VulkanMemoryAllocator.hpp"
 #include "MVT/VulkanMesh.hpp"
 
@@ -40,9 +67,52 @@ namespace MVT {
 		Transfer,
 	};
 
+	enum class MipGenerationMode {
+		Cpu, // stb_image_resize2 on the CPU, uploaded with the base level.
+		Blit, // Chain of blits on the graphics queue.
+		Compute, // Single pass compute downsampler, see `downsample.slang`.
+	};
+
+	/// How the per-draw transform reaches the vertex shader.
+	enum class PerDrawPath {
+		PushConstants, // Pushed with the material index, set 0 is bound once per secondary.
+		DynamicUniform, // `ObjectUniform` in the frame allocator, set 0 rebound per draw with its dynamic offset.
+	};
+
+	/// What the main thread hands over to the render thread: everything a frame reads from the simulation.
+	struct FramePacket {
+		uint64_t sequence = 0;
+		std::chrono::steady_clock::time_point published{};
+		glm::vec3 cameraPosition{2.0f, 2.0f, 2.0f};
+		float cameraFovDegrees = 45.0f;
+		glm::mat4 sceneModel{1.0f};
+		vk::Extent2D framebufferExtent{}; // Window size in pixels when published, 0x0 before the first packet.
+		bool minimized = false;
+		bool animating = false;
+	};
+
 	class Application {
 	public: // Vulkan Specific
-		static inline constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+		/// Capacity of the per-frame resources, the depth actually used is `setFramesInFlight`.
+		static inline constexpr int MAX_FRAMES_IN_FLIGHT = FrameScheduler::c_MaxFramesInFlight;
+		/// Below this, splitting the draws costs more than it saves.
+		static inline constexpr uint32_t c_MinDrawsPerRecordingThread = 512;
+		/// Camera moves, relative to the scene, that re-sort and re-record the static draws.
+		static inline constexpr float c_StaticDrawsResortDistance = 0.25f;
+		/// Frames averaged by the recording time report.
+		static inline constexpr uint32_t c_RecordingReportInterval = 600;
+		/// Longest block in the event queue while there is nothing to draw, the shader hot reload is polled in between.
+		static inline constexpr int32_t c_IdleEventTimeoutMs = 250;
+		/// The frame cap sleeps until this close to the deadline, then yields.
+		static inline constexpr std::chrono::microseconds c_FrameCapSpinTime{2000};
+		/// Rate of the simulation packets while animating, independent of the frame rate.
+		static inline constexpr std::chrono::microseconds c_SimulationStep{1000000 / 240};
+		/// Texture of the default material, also cooked ahead at startup.
+		static inline constexpr const char *c_DefaultTexturePath = "EngineAssets/Textures/viking_room.png";
+		/// Bytes of uniforms and per-draw data a frame can allocate.
+		static inline constexpr vk::DeviceSize c_FrameAllocatorRegionSize = 8ull << 20;
+		/// Frames drawn before the allocations of a frame are expected to stop: pools, queues and scratch grow meanwhile.
+		static inline constexpr uint32_t c_AllocationWarmupFrames = 240;
 		static inline const std::vector validationLayers = {
 			"VK_LAYER_KHRONOS_validation",
 		};
@@ -58,17 +128,82 @@ namespace MVT {
 
 		~Application();
 
+		/// Initialize the window and Vulkan with the settings given so far, then run until the window closes.
 		void run();
 
+		/// Trade latency for throughput, between 1 and `MAX_FRAMES_IN_FLIGHT`. Applied at the next frame.
+		void setFramesInFlight(uint32_t count);
+
+		/// Threads recording the draws, the main thread included. 0 uses every hardware thread.
+		void setRecordingThreads(uint32_t count);
+
+		/// Repeat the mesh draws `copies` more times, to measure recording under load.
+		void setStressDraws(uint32_t copies) { stressDrawCopies = copies; }
+
+		void setPerDrawPath(const PerDrawPath path) { perDrawPath = path; }
+
+		/// Alternate between the per-draw paths every report and print their recording times side by side.
+		void setPerDrawBenchmark(const bool enabled) { perDrawBenchmark = enabled; }
+
+		/// Record the scene once per frame slot and resubmit it until the draw list, the pipeline or the swapchain changes.
+		void setStaticDraws(const bool enabled) { staticDrawsEnabled = enabled; }
+
+		/// Lay the depth of the opaque draws first, the main pass then only shades the visible fragments.
+		void setDepthPrepass(const bool enabled) { depthPrepass = enabled; }
+
+		/// Mark the materials of the loaded models single sided, their back faces are culled. Applied when they load.
+		void setSingleSidedModels(const bool enabled) { modelMaterialFlags = enabled ? c_MaterialSingleSided : 0; }
+
+		/// Anti-aliasing mode, sample count and frame time budget. Applied when Vulkan is initialized.
+		void setAntiAliasing(const AntiAliasingSettings &settings) { antiAliasingSettings = settings; }
+
+		/// Only draw when something changed: an event, a resize, a hot reload or streamed mips. Stops the animation, which
+		/// would change every frame; `setAnimation` afterward brings it back.
+		void setRenderOnDemand(const bool enabled) {
+			renderOnDemand = enabled;
+			animate = !enabled;
+		}
+
+		void setAnimation(const bool enabled) { animate = enabled; }
+
+		/// Frames per second at most, 0 for no cap.
+		void setFrameRateCap(const uint32_t framesPerSecond) { frameRateCap = framesPerSecond; }
+
+		/// Render the 3D passes at a scale following the GPU frame time, upscaled in the swapchain image. Applied when Vulkan is initialized.
+		void setDynamicResolution(const DynamicResolutionSettings &settings) { dynamicResolutionSettings = settings; }
+
+		/// Draw `frames` frames past the warm up and quit, failing the run if one of them allocated in
+		/// `AllocationCategory::Frame`. Needs a build with `MVT_TRACK_ALLOCATIONS`.
+		void setAllocationCheck(uint32_t frames);
+
 	private:
 		void initWindow(const char *windowName, WindowParameters parameters = {1600, 900, true});
 
 		void initVulkan(const char *appName);
 
+		/// Event and simulation thread, feeds `renderLoop` through `frameMailbox`.
 		void mainLoop();
 
+		/// Ask the render thread to stop and join it, if it runs. Returns once nothing uses Vulkan but this thread.
+		void stopRenderThread();
+
+		/// Fill and publish the packet of the current simulation state.
+		void publishFramePacket();
+
+		/// Render thread: the only one to touch Vulkan between the initialization and the cleanup.
+		void renderLoop();
+
 		void cleanup();
 
+		/// Sleep until the next frame of the frame rate cap.
+		void waitForFrameCap();
+
+		/// Account the frame that just finished, `before` being the frame counts when it started. Warn about a steady state
+		/// frame that allocated, and report the allocations of every category periodically.
+		void trackFrameAllocations(const AllocationCounts &before);
+
+		void requestRedraw() { redrawRequested = true; }
+
 	private: // High Level Vulkan Specific
 		void drawFrame();
 
@@ -112,25 +247,81 @@ namespace MVT {
 
 		void createSurface();
 
-		void createSwapChain();
+		void createSwapChain(vk::SwapchainKHR oldSwapchain = nullptr);
 
 		void createSwapChainViews();
 
 		void createDescriptorSetLayout();
 
+		void createBindlessTable();
+
 		void createGraphicsPipeline();
 
+		/// Compile the startup shaders on a worker while the device is created, see `compileShader`.
+		void prefetchShaders();
+
+		/// SPIR-V of `shaderName`, prefetched at startup or compiled now.
+		Expected<std::vector<char>, std::string> compileShader(const char *shaderName);
+
 		void createCommandPool();
 
-		void createColorResources();
+		void createRenderGraph();
+
+		VkTexture createTextureImage(const char *path, TextureUsage usage = TextureUsage::Color);
+
+		VkTexture createTextureImage(const Ktx2Texture &source);
+
+		std::vector<VkTexture> createTextureImages(std::span<const char *const> paths, TextureUsage usage = TextureUsage::Color);
+
+		/// Record and submit the upload of every level of `source` in a new image, without waiting.
+		/// Return the timeline value of the upload, the staging memory is retired with it.
+		uint64_t submitTextureUpload(const Ktx2Texture &source, VkTexture &texture);
 
-		void createDepthResources();
+		/// Cook on a worker when the CPU builds the mips, then upload from the render thread.
+		Task<void> loadTextureAsync(TextureCookRequest request, TextureUsage usage, VkTexture &texture);
 
-		VkTexture createTextureImage(const char *path);
+		bool supportsLinearBlit(vk::Format format);
+
+		vk::Format selectTextureFormat(TextureUsage usage);
 
 		void generateMipmaps(vk::Image image, vk::Format imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels);
 
-		void createTextureImage();
+		void generateMipmapsCompute(vk::Image image, vk::Format imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels);
+
+		bool supportsGpuMipGeneration(vk::Format format);
+
+		void createMipGenerators();
+
+		void createAntiAliasing();
+
+		void createDynamicResolution();
+
+		/// Feed the GPU time of the slot's previous frame to the resolution and anti-aliasing controllers, rebuild the
+		/// pipelines if the sample count changed.
+		void updateFrameControllers();
+
+		/// Default texture, from `cooked` when it was cooked ahead.
+		void createTextureImage(std::optional<Ktx2Texture> &cooked);
+
+		/// Give the texture its bindless slots.
+		void registerTexture(VkTexture &texture);
+
+		void releaseTexture(VkTexture &texture);
+
+		/// `flags` are `MaterialFlags`.
+		uint32_t createMaterial(const VkTexture &albedo, glm::vec4 baseColor = glm::vec4{1.0f}, uint32_t flags = 0);
+
+		uint32_t createStreamedMaterial(uint32_t streamedTexture, glm::vec4 baseColor = glm::vec4{1.0f}, uint32_t flags = 0);
+
+		/// Copy the material table in the frame's region if it changed since that frame last used it.
+		void uploadMaterials(uint32_t frame);
+
+		void createTextureResidency();
+
+		/// Request mips for the streamed textures, from the projected size of the meshes using them.
+		void updateTextureStreaming();
+
+		void refreshStreamedMaterials();
 
 		vk::Format findSupportedFormat(const std::vector<vk::Format> &candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features);
 
@@ -140,7 +331,7 @@ namespace MVT {
 
 		void createImage(uint32_t width, uint32_t height, uint32_t mipLevel, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image &image, vk::raii::DeviceMemory &imageMemory);
 
-		void createImage(uint32_t width, uint32_t height, uint32_t mipLevel, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image &image, vk::raii::DeviceMemory &imageMemory, const std::vector<uint32_t> &families);
+		void createImage(uint32_t width, uint32_t height, uint32_t mipLevel, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image &image, vk::raii::DeviceMemory &imageMemory, const std::vector<uint32_t> &families, vk::ImageCreateFlags flags = {});
 
 		vk::raii::ImageView createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags imageAspect, uint32_t mipLevels);
 
@@ -154,6 +345,29 @@ namespace MVT {
 
 		void loadModel(const char *cModelPath, const char **cTexturesPaths, uint32_t textureCount);
 
+		/// Read and parse on a worker, create the buffers from the render thread.
+		Task<void> loadMeshesAsync(std::filesystem::path path, std::vector<VkMesh> &meshes);
+
+		/// The textures load while `geometry` is parsed, the mesh and its materials are created once both are done.
+		/// `defaultCook` is the cook of `c_DefaultTexturePath` already running: that texture reads its result from the
+		/// cache once it finished instead of being cooked a second time.
+		Task<void> loadModelAsync(StartedTask<MeshData> geometry, const char **cTexturesPaths, uint32_t textureCount, StartedTask<void> *defaultCook = nullptr);
+
+		/// Block the thread owning Vulkan until `task` finished, resuming the parts of it that wait on this thread.
+		template<typename T>
+		T runLoad(Task<T> task) {
+			return SyncWait(std::move(task), [this]() { resumeLoads(); });
+		}
+
+		/// `runLoad` for a load started earlier.
+		template<typename T>
+		T joinLoad(StartedTask<T> &task) {
+			return task.join([this]() { resumeLoads(); });
+		}
+
+		/// Wait for the next timeline value a load waits on and resume it, or yield when they all run on the workers.
+		void resumeLoads();
+
 		MVT::VkMesh createMesh(const Vertex* pVertices, uint32_t verticesCount);
 		MVT::VkMesh createMesh(const Vertex* pVertices, uint32_t verticesCount, const uint32_t *pIndices, uint32_t indicesCount);
 
@@ -164,12 +378,14 @@ namespace MVT {
 
 		void createVertexBuffer(const std::vector<Vertex> &vertices);
 
-		void waitAndResetFence();
 
 		void createVertexBuffer(const Vertex *vertices, uint64_t count);
 
 		std::pair<vk::raii::Buffer, vk::raii::DeviceMemory> makeVertexBuffer(const Vertex *vertices, uint64_t count);
 
+		/// Tightly packed positions of `vertices`, the stream of the depth pre-pass.
+		std::pair<vk::raii::Buffer, vk::raii::DeviceMemory> makePositionBuffer(const Vertex *vertices, uint64_t count);
+
 		template<uint64_t count>
 		void createIndexBuffer(const std::array<uint32_t, count> &indices) { createIndexBuffer(indices.data(), indices.size()); }
 
@@ -196,18 +412,36 @@ namespace MVT {
 
 		void createSyncObjects();
 
-		void recordCommandBuffer(uint32_t imageIndex);
+		void createParallelRecorder();
+
+		void createStaticDraws();
+
+		/// Re-record the secondaries of the current slot's `staticDraws` if their inputs changed.
+		void prepareStaticDraws(const vk::CommandBufferInheritanceRenderingInfo &mainRendering, const vk::CommandBufferInheritanceRenderingInfo &depthRendering);
 
-		void updateUniformBuffer(uint32_t currentImage);
+		/// Flatten everything drawn this frame in `drawList`.
+		void buildDrawList();
 
-		void transition_image_layout(vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, vk::AccessFlags2 srcAccessMask, vk::AccessFlags2 dstAccessMask, vk::PipelineStageFlags2 srcStageMask, vk::PipelineStageFlags2 dstStageMask, vk::ImageAspectFlags image_aspect_flags);
+		/// Record `drawList[begin, end)` in a secondary command buffer of the main pass, or of the depth pre-pass.
+		void recordDraws(const vk::raii::CommandBuffer &commandBuffer, uint32_t begin, uint32_t end, bool depthOnly = false) const;
+
+		void createRenderFinishedSemaphores();
+
+		void recordCommandBuffer(uint32_t imageIndex);
+
+		/// Push the frame uniforms in the frame allocator.
+		void updateUniformBuffer();
 
 		// void transferBufferQueue(const vk::Buffer &buffer, QueueType oldQueue, QueueType newQueue, vk::PipelineStageFlags src = vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlags dst = vk::PipelineStageFlagBits::eAllCommands);
 
 		void transitionImageLayout(const vk::raii::Image &image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, QueueType type, uint32_t mipLevels);
 
+		static vk::ImageMemoryBarrier2 MakeLayoutBarrier(vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels);
+
 		void copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height, QueueType queue);
 
+		void copyBufferToImage(vk::Buffer buffer, vk::Image image, const std::vector<vk::BufferImageCopy> &regions, QueueType queue);
+
 		vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR> &availableFormats);
 
 		vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR> &availablePresentModes);
@@ -218,26 +452,27 @@ namespace MVT {
 
 		uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
 
-		void copyBuffer(const vk::raii::Buffer &srcBuffer, const vk::raii::Buffer &vk_buffer, vk::DeviceSize size, vk::Fence fence, vk::CommandPool pool, vk::Queue queue);
+		void copyBuffer(const vk::raii::Buffer &srcBuffer, const vk::raii::Buffer &vk_buffer, vk::DeviceSize size, vk::CommandPool pool, vk::Queue queue);
 
 		void cleanupSwapChain();
 
+		/// Hand the swapchain over to a new one without waiting: the frames in flight keep presenting to the old one.
 		void recreateSwapChain();
 
+		/// Destroy the retired swapchains whose frames completed.
+		void releaseRetiredSwapChains();
+
 		vk::raii::CommandBuffer beginSingleTimeCommands(QueueType type);
 
 		vk::raii::CommandBuffer beginSingleTimeCommands(vk::CommandPool pool);
 
-		void endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, QueueType type, bool fence = false);
+		void endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, QueueType type);
 
-		void endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, vk::Queue queue, vk::Fence fence = nullptr);
+		/// Submit on the frame timeline and wait for that value only, other queues and pending frames keep running.
+		void endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, vk::Queue queue);
 
 		[[nodiscard]] uint32_t getFamilyIndex(QueueType type) const;
 
-		[[nodiscard]] vk::SampleCountFlagBits getMaxUsableSampleCount() const;
-
-		[[nodiscard]] vk::SampleCountFlagBits getMaxUsableSampleCount(vk::PhysicalDevice device) const;
-
 	private: // Window Specific
 		/// Get all the extensions including compatibility layer and stuff like that.
 		/// @return Necessary Extensions
@@ -277,28 +512,51 @@ namespace MVT {
 		vk::raii::SwapchainKHR swapChain = nullptr;
 		std::vector<vk::Image> swapChainImages;
 		std::vector<vk::raii::ImageView> swapChainImageViews;
+
+		/// Swapchain replaced while frames using it were still in flight.
+		struct RetiredSwapChain {
+			vk::raii::SwapchainKHR swapChain = nullptr;
+			std::vector<vk::raii::ImageView> imageViews{};
+			std::vector<vk::raii::Semaphore> renderFinishedSemaphores{};
+			uint64_t value = 0; // Last timeline value submitted when it was retired.
+			uint64_t frame = 0; // Frame count when it was retired.
+		};
+		std::vector<RetiredSwapChain> retiredSwapChains{};
 		vk::raii::DescriptorSetLayout descriptorSetLayout = nullptr;
 		vk::raii::PipelineLayout pipelineLayout = nullptr;
 		vk::raii::Pipeline graphicsPipeline = nullptr;
-
-		vk::SampleCountFlagBits msaaSamples = vk::SampleCountFlagBits::e1;
+		vk::raii::Pipeline depthPrepassPipeline = nullptr;
+		bool depthPrepass{false};
+		uint32_t modelMaterialFlags{0}; // `MaterialFlags` of the loaded models' materials.
+
+		vk::SampleCountFlagBits msaaSamples = vk::SampleCountFlagBits::e1; // Follows `antiAliasing`.
+		AntiAliasingSettings antiAliasingSettings{};
+		AntiAliasingPolicy antiAliasing;
+		FxaaPass fxaaPass;
+		GpuTimer frameTimer; // Queries `2 * slot` and `2 * slot + 1`.
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> frameTimerPending{};
+		DynamicResolutionSettings dynamicResolutionSettings{};
+		DynamicResolution dynamicResolution;
+		vk::Extent2D renderExtent{}; // Area of the 3D passes this frame, `swapChainExtent` without dynamic resolution.
+		bool swapChainTransferDst = false;
+		bool textureCompressionBC = false;
+
+		MipGenerationMode mipGenerationMode = MipGenerationMode::Cpu;
+		bool persistMipChains = true;
+		bool storageImageWithoutFormat = false;
+		ComputeDownsampler mipDownsampler;
+		GpuTimer mipTimer;
 
 		// vk::raii::CommandPool transfersPool = nullptr;
 		// // std::vector<vk::raii::CommandBuffer> transferCommands{};
-		vk::raii::Fence transferFence = nullptr;
 
 		vk::raii::CommandPool commandPool = nullptr;
 
-		uint64_t depthCount = 2;
-
 		vk::Format depthFormat;
-		std::vector<vk::raii::Image> depthImages{};
-		vk::raii::DeviceMemory depthImageMemory = nullptr;
-		std::vector<vk::raii::ImageView> depthImageViews{};
-
-		std::vector<vk::raii::Image> colorImages = {};
-		std::vector<vk::raii::DeviceMemory> colorImageMemories = {};
-		std::vector<vk::raii::ImageView> colorImageViews = {};
+		// CPU temporaries of the frame being recorded. Outlives the graph, whose declarations live in it.
+		FrameScratch frameScratch;
+		// Owns the scene color and the depth of the main pass, aliased per frame slot.
+		RenderGraph renderGraph;
 
 		// vk::raii::Image textureImage = nullptr;
 		
@@ -312,6 +570,8 @@ namespace MVT {
 
 		vk::raii::Buffer vertexBuffer = nullptr;
 		vk::raii::DeviceMemory vertexBufferMemory = nullptr;
+		vk::raii::Buffer positionBuffer = nullptr;
+		vk::raii::DeviceMemory positionBufferMemory = nullptr;
 
 		vk::raii::Buffer indexBuffer = nullptr;
 		vk::raii::DeviceMemory indexBufferMemory = nullptr;
@@ -319,24 +579,105 @@ namespace MVT {
 
 		std::vector<VkMesh> m_Meshes;
 
-		std::vector<vk::raii::Buffer> uniformBuffers;
-		std::vector<vk::raii::DeviceMemory> uniformBuffersMemory;
-		std::vector<void *> uniformBuffersMapped;
+		FrameAllocator frameAllocator;
+		uint32_t frameUniformOffset = 0;
 
 		vk::raii::DescriptorPool descriptorPool = nullptr;
 		std::vector<vk::raii::DescriptorSet> descriptorSets;
 
-		bool framebufferResized = false;
-		bool windowMinimized = false;
+		BindlessTable bindlessTable;
+		std::vector<GpuMaterial> materials;
+		std::vector<uint32_t> materialStreamedTextures; // Streamed albedo of each material, if any.
+		uint64_t materialsVersion = 0;
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> uploadedMaterialsVersion{};
+		vk::raii::Buffer materialBuffer = nullptr;
+		vk::raii::DeviceMemory materialBufferMemory = nullptr;
+		GpuMaterial *materialsMapped = nullptr;
+		uint32_t defaultMaterial = 0;
+
+		bool textureStreaming = true;
+		TextureResidency textureResidency;
+		TimelineResumer gpuResumer; // Loads waiting on the render thread, resumed at frame boundaries.
+		vk::raii::Sampler streamingSampler = nullptr;
+
+		glm::vec3 cameraPosition{2.0f, 2.0f, 2.0f};
+		float cameraFovDegrees = 45.0f;
+
+		std::atomic<bool> framebufferResized = false;
+		bool windowMinimized = false; // Main thread, the render thread reads `FramePacket::minimized`.
+
+		// Render thread, and the requests the main thread leaves to it.
+		FrameMailbox<FramePacket> frameMailbox;
+		std::thread renderThread;
+		std::atomic<bool> renderThreadStop = false;
+		std::atomic<bool> shaderReloadRequested = false;
+		std::atomic<uint32_t> pendingFramesInFlight = 0; // 0 when nothing is pending.
+		std::exception_ptr renderThreadError;
+		uint64_t publishedPackets = 0;
+		double packetLatencyMilliseconds = 0.0; // Publish to consume, summed over the report interval.
+		double packetLatencyMaxMilliseconds = 0.0;
+		uint32_t packetsConsumed = 0;
+		uint64_t packetsSkipped = 0; // Replaced in the mailbox before the render thread took them.
+
+		// Startup
+		StartupTrace startupTrace;
+		JobCounter startupShaders; // Compile job of `prefetchShaders`.
+		std::unordered_map<std::string, Expected<std::vector<char>, std::string>> startupSpirv; // Taken by `compileShader`, cleared once initialized.
+		bool firstFrameReported = false; // Render thread.
+
+		// Frame pacing
+		bool renderOnDemand = false;
+		bool redrawRequested = true; // Render thread.
+		bool animate = true; // Main thread, the render thread reads `FramePacket::animating`.
+		float animationSeconds = 0.0f;
+		std::chrono::steady_clock::time_point lastAnimationTime{};
+		uint32_t frameRateCap = 0;
+		std::chrono::steady_clock::time_point nextFrameTime{};
+
+		// Allocation tracking, render thread.
+		uint32_t allocationCheckFrames = 0; // Steady state frames `setAllocationCheck` asked for, 0 when off.
+		uint64_t trackedFrames = 0;
+		std::array<AllocationCounts, static_cast<size_t>(AllocationCategory::Count)> allocationReportStart{};
 
 		// Frame in Flights parameters
-		uint32_t semaphoreIndex{0};
-		uint32_t currentFrame{0};
-		uint64_t frameCount{0};
+		FrameScheduler frameScheduler;
+		uint32_t framesInFlight{2};
+		uint32_t currentFrame{0}; // Slot of the frame being recorded.
+		uint64_t frameCount{0}; // Index of the frame being recorded.
 		std::vector<vk::raii::CommandBuffer> commandBuffers = {};
-		std::vector<vk::raii::Semaphore> presentCompleteSemaphores = {};
-		std::vector<vk::raii::Semaphore> renderFinishedSemaphores = {};
-		//std::vector<vk::raii::Fence> drawFences = {};
-		std::vector<vk::raii::Fence> inFlightFences;
+		// Objects replaced while pending frames may still use them, destroyed once their timeline value completed.
+		DeletionQueue deletionQueue;
+
+		std::unique_ptr<ParallelRecorder> parallelRecorder;
+		uint32_t recordingThreads{0};
+		uint32_t stressDrawCopies{0};
+		std::vector<DrawCommand> drawList = {}; // Sorted by `drawQueue`.
+		DrawQueue drawQueue;
+		std::vector<DrawCommand> unsortedDraws = {};
+		uint32_t opaqueDrawCount{0}; // The transparent draws are sorted after the opaque ones.
+		std::vector<vk::CommandBuffer> depthSecondaries = {};
+		glm::mat4 sceneModel{1.0f}; // `ubo.model` of the frame, for the depth of the sort keys.
+		double recordingMilliseconds{0.0}; // Accumulated between two reports.
+		uint32_t recordingSamples{0};
+		PerDrawPath perDrawPath{PerDrawPath::PushConstants};
+		bool perDrawBenchmark{false};
+		std::array<double, 2> perDrawMilliseconds{}; // Last report of each path, for the benchmark.
+		uint32_t identityObjectOffset{0}; // Identity `ObjectUniform` of the frame.
+
+		/// Draw list recorded once for a frame slot: the slot's descriptor set and uniform offsets are baked in.
+		struct StaticDraws {
+			vk::raii::CommandPool pool = nullptr;
+			vk::raii::CommandBuffer commandBuffer = nullptr;
+			vk::raii::CommandBuffer depthCommandBuffer = nullptr;
+			uint64_t key = 0;
+		};
+		std::array<StaticDraws, MAX_FRAMES_IN_FLIGHT> staticDraws{};
+		bool staticDrawsEnabled{false};
+		// Bumped when what the static draws depend on changes, handles can be reused after a destruction.
+		uint64_t sceneVersion{0};
+		uint64_t pipelineVersion{0};
+		uint64_t swapChainVersion{0};
+		std::vector<vk::raii::Semaphore> presentCompleteSemaphores = {}; // One per frame slot.
+		std::vector<vk::raii::Semaphore> renderFinishedSemaphores = {}; // One per swapchain image.
 	};
 } // MVT
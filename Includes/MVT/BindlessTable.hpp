@@ -0,0 +1,91 @@
+//
+// Created by ianpo on 06/01/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace MVT {
+	enum class BindlessResource : uint8_t {
+		Texture, // binding 0, `Texture2D textures[]`
+		Sampler, // binding 1, `SamplerState samplers[]`
+		Buffer, // binding 2, `StructuredBuffer<T> buffers[]`
+	};
+
+	struct BindlessCapacity {
+		uint32_t textures = 4096;
+		uint32_t samplers = 1024;
+		uint32_t buffers = 1024;
+	};
+
+	/// One descriptor set, bound once per command buffer, holding every texture, sampler and storage buffer of the application.
+	/// Bindings are `UPDATE_AFTER_BIND | PARTIALLY_BOUND`: slots can be written while frames are in flight, as long as those frames don't use them.
+	/// Shaders index the arrays with slots handed out by `allocate*` (see `mesh.slang`).
+	class BindlessTable {
+	public:
+		static inline constexpr uint32_t c_InvalidSlot = ~0u;
+
+	public:
+		BindlessTable() = default;
+
+		/// The capacity is clamped to the update-after-bind limits of the device.
+		BindlessTable(const vk::raii::Device &device, const vk::raii::PhysicalDevice &physicalDevice, BindlessCapacity capacity = {});
+
+		[[nodiscard]] bool isValid() const { return *m_DescriptorSet != VK_NULL_HANDLE; }
+
+		[[nodiscard]] vk::DescriptorSetLayout getLayout() const { return m_DescriptorSetLayout; }
+
+		[[nodiscard]] vk::DescriptorSet getDescriptorSet() const { return m_DescriptorSet; }
+
+		[[nodiscard]] static uint32_t GetBinding(BindlessResource type) { return static_cast<uint32_t>(type); }
+
+	public:
+		[[nodiscard]] uint32_t allocateTexture(vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+		[[nodiscard]] uint32_t allocateSampler(vk::Sampler sampler);
+
+		[[nodiscard]] uint32_t allocateBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = vk::WholeSize);
+
+		/// Overwrite an allocated texture slot, for instance when a texture gets a new view.
+		void updateTexture(uint32_t slot, vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal) const;
+
+		/// Give the slot back. The caller guarantees no pending frame still reads it.
+		void release(BindlessResource type, uint32_t slot);
+
+		[[nodiscard]] uint32_t getCapacity(BindlessResource type) const;
+
+		[[nodiscard]] uint32_t getUsedCount(BindlessResource type) const;
+
+		void clear();
+
+	private:
+		struct SlotAllocator {
+			uint32_t capacity = 0;
+			uint32_t next = 0;
+			std::vector<uint32_t> freeSlots{};
+
+			uint32_t allocate();
+
+			void release(uint32_t slot);
+
+			[[nodiscard]] uint32_t used() const { return next - static_cast<uint32_t>(freeSlots.size()); }
+		};
+
+		SlotAllocator &getAllocator(BindlessResource type);
+
+		[[nodiscard]] const SlotAllocator &getAllocator(BindlessResource type) const;
+
+	private:
+		const vk::raii::Device *m_Device = nullptr;
+		vk::raii::DescriptorPool m_DescriptorPool = nullptr;
+		vk::raii::DescriptorSetLayout m_DescriptorSetLayout = nullptr;
+		vk::raii::DescriptorSet m_DescriptorSet = nullptr;
+
+		SlotAllocator m_Textures{};
+		SlotAllocator m_Samplers{};
+		SlotAllocator m_Buffers{};
+	};
+} // MVT
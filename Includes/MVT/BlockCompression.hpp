@@ -0,0 +1,63 @@
+//
+// Created by ianpo on 03/01/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace MVT {
+	enum class BlockFormat : uint8_t {
+		BC1, // RGB, 4 bpp. Opaque colors.
+		BC3, // RGBA, 8 bpp. BC1 color + BC4 alpha.
+		BC5, // RG, 8 bpp. Two BC4 channels, used for tangent space normals.
+		BC7, // RGBA, 8 bpp. Mode 6 only (single subset, 4 bits indices).
+	};
+
+	struct BlockEncodeStats {
+		double seconds = 0.0;
+		double megaPixelsPerSecond = 0.0;
+		double psnr = 0.0;
+	};
+
+	/// CPU encoder/decoder for the BCn block formats.
+	/// The source is always tightly packed RGBA8, incomplete border blocks clamp to the edge of the image.
+	class BlockCompression {
+	public:
+		[[nodiscard]] static uint32_t GetBlockSize(BlockFormat format);
+
+		[[nodiscard]] static uint64_t GetEncodedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+		/// Encode a RGBA8 image. Block rows are split in up to `threadCount` jobs (0 = every `JobSystem` thread).
+		[[nodiscard]] static std::vector<uint8_t> Encode(BlockFormat format, const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t threadCount = 0);
+
+		static void Encode(BlockFormat format, const uint8_t *rgba, uint32_t width, uint32_t height, uint8_t *pBlocks, uint32_t threadCount = 0);
+
+		/// Decode back to RGBA8. Channels that are not stored by the format are set to 0 (color) or 255 (alpha).
+		[[nodiscard]] static std::vector<uint8_t> Decode(BlockFormat format, const uint8_t *pBlocks, uint32_t width, uint32_t height);
+
+		/// Peak signal-to-noise ratio over the channels stored by `format`, in dB.
+		[[nodiscard]] static double ComputePSNR(BlockFormat format, const uint8_t *reference, const uint8_t *decoded, uint32_t width, uint32_t height);
+
+		/// Encode, decode and measure. Meant to compare the encoder quality and throughput offline.
+		[[nodiscard]] static BlockEncodeStats Benchmark(BlockFormat format, const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t threadCount = 0);
+
+	public:
+		static void EncodeBlockBC1(const uint8_t *block, uint8_t *out);
+
+		static void EncodeBlockBC3(const uint8_t *block, uint8_t *out);
+
+		static void EncodeBlockBC5(const uint8_t *block, uint8_t *out);
+
+		static void EncodeBlockBC7(const uint8_t *block, uint8_t *out);
+
+		static void DecodeBlockBC1(const uint8_t *in, uint8_t *block);
+
+		static void DecodeBlockBC3(const uint8_t *in, uint8_t *block);
+
+		static void DecodeBlockBC5(const uint8_t *in, uint8_t *block);
+
+		static void DecodeBlockBC7(const uint8_t *in, uint8_t *block);
+	};
+} // MVT
@@ -0,0 +1,72 @@
+//
+// Created by ianpo on 05/01/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace MVT {
+	/// Every reduction reads the 2x2 footprint of the texel: the last row or column of an odd sized level is skipped.
+	/// Fine for color, but Min and Max are not conservative and can't build an occlusion depth pyramid as is.
+	enum class DownsampleReduction : uint32_t {
+		Average = 0, // Color mip chains.
+		Min = 1,
+		Max = 2,
+	};
+
+	/// Describe the image to downsample. Level 0 must be in `eTransferDstOptimal`, the other levels are undefined.
+	/// Every level ends up in `eShaderReadOnlyOptimal`.
+	struct DownsampleTarget {
+		vk::Image image{};
+		vk::Format sampledFormat = vk::Format::eUndefined; // Format of the views reading the source level.
+		vk::Format storageFormat = vk::Format::eUndefined; // Format of the views written, the UNORM alias of an sRGB image.
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t mipLevels = 1;
+		DownsampleReduction reduction = DownsampleReduction::Average;
+	};
+
+	/// Single pass compute downsampler (see `downsample.slang`): up to 12 mips written by one dispatch.
+	/// The image must have been created with the storage usage, and `eMutableFormat | eExtendedUsage` when the storage format differs.
+	class ComputeDownsampler {
+	public:
+		static inline constexpr uint32_t c_MaxMipsPerDispatch = 12;
+
+		/// Views and descriptors used by a recording. Must be kept alive until the command buffer completed.
+		struct Resources {
+			vk::raii::DescriptorPool pool = nullptr;
+			std::vector<vk::raii::DescriptorSet> sets{};
+			std::vector<vk::raii::ImageView> views{};
+		};
+
+	public:
+		ComputeDownsampler() = default;
+
+		ComputeDownsampler(const vk::raii::Device &device, const vk::raii::PhysicalDevice &physicalDevice, const std::vector<char> &spirv);
+
+		[[nodiscard]] bool isValid() const { return *m_Pipeline != VK_NULL_HANDLE; }
+
+		/// Return the format of the storage views for an image of `format`, or eUndefined if it cannot be written by the downsampler.
+		[[nodiscard]] static vk::Format GetStorageFormat(const vk::raii::PhysicalDevice &physicalDevice, vk::Format format);
+
+		[[nodiscard]] static bool IsSrgb(vk::Format format);
+
+	public:
+		[[nodiscard]] Resources record(const vk::raii::CommandBuffer &commandBuffer, const DownsampleTarget &target) const;
+
+		void clear();
+
+	private:
+		const vk::raii::Device *m_Device = nullptr;
+		vk::raii::DescriptorSetLayout m_DescriptorSetLayout = nullptr;
+		vk::raii::PipelineLayout m_PipelineLayout = nullptr;
+		vk::raii::Pipeline m_Pipeline = nullptr;
+
+		// Workgroup counter, reset to 0 by the last workgroup of each dispatch.
+		vk::raii::Buffer m_CounterBuffer = nullptr;
+		vk::raii::DeviceMemory m_CounterMemory = nullptr;
+	};
+} // MVT
@@ -0,0 +1,72 @@
+//
+// Created by ianpo on 12/01/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace MVT {
+	/// Keeps GPU objects alive until the timeline value of the last submission using them completed.
+	/// Anything movable can be retired (`vk::raii` handles, VMA buffers and images, whole subsystems), raw handles and
+	/// allocations go through a destroy function. Destruction happens in bulk in `collect`, never with a device idle.
+	class DeletionQueue {
+	public:
+		DeletionQueue() = default;
+
+		~DeletionQueue() = default;
+
+		DeletionQueue(const DeletionQueue &) = delete;
+
+		DeletionQueue &operator=(const DeletionQueue &) = delete;
+
+		DeletionQueue(DeletionQueue &&) noexcept = default;
+
+		DeletionQueue &operator=(DeletionQueue &&) noexcept = default;
+
+	public:
+		/// Move `object` in the queue, it is destroyed once `value` completed. Callables go to the destroy function
+		/// overload instead: a lambda would be an exact match here, kept and never called.
+		template<typename T> requires (!std::is_invocable_v<T &>)
+		void retire(T &&object, const uint64_t value) {
+			static_assert(!std::is_lvalue_reference_v<T>, "Retired objects must be moved in the queue.");
+			m_Entries.push_back(Entry{.value = value, .object = std::make_unique<Holder<std::remove_cvref_t<T>>>(std::move(object))});
+		}
+
+		/// Call `destroy` once `value` completed.
+		void retire(std::function<void()> destroy, uint64_t value);
+
+		/// Destroy everything retired with a value up to `completedValue`.
+		void collect(uint64_t completedValue);
+
+		/// Destroy everything, the GPU must be idle.
+		void flush();
+
+		[[nodiscard]] size_t size() const { return m_Entries.size(); }
+
+	private:
+		struct Retired {
+			virtual ~Retired() = default;
+		};
+
+		template<typename T>
+		struct Holder final : Retired {
+			explicit Holder(T &&object) : object(std::move(object)) {}
+
+			T object;
+		};
+
+		struct Entry {
+			uint64_t value = 0;
+			std::unique_ptr<Retired> object{};
+			std::function<void()> destroy{};
+		};
+
+	private:
+		std::vector<Entry> m_Entries{};
+	};
+} // MVT
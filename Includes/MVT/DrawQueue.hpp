@@ -0,0 +1,57 @@
+//
+// Created by ianpo on 13/01/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace MVT {
+	enum class DrawPass : uint8_t {
+		Opaque = 0,
+		Transparent = 1,
+	};
+
+	/// Draw packet: the sort key and the index of the draw it stands for.
+	struct DrawPacket {
+		uint64_t key = 0;
+		uint32_t draw = 0;
+	};
+
+	/// Queue of draws ordered by a 64 bits key, sorted with an LSD radix sort.
+	/// Opaque keys go pass | pipeline | material | mesh | depth: state changes are minimized, then front-to-back.
+	/// Transparent keys go pass | inverted depth | pipeline | material | mesh: back-to-front first, for blending.
+	class DrawQueue {
+	public:
+		static inline constexpr uint32_t c_PipelineBits = 8;
+		static inline constexpr uint32_t c_MaterialBits = 16;
+		static inline constexpr uint32_t c_MeshBits = 12;
+		static inline constexpr uint32_t c_DepthBits = 24;
+
+		/// `depth` is normalized in [0, 1], 0 being the nearest.
+		[[nodiscard]] static uint64_t MakeKey(DrawPass pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+		/// Sort `count` random keys with the radix sort and `std::sort` and print both times, then check the order of a known layout.
+		static void Benchmark(uint32_t count);
+
+	public:
+		void clear() { m_Packets.clear(); }
+
+		void reserve(const size_t count) { m_Packets.reserve(count); }
+
+		void push(const uint64_t key, const uint32_t draw) { m_Packets.push_back(DrawPacket{.key = key, .draw = draw}); }
+
+		/// Stable, so equal keys keep their push order.
+		void sort();
+
+		[[nodiscard]] std::span<const DrawPacket> getPackets() const { return m_Packets; }
+
+		[[nodiscard]] size_t size() const { return m_Packets.size(); }
+
+	private:
+		std::vector<DrawPacket> m_Packets{};
+		std::vector<DrawPacket> m_Scratch{}; // Kept between frames, the sort never allocates once warm.
+	};
+} // MVT
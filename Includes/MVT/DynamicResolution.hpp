@@ -0,0 +1,52 @@
+//
+// Created by ianpo on 15/01/2026.
+//
+
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+namespace MVT {
+	struct DynamicResolutionSettings {
+		bool enabled = false;
+		double targetMilliseconds = 1000.0 / 60.0;
+		double minScale = 0.5; // Per axis.
+		double maxScale = 1.0;
+		// Gains on the relative frame time error, `(target - measured) / target`.
+		double proportional = 0.35;
+		double integral = 0.05;
+		double derivative = 0.1;
+	};
+
+	/// PID controller of the render scale. The 3D passes render in the top left `getRenderExtent` corner of targets
+	/// allocated at the output size, so a new scale only changes the viewport, never the attachments.
+	class DynamicResolution {
+	public:
+		/// Relative errors below this are ignored, the frame time noise alone doesn't move the scale.
+		static inline constexpr double c_DeadBand = 0.05;
+		/// The applied scale only follows the controller by steps of at least this much.
+		static inline constexpr double c_MinStep = 0.025;
+
+	public:
+		DynamicResolution() = default;
+
+		explicit DynamicResolution(const DynamicResolutionSettings &settings);
+
+		[[nodiscard]] bool isEnabled() const { return m_Settings.enabled; }
+
+		[[nodiscard]] double getScale() const { return m_Scale; }
+
+		/// Scaled `extent`, at least 1x1.
+		[[nodiscard]] vk::Extent2D getRenderExtent(vk::Extent2D extent) const;
+
+		/// Feed the GPU time of a frame. Return true when the applied scale changed.
+		bool update(double gpuMilliseconds);
+
+	private:
+		DynamicResolutionSettings m_Settings{};
+		double m_Output = 1.0; // Controller output, continuous.
+		double m_Scale = 1.0; // Applied scale.
+		double m_Integral = 0.0;
+		double m_PreviousError = 0.0;
+	};
+} // MVT
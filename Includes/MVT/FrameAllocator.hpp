@@ -0,0 +1,87 @@
+//
+// Created by ianpo on 10/01/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+#include <vk_mem_alloc.h>
+
+#include "MVT/FrameScheduler.hpp"
+#include "MVT/VmaBuffer.hpp"
+
+namespace MVT {
+	struct FrameAllocation {
+		vk::Buffer buffer{};
+		vk::DeviceSize offset = 0; // From the start of `buffer`, usable as a dynamic offset.
+		void *data = nullptr;
+
+		[[nodiscard]] uint32_t getDynamicOffset() const { return static_cast<uint32_t>(offset); }
+	};
+
+	/// Persistently mapped linear allocator for the data written once per frame (uniforms, per-draw blocks...).
+	/// The buffer is split in one region per frame slot. Allocating is an atomic bump in the region of the current frame,
+	/// the whole region is reused once the timeline says the frame that last used the slot completed.
+	/// Blocks are aligned for both uniform and storage dynamic offsets, descriptors bind the buffer from offset 0.
+	class FrameAllocator {
+	public:
+		/// Largest block a dynamic descriptor may cover: the guaranteed `maxUniformBufferRange`.
+		static inline constexpr vk::DeviceSize c_MaxBindingRange = 16384;
+
+	public:
+		FrameAllocator() = default;
+
+		FrameAllocator(VmaAllocator allocator, const vk::raii::PhysicalDevice &physicalDevice, vk::DeviceSize regionSize);
+
+		FrameAllocator(FrameAllocator &&o) noexcept;
+
+		FrameAllocator &operator=(FrameAllocator &&o) noexcept;
+
+		FrameAllocator(const FrameAllocator &) = delete;
+
+		FrameAllocator &operator=(const FrameAllocator &) = delete;
+
+		[[nodiscard]] bool isValid() const { return m_Buffer.IsValid(); }
+
+	public:
+		/// Start writing in the region of `slot`, the previous frame of the slot must have completed.
+		void beginFrame(uint32_t slot);
+
+		/// Thread safe. Throws when the region of the frame is full.
+		[[nodiscard]] FrameAllocation allocate(vk::DeviceSize size);
+
+		template<typename T>
+		[[nodiscard]] FrameAllocation push(const T &value) {
+			FrameAllocation allocation = allocate(sizeof(T));
+			memcpy(allocation.data, &value, sizeof(T));
+			return allocation;
+		}
+
+		/// Descriptor covering `range` bytes from the dynamic offset, for `eUniformBufferDynamic`/`eStorageBufferDynamic` bindings.
+		[[nodiscard]] vk::DescriptorBufferInfo getDescriptorInfo(vk::DeviceSize range) const;
+
+		[[nodiscard]] vk::DeviceSize getAlignment() const { return m_Alignment; }
+
+		[[nodiscard]] vk::DeviceSize getRegionSize() const { return m_RegionSize; }
+
+		/// Bytes allocated in the current region so far.
+		[[nodiscard]] vk::DeviceSize getUsedBytes() const;
+
+		void clear();
+
+	private:
+		void swap(FrameAllocator &o) noexcept;
+
+	private:
+		VmaBuffer m_Buffer{};
+		std::byte *m_Mapped = nullptr;
+		vk::DeviceSize m_Alignment = 256;
+		vk::DeviceSize m_RegionSize = 0;
+		vk::DeviceSize m_RegionBegin = 0;
+		std::atomic<vk::DeviceSize> m_Head = 0; // Relative to `m_RegionBegin`.
+	};
+} // MVT
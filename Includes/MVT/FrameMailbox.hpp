@@ -0,0 +1,72 @@
+//
+// Created by ianpo on 16/01/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace MVT {
+	/// Lock-free triple buffer between one producer and one consumer thread. The producer always has a slot to fill, the
+	/// consumer always reads the latest complete value, neither waits on the other: a value published before the previous
+	/// one was consumed replaces it.
+	/// The slots rotate through a single atomic byte holding the index of the middle slot and whether it is fresh.
+	template<typename T>
+	class FrameMailbox {
+	public:
+		FrameMailbox() = default;
+
+		FrameMailbox(const FrameMailbox &) = delete;
+
+		FrameMailbox &operator=(const FrameMailbox &) = delete;
+
+	public: // Producer.
+		/// Slot filled before `publish`, its previous content is stale.
+		[[nodiscard]] T &getBack() { return m_Slots[m_Back]; }
+
+		/// Hand the back slot over to the consumer and take the middle one back.
+		void publish() {
+			const uint8_t previous = m_Middle.exchange(static_cast<uint8_t>(m_Back | c_Fresh), std::memory_order_acq_rel);
+			m_Back = static_cast<uint8_t>(previous & c_IndexMask);
+			m_Sequence.fetch_add(1, std::memory_order_release);
+			m_Sequence.notify_one();
+		}
+
+		/// Wake a consumer blocked in `wait` without publishing anything.
+		void wake() {
+			m_Sequence.fetch_add(1, std::memory_order_release);
+			m_Sequence.notify_one();
+		}
+
+	public: // Consumer.
+		/// Swap the latest published value in the front slot. False if nothing was published since the last call.
+		bool consume() {
+			if (!(m_Middle.load(std::memory_order_relaxed) & c_Fresh)) return false;
+
+			const uint8_t previous = m_Middle.exchange(m_Front, std::memory_order_acq_rel);
+			m_Front = static_cast<uint8_t>(previous & c_IndexMask);
+			return true;
+		}
+
+		/// Latest consumed value, untouched by the producer until the next `consume`.
+		[[nodiscard]] const T &getFront() const { return m_Slots[m_Front]; }
+
+		/// Read before `consume`, then passed to `wait`: a publish in between is never missed.
+		[[nodiscard]] uint64_t getSequence() const { return m_Sequence.load(std::memory_order_acquire); }
+
+		/// Block until something is published or `wake` is called after `sequence` was read.
+		void wait(const uint64_t sequence) const { m_Sequence.wait(sequence, std::memory_order_acquire); }
+
+	private:
+		static inline constexpr uint8_t c_IndexMask = 0x3;
+		static inline constexpr uint8_t c_Fresh = 0x4;
+
+		std::array<T, 3> m_Slots{};
+		alignas(64) std::atomic<uint8_t> m_Middle{1};
+		alignas(64) std::atomic<uint64_t> m_Sequence{0};
+		alignas(64) uint8_t m_Back = 0; // Producer only.
+		alignas(64) uint8_t m_Front = 2; // Consumer only.
+	};
+} // MVT
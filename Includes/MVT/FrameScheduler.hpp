@@ -0,0 +1,85 @@
+//
+// Created by ianpo on 08/01/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace MVT {
+	/// Paces the frames and uploads on a single timeline semaphore.
+	/// Every submission signals the next value of the timeline, in submission order, so "is this done" is a comparison
+	/// against the counter. A frame slot is reused once the value of its previous submission is reached, and at most
+	/// `getFramesInFlight` frames are pending at once.
+	class FrameScheduler {
+	public:
+		/// Capacity of the per-frame resources, the depth used at runtime is between 1 and this.
+		static inline constexpr uint32_t c_MaxFramesInFlight = 4;
+
+	public:
+		FrameScheduler() = default;
+
+		FrameScheduler(const vk::raii::Device &device, uint32_t framesInFlight);
+
+		[[nodiscard]] bool isValid() const { return *m_Timeline != VK_NULL_HANDLE; }
+
+		[[nodiscard]] vk::Semaphore getSemaphore() const { return m_Timeline; }
+
+		/// Clamped between 1 and `c_MaxFramesInFlight`, applied at the next `beginFrame`.
+		void setFramesInFlight(uint32_t framesInFlight);
+
+		[[nodiscard]] uint32_t getFramesInFlight() const { return m_FramesInFlight; }
+
+	public:
+		/// Wait until the next frame may be recorded and return its slot.
+		uint32_t beginFrame();
+
+		/// Submit the frame's work, signaling its timeline value along with `signals`.
+		uint64_t submitFrame(vk::Queue queue, std::span<const vk::CommandBufferSubmitInfo> commandBuffers, std::span<const vk::SemaphoreSubmitInfo> waits, std::span<const vk::SemaphoreSubmitInfo> signals);
+
+		/// Submit work outside of a frame (uploads, mip generation...) and return the value it signals.
+		uint64_t submit(vk::Queue queue, std::span<const vk::CommandBufferSubmitInfo> commandBuffers, std::span<const vk::SemaphoreSubmitInfo> waits = {}, std::span<const vk::SemaphoreSubmitInfo> signals = {});
+
+		[[nodiscard]] uint32_t getFrameSlot() const { return m_Slot; }
+
+		/// Number of frames begun, the current one included.
+		[[nodiscard]] uint64_t getFrameCount() const { return m_FrameCount; }
+
+		/// Number of frames whose work fully completed on the GPU. Every frame before this index can be retired.
+		[[nodiscard]] uint64_t getCompletedFrameCount();
+
+		[[nodiscard]] uint64_t getLastSubmittedValue() const { return m_LastValue; }
+
+		/// Refresh and return the counter of the timeline.
+		uint64_t getCompletedValue();
+
+		[[nodiscard]] bool isComplete(uint64_t value);
+
+		/// Block the host until the timeline reaches `value`.
+		void wait(uint64_t value);
+
+		/// Block the host until every submission so far completed.
+		void waitIdle() { wait(m_LastValue); }
+
+		void clear();
+
+	private:
+		uint64_t submitAndSignal(vk::Queue queue, std::span<const vk::CommandBufferSubmitInfo> commandBuffers, std::span<const vk::SemaphoreSubmitInfo> waits, std::span<const vk::SemaphoreSubmitInfo> signals);
+
+	private:
+		const vk::raii::Device *m_Device = nullptr;
+		vk::raii::Semaphore m_Timeline = nullptr;
+		uint32_t m_FramesInFlight = 2;
+		uint32_t m_RequestedFramesInFlight = 2;
+
+		uint32_t m_Slot = 0;
+		uint64_t m_FrameCount = 0;
+		uint64_t m_LastValue = 0;
+		uint64_t m_CompletedValue = 0;
+		std::array<uint64_t, c_MaxFramesInFlight> m_SlotValues{}; // Last value signaled by the frame of each slot.
+		std::array<uint64_t, c_MaxFramesInFlight> m_FrameValues{}; // Value of the last frames, indexed by frame % c_MaxFramesInFlight.
+	};
+} // MVT
@@ -0,0 +1,82 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace MVT {
+	/// Linear allocator for the CPU temporaries of a frame, the host side counterpart of `FrameAllocator`. Containers of
+	/// the frame path allocate from it through `std::pmr`, `reset` takes everything back at once at the start of the next
+	/// frame without running any destructor. Allocating is thread safe, an atomic bump.
+	/// A frame that doesn't fit spills to the heap, and the next `reset` grows the arena to what that frame needed: the
+	/// steady state never reaches the heap.
+	class FrameScratch final : public std::pmr::memory_resource {
+	public:
+		static inline constexpr size_t c_DefaultCapacity = 256ull << 10;
+		/// Of the arena, larger alignments always spill.
+		static inline constexpr size_t c_Alignment = 64;
+
+	public:
+		explicit FrameScratch(size_t capacity = c_DefaultCapacity);
+
+		~FrameScratch() override;
+
+		FrameScratch(const FrameScratch &) = delete;
+
+		FrameScratch &operator=(const FrameScratch &) = delete;
+
+	public:
+		/// Release everything allocated since the last reset. No other thread may be allocating.
+		void reset();
+
+		/// Construct a `T` that lives until the next `reset`, which never destroys it.
+		template<typename T, typename... Args>
+		[[nodiscard]] T *create(Args &&... args) {
+			static_assert(std::is_trivially_destructible_v<T>, "The scratch never runs destructors.");
+			return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		[[nodiscard]] size_t getCapacity() const { return m_Capacity; }
+
+		/// Bytes of the arena allocated since the last reset.
+		[[nodiscard]] size_t getUsedBytes() const;
+
+		/// Bytes that went to the heap since the last reset.
+		[[nodiscard]] size_t getSpilledBytes() const;
+
+	private:
+		void *do_allocate(size_t bytes, size_t alignment) override;
+
+		// Released by `reset`.
+		void do_deallocate(void *, size_t, size_t) override {}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+		void *spill(size_t bytes, size_t alignment);
+
+		void releaseSpills();
+
+	private:
+		/// Header of a heap block, in front of the bytes handed out.
+		struct Spill {
+			Spill *next = nullptr;
+			size_t alignment = 0;
+		};
+
+		std::byte *m_Buffer = nullptr;
+		size_t m_Capacity = 0;
+		std::atomic<size_t> m_Head{0};
+
+		mutable std::mutex m_SpillMutex;
+		Spill *m_Spills = nullptr;
+		size_t m_SpilledBytes = 0;
+	};
+} // MVT
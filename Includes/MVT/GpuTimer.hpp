@@ -0,0 +1,39 @@
+//
+// Created by ianpo on 05/01/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace MVT {
+	/// Timestamp query pool with helpers to turn pairs of queries into milliseconds.
+	class GpuTimer {
+	public:
+		GpuTimer() = default;
+
+		GpuTimer(const vk::raii::Device &device, const vk::raii::PhysicalDevice &physicalDevice, uint32_t queueFamily, uint32_t queryCount);
+
+		[[nodiscard]] bool isValid() const { return *m_QueryPool != VK_NULL_HANDLE; }
+
+		[[nodiscard]] uint32_t getQueryCount() const { return m_QueryCount; }
+
+	public:
+		void reset(const vk::raii::CommandBuffer &commandBuffer, uint32_t firstQuery, uint32_t queryCount) const;
+
+		void write(const vk::raii::CommandBuffer &commandBuffer, vk::PipelineStageFlags2 stage, uint32_t query) const;
+
+		/// Milliseconds between two queries, or nothing if the results are not available yet.
+		[[nodiscard]] std::optional<double> getElapsedMilliseconds(uint32_t beginQuery, uint32_t endQuery) const;
+
+		void clear();
+
+	private:
+		vk::raii::QueryPool m_QueryPool = nullptr;
+		uint32_t m_QueryCount = 0;
+		double m_TimestampPeriod = 1.0; // Nanoseconds per tick.
+		uint64_t m_ValidBitsMask = ~0ull;
+	};
+} // MVT
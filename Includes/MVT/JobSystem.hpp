@@ -0,0 +1,191 @@
+//
+// Created by ianpo on 17/01/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "MVT/AllocationTracker.hpp"
+
+namespace MVT {
+	template<typename Signature>
+	class FunctionRef;
+
+	/// Non-owning callable, for functions only called before the call they are given to returns. Never allocates.
+	template<typename Result, typename... Args>
+	class FunctionRef<Result(Args...)> {
+	public:
+		template<typename Function> requires (!std::is_same_v<std::remove_cvref_t<Function>, FunctionRef> && std::is_invocable_r_v<Result, Function &, Args...>)
+		FunctionRef(Function &&function) noexcept : m_Object(const_cast<void *>(static_cast<const void *>(std::addressof(function)))), m_Call(&Call<std::remove_reference_t<Function>>) {}
+
+		Result operator()(Args... args) const { return m_Call(m_Object, std::forward<Args>(args)...); }
+
+	private:
+		template<typename Function>
+		static Result Call(void *object, Args... args) { return std::invoke(*static_cast<Function *>(object), std::forward<Args>(args)...); }
+
+	private:
+		void *m_Object;
+		Result (*m_Call)(void *object, Args... args);
+	};
+
+	/// Unfinished jobs of a group. Incremented by `JobSystem::Run`, decremented when a job returns, done at 0.
+	/// A job depending on a group waits on its counter, see `JobSystem::Wait`.
+	class JobCounter {
+	public:
+		JobCounter() = default;
+
+		JobCounter(const JobCounter &) = delete;
+
+		JobCounter &operator=(const JobCounter &) = delete;
+
+		[[nodiscard]] bool isDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> m_Pending{0};
+		std::atomic<bool> m_Failed{false};
+		std::exception_ptr m_Error; // Written once, by the job that set `m_Failed`.
+	};
+
+	struct JobSystemSettings {
+		uint32_t threadCount = 0; // Workers, 0 uses every hardware thread but the calling one.
+		bool pinThreads = false; // Worker `i` on core `i + 1`, the calling thread keeps core 0.
+	};
+
+	/// Engine-wide scheduler. Every worker owns a Chase-Lev deque: it pushes and pops its own jobs at the bottom, the
+	/// idle workers steal at the top. Threads outside the pool submit through a shared queue.
+	/// `Wait` runs other jobs until the counter is done instead of blocking, so jobs can wait on jobs without deadlocking
+	/// as long as the waited jobs don't wait on the waiting one.
+	class JobSystem {
+	public:
+		using JobFunction = std::function<void()>;
+		/// Processes the items `[begin, end)`. Referenced, not copied: `ParallelFor` returns once every chunk is done.
+		using RangeFunction = FunctionRef<void(uint32_t begin, uint32_t end)>;
+
+		/// Jobs a deque, or the shared queue, holds before `Run` executes the new ones in place.
+		static inline constexpr uint32_t c_DequeCapacity = 4096;
+
+	public:
+		static void Initialize(const JobSystemSettings &settings = {});
+
+		/// Run what is still queued and join the workers.
+		static void Shutdown();
+
+		[[nodiscard]] static bool IsInitialized() { return !s_Workers.empty(); }
+
+		/// Workers, without the threads outside the pool.
+		[[nodiscard]] static uint32_t GetWorkerCount() { return static_cast<uint32_t>(s_Workers.size()); }
+
+		/// Queue `function` in `counter`. Without `JobSystem`, `function` runs in place.
+		/// The job counts its allocations in the `AllocationCategory` of the calling thread.
+		static void Run(JobFunction function, JobCounter &counter);
+
+		/// Queue `function` in `counter`, to run once `dependency` is done.
+		static void Run(JobFunction function, JobCounter &counter, const JobCounter &dependency);
+
+		/// Queue `function` without a counter to wait on, `Shutdown` runs it before joining. It must not throw.
+		static void Spawn(JobFunction function);
+
+		/// Run jobs until `counter` is done. The first exception thrown by a job of the counter is rethrown here.
+		static void Wait(JobCounter &counter);
+
+		/// `Wait` without the rethrow.
+		static void Help(const JobCounter &counter);
+
+		/// Split `count` items in chunks of at least `minItemsPerJob` and process them in parallel, the calling thread
+		/// included. Return the number of chunks, chunk `i` covering `[i * ceil(count / chunks), ...)`.
+		static uint32_t ParallelFor(uint32_t count, uint32_t minItemsPerJob, RangeFunction function, uint32_t maxJobs = 0);
+
+		/// Dispatch overhead: empty jobs through `Run`, then `ParallelFor`, against a serial loop.
+		static void Benchmark(uint32_t jobCount);
+
+	private:
+		struct JobPool;
+
+		struct Job {
+			JobFunction function;
+			JobCounter *counter = nullptr;
+			AllocationCategory category = AllocationCategory::Other;
+			JobPool *pool = nullptr; // Takes the job back once executed.
+			Job *next = nullptr; // In the free lists of `pool`.
+		};
+
+		/// Recycles the jobs queued by one thread: only that thread takes jobs out, any thread gives them back.
+		struct JobPool {
+			Job *free = nullptr; // Owner only.
+			std::atomic<Job *> returned{nullptr}; // Pushed by the executing threads, taken whole by the owner.
+
+			JobPool() = default;
+
+			~JobPool();
+
+			JobPool(const JobPool &) = delete;
+
+			JobPool &operator=(const JobPool &) = delete;
+
+			Job *acquire();
+
+			void release(Job *job);
+		};
+
+		/// Chase-Lev deque over a fixed ring. `push`/`pop` by the owner only, `steal` from any thread.
+		class WorkDeque {
+		public:
+			bool push(Job *job);
+
+			Job *pop();
+
+			Job *steal();
+
+		private:
+			alignas(64) std::atomic<int64_t> m_Top{0};
+			alignas(64) std::atomic<int64_t> m_Bottom{0};
+			std::array<std::atomic<Job *>, c_DequeCapacity> m_Jobs{};
+		};
+
+		static void WorkerLoop(uint32_t worker);
+
+		/// Own deque first, then the shared queue, then the other workers.
+		static Job *FindJob();
+
+		static void Execute(Job *job);
+
+		static void Submit(Job *job);
+
+		static void Pin(std::thread &thread, uint32_t core);
+
+		/// Pool of the calling thread, created on its first job.
+		static JobPool &GetPool();
+
+	private:
+		static inline std::vector<std::thread> s_Workers{};
+		static inline std::vector<std::unique_ptr<WorkDeque>> s_Deques{};
+		static inline std::mutex s_SharedMutex;
+		// Ring of the jobs submitted from outside the pool.
+		static inline std::array<Job *, c_DequeCapacity> s_SharedJobs{};
+		static inline uint32_t s_SharedHead = 0;
+		static inline uint32_t s_SharedCount = 0;
+		// Never freed before the exit: a job may come back after the thread that queued it is gone.
+		static inline std::mutex s_PoolsMutex;
+		static inline std::vector<std::unique_ptr<JobPool>> s_Pools{};
+		static inline JobCounter s_Detached{}; // Jobs of `Spawn`.
+		static inline std::atomic<bool> s_Stop{false};
+		/// Bumped on every submit and every finished counter, the idle threads sleep on it.
+		static inline std::atomic<uint32_t> s_Epoch{0};
+		static inline thread_local uint32_t s_Worker = UINT32_MAX; // Deque of the current thread, none outside the pool.
+		static inline thread_local uint32_t s_Victim = 0;
+		static inline thread_local JobPool *s_Pool = nullptr;
+	};
+} // MVT
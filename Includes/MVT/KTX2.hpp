@@ -0,0 +1,46 @@
+//
+// Created by ianpo on 03/01/2026.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "MVT/Expected.hpp"
+
+namespace MVT {
+	struct FormatBlockInfo {
+		uint32_t blockWidth = 1;
+		uint32_t blockHeight = 1;
+		uint32_t blockSize = 0; // In bytes. 0 when the format is not handled.
+	};
+
+	[[nodiscard]] FormatBlockInfo GetFormatBlockInfo(vk::Format format);
+
+	[[nodiscard]] uint64_t GetImageLevelSize(vk::Format format, uint32_t width, uint32_t height);
+
+	/// Minimal KTX2 container (2D, single layer, single face, no supercompression).
+	/// `levels[0]` is the base level, as in the KTX2 level index.
+	struct Ktx2Texture {
+	public:
+		[[nodiscard]] static Expected<Ktx2Texture, std::string> Load(const std::filesystem::path &path);
+
+		[[nodiscard]] Expected<uint64_t, std::string> Save(const std::filesystem::path &path) const;
+
+	public:
+		[[nodiscard]] uint64_t GetTotalSize() const;
+
+		[[nodiscard]] uint32_t GetLevelWidth(uint32_t level) const { return std::max(1u, width >> level); }
+
+		[[nodiscard]] uint32_t GetLevelHeight(uint32_t level) const { return std::max(1u, height >> level); }
+
+	public:
+		vk::Format format = vk::Format::eUndefined;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<std::vector<uint8_t>> levels{};
+	};
+} // MVT
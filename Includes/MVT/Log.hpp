@@ -0,0 +1,112 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+// Calls below this level compile to nothing, see the `MVT_LOG_*` macros. Set by the build, per configuration.
+#ifndef SPDLOG_ACTIVE_LEVEL
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+#endif
+
+#include <spdlog/spdlog.h>
+
+namespace MVT {
+	/// Subsystem of a message, one logger each: levels are set per category, the sinks are shared.
+	enum class LogCategory : uint8_t {
+		Core,
+		Vulkan,
+		Validation, // Messages of the validation layers.
+		Render,
+		Shaders,
+		Assets,
+		Jobs,
+		Count,
+	};
+
+	struct LogSettings {
+		spdlog::level::level_enum level = spdlog::level::info; // Runtime level of every category, above the compiled one.
+		uint32_t queueSize = 8192; // Messages waiting for the flush thread, the oldest are dropped past it.
+		std::chrono::seconds flushInterval{1}; // Below the errors, which flush right away.
+	};
+
+	/// Asynchronous logging: a call formats its message and pushes it in a ring buffer, a background thread writes and
+	/// flushes the sinks. When the ring is full the oldest message is overwritten, the logging thread never waits.
+	/// Before `Initialize` and after `Shutdown`, every category logs synchronously on the standard output.
+	class Log {
+	public:
+		/// Before the other threads start.
+		static void Initialize(const LogSettings &settings = {});
+
+		/// Write what is queued and join the flush thread, once the other threads stopped.
+		static void Shutdown();
+
+		[[nodiscard]] static bool IsInitialized() { return s_Loggers[0] != nullptr; }
+
+		[[nodiscard]] static spdlog::logger *Get(const LogCategory category) {
+			spdlog::logger *logger = s_Loggers[static_cast<size_t>(category)].get();
+			return logger ? logger : GetFallback();
+		}
+
+		static void SetLevel(spdlog::level::level_enum level);
+
+		static void SetLevel(LogCategory category, spdlog::level::level_enum level);
+
+		/// `trace`, `debug`, `info`, `warn`, `error`, `critical` or `off`. Anything else is `info`.
+		[[nodiscard]] static spdlog::level::level_enum ParseLevel(std::string_view name);
+
+		/// Messages dropped because the ring was full.
+		[[nodiscard]] static size_t GetOverrunCount();
+
+	private:
+		static spdlog::logger *GetFallback();
+
+	private:
+		static inline std::array<std::shared_ptr<spdlog::logger>, static_cast<size_t>(LogCategory::Count)> s_Loggers{};
+	};
+
+	/// Lets at most `burst` messages through per second, counting the others. Lock-free, one per call site: see
+	/// `MVT_LOG_LIMITED`.
+	class LogRateLimiter {
+	public:
+		static inline constexpr std::chrono::nanoseconds c_Window = std::chrono::seconds{1};
+		static inline constexpr uint32_t c_DefaultBurst = 5;
+
+	public:
+		explicit LogRateLimiter(const uint32_t burst = c_DefaultBurst) : m_Burst(burst) {}
+
+		/// True when the message may be logged, `suppressed` then holds how many were dropped before it.
+		bool allow(uint32_t &suppressed);
+
+	private:
+		uint32_t m_Burst;
+		std::atomic<int64_t> m_WindowStart{0}; // Steady clock, in nanoseconds.
+		std::atomic<uint32_t> m_Count{0}; // Messages of the current window, dropped ones included.
+		std::atomic<uint32_t> m_Suppressed{0};
+	};
+} // MVT
+
+#define MVT_LOG_TRACE(category, ...) SPDLOG_LOGGER_TRACE(::MVT::Log::Get(::MVT::LogCategory::category), __VA_ARGS__)
+#define MVT_LOG_DEBUG(category, ...) SPDLOG_LOGGER_DEBUG(::MVT::Log::Get(::MVT::LogCategory::category), __VA_ARGS__)
+#define MVT_LOG_INFO(category, ...) SPDLOG_LOGGER_INFO(::MVT::Log::Get(::MVT::LogCategory::category), __VA_ARGS__)
+#define MVT_LOG_WARN(category, ...) SPDLOG_LOGGER_WARN(::MVT::Log::Get(::MVT::LogCategory::category), __VA_ARGS__)
+#define MVT_LOG_ERROR(category, ...) SPDLOG_LOGGER_ERROR(::MVT::Log::Get(::MVT::LogCategory::category), __VA_ARGS__)
+#define MVT_LOG_CRITICAL(category, ...) SPDLOG_LOGGER_CRITICAL(::MVT::Log::Get(::MVT::LogCategory::category), __VA_ARGS__)
+
+/// `MVT_LOG_<level>` for messages that may repeat every frame: a few per second, then a count of the ones dropped.
+#define MVT_LOG_LIMITED(level, category, ...) \
+	do { \
+		static ::MVT::LogRateLimiter s_LogRateLimiter; \
+		uint32_t mvtSuppressed = 0; \
+		if (s_LogRateLimiter.allow(mvtSuppressed)) { \
+			if (mvtSuppressed > 0) MVT_LOG_##level(category, "{} similar message(s) suppressed.", mvtSuppressed); \
+			MVT_LOG_##level(category, __VA_ARGS__); \
+		} \
+	} while (false)
@@ -0,0 +1,37 @@
+//
+// Created by ianpo on 06/01/2026.
+//
+
+#pragma once
+
+#include "GLM.hpp"
+
+namespace MVT {
+	/// Material as read by the shaders (`Material` in `mesh.slang`), indices are bindless slots.
+	struct GpuMaterial {
+		glm::vec4 baseColor{1.0f};
+		uint32_t albedoTexture = 0;
+		uint32_t albedoSampler = 0;
+		uint32_t flags = 0; // `MaterialFlags`.
+		uint32_t padding = 0;
+	};
+
+	enum MaterialFlags : uint32_t {
+		c_MaterialSingleSided = 1u << 0, // Back faces are culled. Materials are double sided by default, the meshes don't say.
+	};
+
+	static_assert(sizeof(GpuMaterial) == 32, "GpuMaterial must match the std430 layout of the shader.");
+
+	/// Per draw data, pushed before each draw call (`DrawConstants` in `mesh.slang`).
+	/// 80 bytes, within the 128 bytes every device guarantees.
+	struct DrawPushConstants {
+		glm::mat4 model{1.0f};
+		uint32_t materialIndex = 0;
+		uint32_t padding[3]{};
+	};
+
+	static_assert(sizeof(DrawPushConstants) <= 128, "DrawPushConstants must fit the guaranteed push constant size.");
+
+	/// Capacity of the material table, one copy per frame in flight.
+	static inline constexpr uint32_t c_MaxMaterials = 1024;
+}
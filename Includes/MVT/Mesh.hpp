@@ -57,6 +57,8 @@ namespace MVT {
 			height = 0;
 			channels = 0;
 			mipLevels = 0;
+			textureSlot = ~0u;
+			samplerSlot = ~0u;
 		}
 
 		void CalcMipLevels() {
@@ -71,6 +73,28 @@ namespace MVT {
 		vk::Format format = vk::Format::eUndefined;
 		uint32_t width = 0, height = 0, channels = 0;
 		uint32_t mipLevels = 0;
+		// Bindless slots, see `BindlessTable`.
+		uint32_t textureSlot = ~0u;
+		uint32_t samplerSlot = ~0u;
+	};
+
+	/// One indexed draw of the frame, plain handles so any recording thread can read it.
+	struct DrawCommand {
+		vk::Buffer vertexBuffer{};
+		vk::Buffer positionBuffer{}; // Positions only, for the depth pre-pass.
+		vk::Buffer indexBuffer{};
+		uint32_t indexCount = 0;
+		uint32_t materialIndex = 0;
+		uint32_t objectOffset = 0; // Dynamic offset of the draw's `ObjectUniform`.
+		glm::mat4 model{1.0f}; // Pushed with `PerDrawPath::PushConstants`.
+		bool transparent = false;
+		bool singleSided = false;
+	};
+
+	/// Vertices and indices of a mesh still on the CPU, before `Application::createMesh`.
+	struct MeshData {
+		std::vector<Vertex> vertices = {};
+		std::vector<uint32_t> indices = {};
 	};
 
 	struct VkMesh {
@@ -95,9 +119,13 @@ namespace MVT {
 			m_VertexMemory.clear();
 			m_IndicesMemory.clear();
 			m_VertexBuffer.clear();
+			m_PositionBuffer.clear();
+			m_PositionMemory.clear();
 			m_IndexBuffer.clear();
 			indicesCount = 0;
 			vertexCount = 0;
+			materialIndex = 0;
+			streamedTextures.clear();
 		}
 	public:
 		std::vector<VkTexture> textures = {};
@@ -106,10 +134,16 @@ namespace MVT {
 		//std::vector<void *> uniformBuffersMapped;
 		vk::raii::Buffer m_VertexBuffer = nullptr;
 		vk::raii::DeviceMemory m_VertexMemory = nullptr;
+		vk::raii::Buffer m_PositionBuffer = nullptr; // Tightly packed `glm::vec3`, for the depth pre-pass.
+		vk::raii::DeviceMemory m_PositionMemory = nullptr;
 		vk::raii::Buffer m_IndexBuffer = nullptr;
 		vk::raii::DeviceMemory m_IndicesMemory = nullptr;
 		uint32_t indicesCount = 0;
 		uint32_t vertexCount = 0;
+		uint32_t materialIndex = 0;
+		std::vector<uint32_t> streamedTextures = {}; // Handles in the `TextureResidency`.
+		glm::vec3 boundsCenter{0.0f};
+		float boundsRadius = 0.0f;
 	};
 } // MVT
 
@@ -0,0 +1,52 @@
+//
+// Created by ianpo on 04/01/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace MVT {
+	/// Full mip pyramid of a RGBA8 image, `levels[0]` being the base level.
+	struct MipChain {
+	public:
+		[[nodiscard]] uint32_t GetLevelWidth(uint32_t level) const { return std::max(1u, width >> level); }
+
+		[[nodiscard]] uint32_t GetLevelHeight(uint32_t level) const { return std::max(1u, height >> level); }
+
+	public:
+		uint32_t width = 0;
+		uint32_t height = 0;
+		bool srgb = true;
+		std::vector<std::vector<uint8_t>> levels{};
+	};
+
+	struct MipChainRequest {
+		const uint8_t *rgba = nullptr;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		bool srgb = true;
+	};
+
+	/// Software mip generation on top of stb_image_resize2.
+	/// Every level is filtered from the previous one, the large levels split in bands of rows computed in parallel.
+	/// sRGB images are filtered in linear space and written back in sRGB, alpha is always linear.
+	class MipGenerator {
+	public:
+		/// Levels smaller than this are resized on the calling thread, splitting them costs more than it saves.
+		static inline constexpr uint64_t c_MinParallelPixels = 256 * 256;
+
+	public:
+		[[nodiscard]] static uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+
+		[[nodiscard]] static MipChain Generate(const uint8_t *rgba, uint32_t width, uint32_t height, bool srgb, bool parallel = true);
+
+		/// Generate several chains at once, in parallel across textures and within their large levels.
+		[[nodiscard]] static std::vector<MipChain> Generate(std::span<const MipChainRequest> requests);
+
+		static void ResizeLevel(const uint8_t *src, uint32_t srcWidth, uint32_t srcHeight, uint8_t *dst, uint32_t dstWidth, uint32_t dstHeight, bool srgb, bool parallel = false);
+	};
+} // MVT
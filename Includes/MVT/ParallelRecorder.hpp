@@ -0,0 +1,60 @@
+//
+// Created by ianpo on 09/01/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include "MVT/FrameScheduler.hpp"
+
+namespace MVT {
+	/// Records a draw list across `JobSystem` jobs into secondary command buffers.
+	/// Every chunk owns one transient command pool per frame slot, reset as a whole by `beginFrame`, so no command buffer
+	/// is ever reset individually and no pool is used by two jobs at once. The secondaries inherit the dynamic rendering
+	/// state of the primary through `VkCommandBufferInheritanceRenderingInfo`, the primary only executes them.
+	class ParallelRecorder {
+	public:
+		/// Records the items `[begin, end)` in `commandBuffer`. Bindings and dynamic state are not inherited and must be set.
+		using RecordFunction = std::function<void(const vk::raii::CommandBuffer &commandBuffer, uint32_t begin, uint32_t end)>;
+
+	public:
+		/// Up to `threadCount` chunks, the calling thread included. 0 uses every `JobSystem` thread.
+		ParallelRecorder(const vk::raii::Device &device, uint32_t queueFamily, uint32_t threadCount = 0);
+
+		ParallelRecorder(const ParallelRecorder &) = delete;
+
+		ParallelRecorder &operator=(const ParallelRecorder &) = delete;
+
+		[[nodiscard]] uint32_t getThreadCount() const { return static_cast<uint32_t>(m_Contexts.size()); }
+
+	public:
+		/// Reset the pools of `slot`, its previous frame must have completed.
+		void beginFrame(uint32_t slot);
+
+		/// Split `itemCount` items in chunks of at least `minItemsPerThread`, record them in parallel and return one
+		/// secondary per chunk, in item order. The calling thread records the first chunk and helps with the others.
+		std::span<const vk::CommandBuffer> record(uint32_t slot, const vk::CommandBufferInheritanceRenderingInfo &rendering, uint32_t itemCount, uint32_t minItemsPerThread, const RecordFunction &function);
+
+	private:
+		static_assert(FrameScheduler::c_MaxFramesInFlight == 4, "Update the pools initializer of `ThreadContext`.");
+
+		struct ThreadContext {
+			std::array<vk::raii::CommandPool, FrameScheduler::c_MaxFramesInFlight> pools{nullptr, nullptr, nullptr, nullptr};
+			std::array<std::vector<vk::raii::CommandBuffer>, FrameScheduler::c_MaxFramesInFlight> commandBuffers{};
+			std::array<uint32_t, FrameScheduler::c_MaxFramesInFlight> used{};
+		};
+
+		void recordChunk(uint32_t chunk, uint32_t slot, const vk::CommandBufferInheritanceRenderingInfo &rendering, uint32_t begin, uint32_t end, const RecordFunction &function);
+
+	private:
+		const vk::raii::Device *m_Device = nullptr;
+		std::vector<ThreadContext> m_Contexts{}; // Chunk `i` records with context `i`.
+		std::vector<vk::CommandBuffer> m_Recorded{};
+	};
+} // MVT
@@ -0,0 +1,275 @@
+//
+// Created by ianpo on 11/01/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+#include <vk_mem_alloc.h>
+
+#include "MVT/FrameScheduler.hpp"
+#include "MVT/FrameScratch.hpp"
+
+namespace MVT {
+	using RenderGraphHandle = uint32_t;
+
+	/// How a pass uses a resource. Decides the stages, accesses and layout the graph synchronizes on.
+	enum class RenderGraphAccess : uint8_t {
+		ColorAttachmentWrite, // Color and resolve attachments.
+		DepthAttachmentWrite,
+		DepthAttachmentRead, // Depth test without writes.
+		SampledRead, // Fragment or compute shaders.
+		StorageRead, // Compute shaders.
+		StorageWrite, // Compute shaders.
+		TransferRead,
+		TransferWrite,
+		UniformRead, // Buffers only.
+		VertexRead, // Vertex and index buffers.
+		IndirectRead, // Buffers only.
+	};
+
+	struct RenderGraphAccessInfo {
+		vk::PipelineStageFlags2 stages{};
+		vk::AccessFlags2 access{};
+		vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+		vk::ImageUsageFlags usage{};
+		bool write = false;
+	};
+
+	struct RenderGraphImageDesc {
+		vk::Format format = vk::Format::eUndefined;
+		vk::Extent2D extent{};
+		vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+		uint32_t mipLevels = 1;
+	};
+
+	/// Image owned outside the graph, the swapchain image for instance.
+	struct RenderGraphImportedImage {
+		vk::Image image{};
+		vk::ImageView view{};
+		RenderGraphImageDesc desc{};
+		/// Layout and stages of the last use before the graph. Undefined discards the content.
+		vk::ImageLayout initialLayout = vk::ImageLayout::eUndefined;
+		vk::PipelineStageFlags2 initialStages{};
+		/// Layout the image is left in, eUndefined keeps the layout of its last use.
+		vk::ImageLayout finalLayout = vk::ImageLayout::eUndefined;
+	};
+
+	struct RenderGraphStats {
+		uint32_t passes = 0;
+		uint32_t culledPasses = 0;
+		uint32_t barriers = 0;
+		uint32_t barrierBatches = 0;
+		vk::DeviceSize transientBytes = 0; // Memory of the transient images, aliased.
+		vk::DeviceSize unaliasedBytes = 0; // What they would take without aliasing.
+		vk::DeviceSize memorylessBytes = 0; // Attachments in lazily allocated memory, never committed on tiled GPUs.
+	};
+
+	/// Frame graph rebuilt every frame: passes declare the images and buffers they read and write, the graph culls the
+	/// passes nothing depends on, batches the barriers of each pass boundary in a single `DependencyInfo` and places the
+	/// transient images with disjoint lifetimes in the same memory.
+	/// Transient images only ever used as attachments are created with `eTransientAttachment` and placed in lazily allocated
+	/// memory when the device has some, they then never leave the tile memory of tiled GPUs.
+	/// Transient images are kept per frame slot: a slot only rebuilds them when the declared graph changed, at a point
+	/// where its previous frame completed, so nothing waits on the GPU.
+	/// The declarations of a frame live in its `FrameScratch`: declaring the same graph again doesn't allocate.
+	class RenderGraph {
+	public:
+		/// Records a pass. `closure` is the callable given to `addPass`, copied in the frame scratch.
+		struct ExecuteFunction {
+			void (*function)(const void *closure, const vk::raii::CommandBuffer &commandBuffer, const RenderGraph &graph) = nullptr;
+			const void *closure = nullptr;
+		};
+
+		class PassBuilder {
+		public:
+			PassBuilder(RenderGraph &graph, uint32_t pass) : m_Graph(&graph), m_Pass(pass) {}
+
+			PassBuilder &read(RenderGraphHandle resource, RenderGraphAccess access);
+
+			PassBuilder &write(RenderGraphHandle resource, RenderGraphAccess access);
+
+			/// Never culled, for passes with effects outside the graph.
+			PassBuilder &sideEffect();
+
+		private:
+			RenderGraph *m_Graph;
+			uint32_t m_Pass;
+		};
+
+	public:
+		RenderGraph() = default;
+
+		RenderGraph(const vk::raii::Device &device, VmaAllocator allocator);
+
+		~RenderGraph();
+
+		RenderGraph(const RenderGraph &) = delete;
+
+		RenderGraph &operator=(const RenderGraph &) = delete;
+
+		RenderGraph(RenderGraph &&o) noexcept;
+
+		RenderGraph &operator=(RenderGraph &&o) noexcept;
+
+		[[nodiscard]] bool isValid() const { return m_Allocator != nullptr; }
+
+		[[nodiscard]] static RenderGraphAccessInfo GetAccessInfo(RenderGraphAccess access);
+
+		/// Stages and accesses that may touch an image in `layout`, for one-off transitions outside of a graph.
+		[[nodiscard]] static RenderGraphAccessInfo GetLayoutAccessInfo(vk::ImageLayout layout);
+
+		[[nodiscard]] static vk::ImageAspectFlags GetAspect(vk::Format format);
+
+	public: // Declaration, every frame. Names must outlive the frame, literals.
+		/// Forget the passes and resources of the previous frame, the transient images are kept. The new declarations
+		/// allocate from `scratch`, which must not be reset before the graph executed.
+		void reset(FrameScratch &scratch);
+
+		RenderGraphHandle importImage(const char *name, const RenderGraphImportedImage &image);
+
+		RenderGraphHandle importBuffer(const char *name, vk::Buffer buffer, vk::DeviceSize size = vk::WholeSize);
+
+		/// Image living for the frame only, its content is undefined at its first use.
+		RenderGraphHandle createImage(const char *name, const RenderGraphImageDesc &desc);
+
+		/// `execute` is called as `execute(commandBuffer, graph)`. It is copied in the frame scratch, never destroyed.
+		template<typename Function>
+		PassBuilder addPass(const char *name, Function &&execute) {
+			using Closure = std::remove_cvref_t<Function>;
+			const Closure *closure = m_Scratch->create<Closure>(std::forward<Function>(execute));
+			return addPass(name, ExecuteFunction{
+				.function = [](const void *object, const vk::raii::CommandBuffer &commandBuffer, const RenderGraph &graph) { (*static_cast<const Closure *>(object))(commandBuffer, graph); },
+				.closure = closure,
+			});
+		}
+
+		PassBuilder addPass(const char *name, ExecuteFunction execute);
+
+	public: // Compilation and execution.
+		/// Cull, place the transient images of `slot` and compute the barriers. The slot's previous frame must have completed.
+		void compile(uint32_t slot);
+
+		/// Record the live passes and their barriers.
+		void execute(const vk::raii::CommandBuffer &commandBuffer) const;
+
+		[[nodiscard]] vk::Image getImage(RenderGraphHandle resource) const;
+
+		[[nodiscard]] vk::ImageView getImageView(RenderGraphHandle resource) const;
+
+		[[nodiscard]] vk::Buffer getBuffer(RenderGraphHandle resource) const;
+
+		[[nodiscard]] const RenderGraphImageDesc &getImageDesc(RenderGraphHandle resource) const;
+
+		[[nodiscard]] const RenderGraphStats &getStats() const { return m_Stats; }
+
+		/// Destroy every transient image, the GPU must be done with them.
+		void clear();
+
+	private:
+		struct Use {
+			RenderGraphHandle resource = 0;
+			RenderGraphAccess access{};
+		};
+
+		struct Pass {
+			const char *name = "";
+			ExecuteFunction execute{};
+			std::pmr::vector<Use> uses{}; // In the frame scratch.
+			bool sideEffect = false;
+			bool alive = false;
+			// Barriers recorded before the pass, ranges in `m_ImageBarriers` and `m_BufferBarriers`.
+			uint32_t firstImageBarrier = 0, imageBarrierCount = 0;
+			uint32_t firstBufferBarrier = 0, bufferBarrierCount = 0;
+		};
+
+		/// Synchronization state of a resource while walking the passes.
+		struct State {
+			vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+			vk::PipelineStageFlags2 writeStages{};
+			vk::AccessFlags2 writeAccess{};
+			vk::PipelineStageFlags2 readStages{}; // Every read since the last write, for write-after-read.
+			vk::PipelineStageFlags2 visibleStages{}; // Reads already made visible since the last write.
+			vk::AccessFlags2 visibleAccess{};
+		};
+
+		struct Resource {
+			const char *name = "";
+			bool buffer = false;
+			bool imported = false;
+			RenderGraphImageDesc desc{};
+			vk::ImageUsageFlags usage{};
+			vk::Image image{};
+			vk::ImageView view{};
+			vk::Buffer bufferHandle{};
+			vk::DeviceSize size = 0;
+			vk::ImageLayout finalLayout = vk::ImageLayout::eUndefined;
+			State state{};
+			uint32_t transient = ~0u; // Index in the slot's transient images.
+			uint32_t firstPass = ~0u, lastPass = 0;
+			bool needed = false;
+		};
+
+		struct TransientImage {
+			vk::raii::Image image = nullptr;
+			vk::raii::ImageView view = nullptr;
+			uint32_t heap = 0;
+			vk::DeviceSize offset = 0;
+			vk::DeviceSize size = 0;
+			uint32_t firstPass = 0, lastPass = 0;
+			std::vector<uint32_t> aliases{}; // Transients using the same memory earlier in the frame.
+		};
+
+		struct TransientSet {
+			uint64_t key = 0;
+			std::vector<TransientImage> images{};
+			std::vector<VmaAllocation> heaps{};
+			vk::DeviceSize bytes = 0;
+			vk::DeviceSize unaliasedBytes = 0;
+			vk::DeviceSize memorylessBytes = 0;
+		};
+
+		void clearDeclarations();
+
+		void addUse(uint32_t pass, RenderGraphHandle resource, RenderGraphAccess access);
+
+		void cull();
+
+		/// Flag the transient images only used as attachments, they may live in lazily allocated memory.
+		void markMemoryless();
+
+		[[nodiscard]] uint64_t computeTransientKey() const;
+
+		void buildTransients(TransientSet &set);
+
+		void releaseTransients(TransientSet &set);
+
+		void computeBarriers(const TransientSet &set);
+
+		/// Append the barrier needed before `access`, if any, and update the state of the resource.
+		void synchronize(Resource &resource, const RenderGraphAccessInfo &info, vk::PipelineStageFlags2 aliasStages, vk::AccessFlags2 aliasAccess);
+
+	private:
+		const vk::raii::Device *m_Device = nullptr;
+		VmaAllocator m_Allocator = nullptr;
+		FrameScratch *m_Scratch = nullptr; // Of the frame being declared.
+
+		std::vector<Pass> m_Passes{};
+		std::vector<Resource> m_Resources{};
+		uint32_t m_TransientCount = 0;
+
+		std::vector<vk::ImageMemoryBarrier2> m_ImageBarriers{};
+		std::vector<vk::BufferMemoryBarrier2> m_BufferBarriers{};
+		uint32_t m_FinalBarrierOffset = 0;
+
+		std::array<TransientSet, FrameScheduler::c_MaxFramesInFlight> m_Transients{};
+		uint32_t m_Slot = 0;
+		RenderGraphStats m_Stats{};
+	};
+} // MVT
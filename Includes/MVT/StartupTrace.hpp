@@ -0,0 +1,70 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MVT {
+	/// Wall clock timeline of the startup, from `start` to the milestones reported. Any thread records its phases, the
+	/// ones running on the workers overlap the main thread's.
+	class StartupTrace {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/// Records a phase from its construction to its destruction.
+		class Scope {
+		public:
+			Scope(StartupTrace &trace, const char *name) : m_Trace(&trace), m_Name(name), m_Begin(Clock::now()) {}
+
+			~Scope() { m_Trace->record(m_Name, m_Begin, Clock::now()); }
+
+			Scope(const Scope &) = delete;
+
+			Scope &operator=(const Scope &) = delete;
+
+		private:
+			StartupTrace *m_Trace;
+			const char *m_Name;
+			Clock::time_point m_Begin;
+		};
+
+	public:
+		StartupTrace() = default;
+
+		StartupTrace(const StartupTrace &) = delete;
+
+		StartupTrace &operator=(const StartupTrace &) = delete;
+
+		/// Origin of the timeline and main thread of the report, forgets the phases recorded before.
+		void start();
+
+		[[nodiscard]] bool isStarted() const { return m_Start != Clock::time_point{}; }
+
+		[[nodiscard]] Scope phase(const char *name) { return Scope{*this, name}; }
+
+		/// `name` must outlive the trace, a literal.
+		void record(const char *name, Clock::time_point begin, Clock::time_point end);
+
+		/// Print the phases in the order they started, then the time from `start` to now as `milestone` and how much of
+		/// it the phases running side by side saved.
+		void report(const char *milestone) const;
+
+	private:
+		struct Phase {
+			const char *name = nullptr;
+			Clock::time_point begin{};
+			Clock::time_point end{};
+			std::thread::id thread{};
+		};
+
+		mutable std::mutex m_Mutex;
+		Clock::time_point m_Start{};
+		std::thread::id m_MainThread{};
+		std::vector<Phase> m_Phases{};
+	};
+} // MVT
@@ -0,0 +1,327 @@
+//
+// Created by ianpo on 18/01/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "MVT/JobSystem.hpp"
+
+namespace MVT {
+	template<typename T = void>
+	class Task;
+
+	namespace Detail {
+		struct TaskPromiseBase {
+			/// Resume the awaiting coroutine straight from the final suspend point, on the thread that finished the task.
+			struct FinalAwaiter {
+				[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+				template<typename Promise>
+				std::coroutine_handle<> await_suspend(const std::coroutine_handle<Promise> handle) const noexcept {
+					if (const std::coroutine_handle<> continuation = handle.promise().continuation) return continuation;
+					return std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+			[[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+
+			[[nodiscard]] FinalAwaiter final_suspend() const noexcept { return {}; }
+
+			void unhandled_exception() { error = std::current_exception(); }
+
+			std::coroutine_handle<> continuation{};
+			std::exception_ptr error{};
+		};
+
+		template<typename T>
+		struct TaskPromise : TaskPromiseBase {
+			Task<T> get_return_object();
+
+			template<typename U>
+			void return_value(U &&result) { value.emplace(std::forward<U>(result)); }
+
+			T take() {
+				if (error) std::rethrow_exception(error);
+				return std::move(*value);
+			}
+
+			std::optional<T> value{};
+		};
+
+		template<>
+		struct TaskPromise<void> : TaskPromiseBase {
+			Task<void> get_return_object();
+
+			void return_void() const noexcept {}
+
+			void take() const {
+				if (error) std::rethrow_exception(error);
+			}
+		};
+
+		/// Fire and forget coroutine, starts immediately and frees itself at the end.
+		struct DetachedTask {
+			struct promise_type {
+				[[nodiscard]] DetachedTask get_return_object() const noexcept { return {}; }
+
+				[[nodiscard]] std::suspend_never initial_suspend() const noexcept { return {}; }
+
+				[[nodiscard]] std::suspend_never final_suspend() const noexcept { return {}; }
+
+				void return_void() const noexcept {}
+
+				void unhandled_exception() const noexcept { std::terminate(); }
+			};
+		};
+	}
+
+	/// Lazy coroutine: nothing runs until it is awaited, then it runs on the awaiting thread until it suspends itself
+	/// (`ScheduleOnJobs`, `TimelineResumer::after`...). The awaiting coroutine resumes where the task finished.
+	/// Exceptions are stored and rethrown by `co_await` or `getResult`.
+	template<typename T>
+	class Task {
+	public:
+		using promise_type = Detail::TaskPromise<T>;
+
+	public:
+		Task() = default;
+
+		explicit Task(const std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+		~Task() {
+			if (m_Handle) m_Handle.destroy();
+		}
+
+		Task(const Task &) = delete;
+
+		Task &operator=(const Task &) = delete;
+
+		Task(Task &&other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+
+		Task &operator=(Task &&other) noexcept {
+			if (this != &other) {
+				if (m_Handle) m_Handle.destroy();
+				m_Handle = std::exchange(other.m_Handle, nullptr);
+			}
+			return *this;
+		}
+
+		[[nodiscard]] bool isDone() const { return !m_Handle || m_Handle.done(); }
+
+		/// Result of a finished task, moved out.
+		T getResult() { return m_Handle.promise().take(); }
+
+		auto operator co_await() noexcept {
+			struct Awaiter {
+				std::coroutine_handle<promise_type> handle;
+
+				[[nodiscard]] bool await_ready() const noexcept { return !handle || handle.done(); }
+
+				std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) const noexcept {
+					handle.promise().continuation = awaiting;
+					return handle;
+				}
+
+				T await_resume() const { return handle.promise().take(); }
+			};
+			return Awaiter{m_Handle};
+		}
+
+		/// Run the task to completion without taking its result or rethrowing its error.
+		auto whenReady() noexcept {
+			struct Awaiter {
+				std::coroutine_handle<promise_type> handle;
+
+				[[nodiscard]] bool await_ready() const noexcept { return !handle || handle.done(); }
+
+				std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) const noexcept {
+					handle.promise().continuation = awaiting;
+					return handle;
+				}
+
+				void await_resume() const noexcept {}
+			};
+			return Awaiter{m_Handle};
+		}
+
+	private:
+		std::coroutine_handle<promise_type> m_Handle = nullptr;
+	};
+
+	template<typename T>
+	Task<T> Detail::TaskPromise<T>::get_return_object() { return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)}; }
+
+	inline Task<void> Detail::TaskPromise<void>::get_return_object() { return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)}; }
+
+	/// `co_await ScheduleOnJobs{}` continues the coroutine on a `JobSystem` worker.
+	struct ScheduleOnJobs {
+		[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+		void await_suspend(const std::coroutine_handle<> handle) const {
+			JobSystem::Spawn([handle]() { handle.resume(); });
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	/// Coroutines waiting on values of a timeline semaphore. They resume on the thread calling `resume`, the one that
+	/// owns the queues and command pools, once the completed value reached theirs.
+	class TimelineResumer {
+	public:
+		struct Awaiter {
+			TimelineResumer *resumer = nullptr;
+			uint64_t value = 0;
+
+			[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+			void await_suspend(std::coroutine_handle<> handle) const;
+
+			void await_resume() const noexcept {}
+		};
+
+	public:
+		TimelineResumer() = default;
+
+		TimelineResumer(const TimelineResumer &) = delete;
+
+		TimelineResumer &operator=(const TimelineResumer &) = delete;
+
+		/// Resume at the first `resume` whose completed value is at least `value`. 0 resumes at the next one.
+		[[nodiscard]] Awaiter after(const uint64_t value) { return Awaiter{this, value}; }
+
+		/// Resume the coroutines whose value completed. The ones they queue meanwhile wait for the next call.
+		void resume(uint64_t completedValue);
+
+		/// Smallest value waited on, none when nothing waits.
+		[[nodiscard]] std::optional<uint64_t> getNextValue() const;
+
+	private:
+		struct Waiting {
+			uint64_t value = 0;
+			std::coroutine_handle<> handle{};
+		};
+
+		mutable std::mutex m_Mutex;
+		std::vector<Waiting> m_Waiting{};
+		std::vector<Waiting> m_Ready{}; // Only used by `resume`, kept for its capacity.
+	};
+
+	/// Run every task in parallel, each one starting on a `JobSystem` worker. The awaiting coroutine resumes on the
+	/// thread that finished the last one, then the first error is rethrown.
+	Task<void> WhenAll(std::vector<Task<void>> tasks);
+
+	/// Read a whole file on a `JobSystem` worker, the coroutine continues there.
+	Task<std::vector<char>> ReadFileAsync(std::filesystem::path path);
+
+	/// Task started at construction instead of when awaited: it runs on the constructing thread until it suspends itself,
+	/// then wherever it continues. Its result is taken once, by a coroutine awaiting it or by `join`.
+	template<typename T>
+	class StartedTask {
+	public:
+		explicit StartedTask(Task<T> task) : m_State(std::make_shared<State>(std::move(task))) {
+			Drive(m_State);
+		}
+
+		StartedTask(const StartedTask &) = delete;
+
+		StartedTask &operator=(const StartedTask &) = delete;
+
+		StartedTask(StartedTask &&) noexcept = default;
+
+		StartedTask &operator=(StartedTask &&) noexcept = default;
+
+		[[nodiscard]] bool isDone() const { return m_State->isDone(); }
+
+		/// Block the calling thread until the task finished. `idle` runs in between checks when given, for the thread to
+		/// keep resuming the coroutines it owns, otherwise the thread sleeps.
+		T join(const std::function<void()> &idle = {}) {
+			void *waiter = nullptr;
+			while ((waiter = m_State->waiter.load(std::memory_order_acquire)) != m_State.get()) {
+				if (idle) {
+					idle();
+				}
+				else {
+					m_State->waiter.wait(waiter, std::memory_order_acquire);
+				}
+			}
+			return m_State->task.getResult();
+		}
+
+		auto operator co_await() noexcept {
+			struct Awaiter {
+				State *state;
+
+				[[nodiscard]] bool await_ready() const noexcept { return state->isDone(); }
+
+				/// False when the task finished in between, the awaiting coroutine continues right away.
+				bool await_suspend(const std::coroutine_handle<> awaiting) const noexcept {
+					void *expected = nullptr;
+					return state->waiter.compare_exchange_strong(expected, awaiting.address(), std::memory_order_acq_rel, std::memory_order_acquire);
+				}
+
+				T await_resume() const { return state->task.getResult(); }
+			};
+			return Awaiter{m_State.get()};
+		}
+
+		/// Wait for the task to finish without taking its result, `join` still does. Only one coroutine may wait on it.
+		auto whenReady() noexcept {
+			struct Awaiter {
+				State *state;
+
+				[[nodiscard]] bool await_ready() const noexcept { return state->isDone(); }
+
+				bool await_suspend(const std::coroutine_handle<> awaiting) const noexcept {
+					void *expected = nullptr;
+					return state->waiter.compare_exchange_strong(expected, awaiting.address(), std::memory_order_acq_rel, std::memory_order_acquire);
+				}
+
+				void await_resume() const noexcept {}
+			};
+			return Awaiter{m_State.get()};
+		}
+
+	private:
+		/// Shared with the driver: it may still notify after the owner saw the task finish and left.
+		struct State {
+			explicit State(Task<T> started) : task(std::move(started)) {}
+
+			[[nodiscard]] bool isDone() const { return waiter.load(std::memory_order_acquire) == this; }
+
+			Task<T> task;
+			std::atomic<void *> waiter{nullptr}; // The awaiting coroutine, then the state itself once the task finished.
+		};
+
+		static Detail::DetachedTask Drive(const std::shared_ptr<State> state) {
+			co_await state->task.whenReady();
+			void *const waiter = state->waiter.exchange(state.get(), std::memory_order_acq_rel);
+			state->waiter.notify_all();
+			if (waiter) {
+				std::coroutine_handle<>::from_address(waiter).resume();
+			}
+		}
+
+	private:
+		std::shared_ptr<State> m_State;
+	};
+
+	/// Block the calling thread until `task` finished, see `StartedTask::join`.
+	template<typename T>
+	T SyncWait(Task<T> task, const std::function<void()> &idle = {}) {
+		return StartedTask<T>(std::move(task)).join(idle);
+	}
+} // MVT
@@ -0,0 +1,52 @@
+//
+// Created by ianpo on 03/01/2026.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vulkan/vulkan.hpp>
+
+#include "MVT/BlockCompression.hpp"
+#include "MVT/Expected.hpp"
+#include "MVT/KTX2.hpp"
+
+namespace MVT {
+	enum class TextureUsage : uint8_t {
+		Color, // sRGB color with alpha (albedo, UI, ...)
+		ColorOpaque, // sRGB color, alpha is discarded
+		Normal, // Tangent space normal map, only RG are kept
+		Data, // Linear data (masks, roughness, metalness, ...)
+	};
+
+	struct TextureCookRequest {
+		std::filesystem::path source{};
+		vk::Format format = vk::Format::eUndefined;
+		bool persist = true;
+	};
+
+	/// Turn PNG/JPG sources into KTX2 textures with a full mip chain, block compressed when the format asks for it.
+	/// When persisted, the cooked result is cached next to the other engine assets and reused as long as it is newer than the source.
+	class TextureCooker {
+	public:
+		static inline std::filesystem::path s_CacheDirectory{"EngineAssets/Cache/Textures"};
+
+	public:
+		/// Formats usable for `usage`, by order of preference. The last one is always uncompressed.
+		[[nodiscard]] static std::span<const vk::Format> GetFormatCandidates(TextureUsage usage);
+
+		[[nodiscard]] static std::optional<BlockFormat> GetBlockFormat(vk::Format format);
+
+		[[nodiscard]] static bool IsSrgb(vk::Format format);
+
+		[[nodiscard]] static std::filesystem::path GetCachePath(const std::filesystem::path &source, vk::Format format);
+
+		[[nodiscard]] static Expected<Ktx2Texture, std::string> Cook(const std::filesystem::path &source, vk::Format format, bool persist = true);
+
+		/// Cook several textures in parallel.
+		[[nodiscard]] static std::vector<Expected<Ktx2Texture, std::string>> Cook(std::span<const TextureCookRequest> requests);
+	};
+} // MVT
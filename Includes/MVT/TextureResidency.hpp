@@ -0,0 +1,153 @@
+//
+// Created by ianpo on 07/01/2026.
+//
+
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+#include <vk_mem_alloc.h>
+
+#include "MVT/BindlessTable.hpp"
+#include "MVT/FrameScratch.hpp"
+#include "MVT/KTX2.hpp"
+#include "MVT/VmaBuffer.hpp"
+#include "MVT/VmaImage.hpp"
+
+namespace MVT {
+	struct ResidencySettings {
+		/// Share of the VMA device local budget usable before low priority mips get evicted.
+		float budgetFraction = 0.85f;
+		/// When not 0, hard cap on the streamed textures instead of the VMA budget (to emulate a smaller card).
+		uint64_t textureBudget = 0;
+		/// Bytes uploaded per frame at most, the rest is streamed over the next frames.
+		uint64_t maxUploadBytesPerFrame = 16ull << 20;
+		/// Textures start with the mips smaller or equal to this extent.
+		uint32_t initialMaxExtent = 64;
+	};
+
+	struct ResidencyStats {
+		uint64_t residentBytes = 0;
+		uint64_t usageBytes = 0;
+		uint64_t limitBytes = 0;
+		uint64_t uploadedBytes = 0; // During the last `record`.
+		uint32_t streamedIn = 0; // During the last `record`.
+		uint32_t evicted = 0; // During the last `record`.
+	};
+
+	/// Mip streaming under a memory budget.
+	/// Every texture keeps its full cooked chain in RAM and only a tail of its mips on the GPU. Changing the resident range
+	/// creates a new image, copies the mips both images share, uploads the missing ones and publishes the new view in a new
+	/// bindless slot. The previous image, view and slot are kept until the frames that may still sample them completed.
+	/// Everything is recorded in the frame command buffer, nothing waits on the GPU.
+	class TextureResidency {
+	public:
+		static inline constexpr uint32_t c_InvalidHandle = ~0u;
+		static inline constexpr uint32_t c_NotResident = ~0u;
+		static inline constexpr uint64_t c_NeverChanged = ~0ull;
+
+	public:
+		TextureResidency() = default;
+
+		TextureResidency(const vk::raii::Device &device, VmaAllocator allocator, BindlessTable &bindlessTable, vk::Sampler sampler, uint32_t fallbackTextureSlot, ResidencySettings settings = {});
+
+		[[nodiscard]] bool isValid() const { return m_Allocator != nullptr; }
+
+		/// Most detailed mip worth sampling when the texture covers `screenExtent` pixels.
+		[[nodiscard]] static uint32_t ComputeDesiredMip(uint32_t width, uint32_t height, uint32_t mipLevels, float screenExtent);
+
+	public:
+		/// Start streaming a texture, the lowest mips are uploaded during the next `record`.
+		[[nodiscard]] uint32_t add(Ktx2Texture source);
+
+		/// Ask for `mip` to be resident this frame. Textures that stop being requested fall back to their lowest mips when the budget is exceeded.
+		void request(uint32_t handle, uint32_t mip, float priority, uint64_t frame);
+
+		/// `request` the mip matching `screenExtent` pixels, with the extent as priority.
+		void requestExtent(uint32_t handle, float screenExtent, uint64_t frame);
+
+		/// Decide what to stream in and evict, and record the copies at the start of `commandBuffer`. The bookkeeping of
+		/// the frame goes in `scratch`.
+		void record(const vk::raii::CommandBuffer &commandBuffer, uint64_t frame, FrameScratch &scratch);
+
+		/// Free what the frames up to `completedFrame` were still using.
+		void retire(uint64_t completedFrame);
+
+		/// Whether a texture moved to another bindless slot since the last call.
+		[[nodiscard]] bool consumeSlotChanges();
+
+		[[nodiscard]] uint32_t getTextureSlot(uint32_t handle) const;
+
+		[[nodiscard]] uint32_t getSamplerSlot() const { return m_SamplerSlot; }
+
+		[[nodiscard]] uint32_t getResidentMip(uint32_t handle) const;
+
+		[[nodiscard]] const ResidencyStats &getStats() const { return m_Stats; }
+
+		[[nodiscard]] ResidencySettings &getSettings() { return m_Settings; }
+
+		/// Destroy everything, the GPU must be idle.
+		void clear();
+
+	private:
+		struct StreamedTexture {
+			Ktx2Texture source{};
+			VmaImage image{};
+			vk::raii::ImageView view = nullptr;
+			uint32_t slot = BindlessTable::c_InvalidSlot;
+			uint32_t residentMip = c_NotResident;
+			uint32_t lowestMip = 0; // Least detailed resident range, never evicted.
+			uint32_t requestedMip = 0;
+			float priority = 0.0f;
+			uint64_t lastRequestFrame = 0;
+			uint64_t residentBytes = 0;
+			// Last `record` that changed the resident range: a change reads the image the previous one writes, so one per batch.
+			uint64_t lastChangeFrame = c_NeverChanged;
+		};
+
+		struct Retired {
+			uint64_t frame = 0;
+			VmaImage image{};
+			vk::raii::ImageView view = nullptr;
+			VmaBuffer staging{};
+			uint32_t slot = BindlessTable::c_InvalidSlot;
+			uint64_t bytes = 0;
+		};
+
+		struct Copy {
+			vk::Image source{}; // Previous image, null for the first upload.
+			vk::Image destination{};
+			std::vector<vk::ImageCopy> imageCopies{};
+			vk::Buffer staging{};
+			std::vector<vk::BufferImageCopy> bufferCopies{};
+		};
+
+		/// Pre barriers, copies and post barriers of every change of the frame, recorded in three batches.
+		struct Batch {
+			std::vector<vk::ImageMemoryBarrier2> before{};
+			std::vector<Copy> copies{};
+			std::vector<vk::ImageMemoryBarrier2> after{};
+		};
+
+		bool changeResidency(StreamedTexture &texture, uint32_t mip, uint64_t frame, Batch &batch);
+
+		void queryBudget(uint64_t &usage, uint64_t &limit) const;
+
+		[[nodiscard]] static uint64_t GetRangeSize(const StreamedTexture &texture, uint32_t firstMip, uint32_t lastMip);
+
+	private:
+		const vk::raii::Device *m_Device = nullptr;
+		VmaAllocator m_Allocator = nullptr;
+		BindlessTable *m_BindlessTable = nullptr;
+		uint32_t m_SamplerSlot = BindlessTable::c_InvalidSlot;
+		uint32_t m_FallbackSlot = BindlessTable::c_InvalidSlot;
+		ResidencySettings m_Settings{};
+		ResidencyStats m_Stats{};
+
+		std::vector<StreamedTexture> m_Textures{};
+		std::vector<Retired> m_Retired{};
+		uint64_t m_RetiringBytes = 0;
+		bool m_SlotsChanged = false;
+	};
+} // MVT
@@ -12,4 +12,9 @@ namespace MVT {
 		glm::mat4x4 view;
 		glm::mat4x4 proj;
 	};
+
+	/// Per-draw block, pushed in the `FrameAllocator` and bound with a dynamic offset.
+	struct ObjectUniform {
+		glm::mat4x4 model;
+	};
 }
\ No newline at end of file
@@ -29,8 +29,9 @@ namespace MVT {
 		void swap(VmaBuffer& o) noexcept;
 
 	public:
-		vk::Buffer operator*(){return buffer;}
+		vk::Buffer operator*() const {return buffer;}
 		vk::Buffer* operator->(){return &buffer;}
+		[[nodiscard]] bool IsValid() const {return allocator != nullptr;}
 
 	public:
 		VmaAllocationInfo GetAllocationInfo();
@@ -0,0 +1,42 @@
+//
+// Created by ianpo on 07/01/2026.
+//
+
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+namespace MVT {
+	class VmaImage {
+	public:
+		VmaImage() = default;
+		VmaImage(VmaAllocator allocator, const VkImageCreateInfo* pImageInfo, const VmaAllocationCreateInfo* pAllocInfo);
+		~VmaImage();
+
+		VmaImage(const VmaImage& o) = delete;
+		VmaImage& operator=(const VmaImage& o) = delete;
+
+		VmaImage(VmaImage&& o) noexcept;
+		VmaImage& operator=(VmaImage&& o) noexcept;
+
+	public:
+		void swap(VmaImage& o) noexcept;
+
+		void reset();
+
+	public:
+		vk::Image operator*() const {return image;}
+		[[nodiscard]] bool IsValid() const {return allocator != nullptr;}
+
+	public:
+		[[nodiscard]] VmaAllocationInfo GetAllocationInfo() const;
+
+	private:
+		vk::Image image = nullptr;
+		VmaAllocator allocator = nullptr;
+		VmaAllocation allocation = nullptr;
+	};
+} // MVT
@@ -0,0 +1,116 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#include "MVT/AllocationTracker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace MVT {
+	namespace {
+		constexpr std::array<const char *, static_cast<size_t>(AllocationCategory::Count)> c_CategoryNames = {
+			"other", "frame", "resources", "streaming", "assets",
+		};
+	}
+
+	std::array<AllocationTracker::Counter, static_cast<size_t>(AllocationCategory::Count)> AllocationTracker::s_Counters{};
+
+	AllocationCounts AllocationTracker::GetCounts(const AllocationCategory category) {
+		const Counter &counter = s_Counters[static_cast<size_t>(category)];
+		return AllocationCounts{.allocations = counter.allocations.load(std::memory_order_relaxed), .bytes = counter.bytes.load(std::memory_order_relaxed)};
+	}
+
+	const char *AllocationTracker::GetName(const AllocationCategory category) {
+		return c_CategoryNames[static_cast<size_t>(category)];
+	}
+} // MVT
+
+#ifdef MVT_TRACK_ALLOCATIONS
+
+// Every form is replaced: the standard library forwards the others to the plain ones, the sanitizers don't.
+
+namespace {
+	void *Allocate(const std::size_t size) noexcept {
+		MVT::AllocationTracker::Record(size);
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	void *AllocateAligned(const std::size_t size, const std::align_val_t alignment) noexcept {
+		MVT::AllocationTracker::Record(size);
+		const auto align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+		return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+		// `aligned_alloc` wants a multiple of the alignment.
+		return std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+#endif
+	}
+
+	void FreeAligned(void *pointer) noexcept {
+#if defined(_WIN32)
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+}
+
+void *operator new(const std::size_t size) {
+	if (void *pointer = Allocate(size)) return pointer;
+	throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size) {
+	if (void *pointer = Allocate(size)) return pointer;
+	throw std::bad_alloc();
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment) {
+	if (void *pointer = AllocateAligned(size, alignment)) return pointer;
+	throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment) {
+	if (void *pointer = AllocateAligned(size, alignment)) return pointer;
+	throw std::bad_alloc();
+}
+
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept { return Allocate(size); }
+
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept { return Allocate(size); }
+
+void *operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept { return AllocateAligned(size, alignment); }
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept { return AllocateAligned(size, alignment); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+
+void operator delete[](void *pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
+
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { FreeAligned(pointer); }
+
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { FreeAligned(pointer); }
+
+#endif
@@ -0,0 +1,164 @@
+//
+// Created by ianpo on 14/01/2026.
+//
+
+#include "MVT/AntiAliasing.hpp"
+
+#include <array>
+
+#include "MVT/Log.hpp"
+
+namespace MVT {
+	struct FxaaParameters {
+		float inverseWidth;
+		float inverseHeight;
+		uint32_t width;
+		uint32_t height;
+		float maxU;
+		float maxV;
+	};
+
+	static constexpr uint32_t c_FxaaGroupSize = 8;
+
+	AntiAliasingPolicy::AntiAliasingPolicy(const AntiAliasingSettings &settings, const vk::SampleCountFlags supportedSamples, const bool fxaaSupported) : m_Settings(settings) {
+		m_Levels.clear();
+		m_Levels.push_back(Level{.mode = AntiAliasingMode::None});
+		if (fxaaSupported) {
+			m_Levels.push_back(Level{.mode = AntiAliasingMode::Fxaa});
+		}
+		// Every supported count up to the configured one, the adaptive policy can fall back on the lower ones.
+		for (const vk::SampleCountFlagBits samples: {vk::SampleCountFlagBits::e2, vk::SampleCountFlagBits::e4, vk::SampleCountFlagBits::e8, vk::SampleCountFlagBits::e16, vk::SampleCountFlagBits::e32, vk::SampleCountFlagBits::e64}) {
+			if (samples > settings.samples) break;
+			if (supportedSamples & samples) {
+				m_Levels.push_back(Level{.mode = AntiAliasingMode::Msaa, .samples = samples});
+			}
+		}
+
+		// The most expensive level of the configured mode, or the closest cheaper one the device has.
+		m_Configured = 0;
+		for (uint32_t i = 0; i < m_Levels.size(); ++i) {
+			if (m_Levels[i].mode <= settings.mode) {
+				m_Configured = i;
+			}
+		}
+		m_Current = m_Configured;
+
+		if (getMode() != settings.mode) {
+			MVT_LOG_WARN(Render, "[AntiAliasing] {} is not supported, falling back to {}.", GetName(settings.mode), GetName(getMode()));
+		}
+		MVT_LOG_INFO(Render, "[AntiAliasing] {} ({} sample(s)){}.", GetName(getMode()), static_cast<uint32_t>(getSamples()), settings.adaptive ? ", adaptive" : "");
+	}
+
+	bool AntiAliasingPolicy::update(const double gpuMilliseconds) {
+		if (!m_Settings.adaptive) return false;
+
+		if (m_Cooldown > 0) {
+			m_Cooldown -= 1;
+			return false;
+		}
+
+		m_Accumulated += gpuMilliseconds;
+		if (++m_Samples < c_SampleWindow) return false;
+
+		const double average = m_Accumulated / m_Samples;
+		m_Accumulated = 0.0;
+		m_Samples = 0;
+
+		uint32_t next = m_Current;
+		if (average > m_Settings.budgetMilliseconds && m_Current > 0) {
+			next = m_Current - 1;
+		}
+		else if (average < m_Settings.budgetMilliseconds * c_HeadroomRatio && m_Current < m_Configured) {
+			next = m_Current + 1;
+		}
+		if (next == m_Current) return false;
+
+		MVT_LOG_INFO(Render, "[AntiAliasing] GPU frame {:.2f} ms for a {:.2f} ms budget: {} ({}) -> {} ({}).", average, m_Settings.budgetMilliseconds, GetName(m_Levels[m_Current].mode), static_cast<uint32_t>(m_Levels[m_Current].samples), GetName(m_Levels[next].mode), static_cast<uint32_t>(m_Levels[next].samples));
+		m_Current = next;
+		m_Cooldown = c_Cooldown;
+		return true;
+	}
+
+	const char *AntiAliasingPolicy::GetName(const AntiAliasingMode mode) {
+		switch (mode) {
+			case AntiAliasingMode::None: return "None";
+			case AntiAliasingMode::Fxaa: return "FXAA";
+			case AntiAliasingMode::Msaa: return "MSAA";
+		}
+		return "Unknown";
+	}
+
+	FxaaPass::FxaaPass(const vk::raii::Device &device, const std::vector<char> &spirv) : m_Device(&device) {
+		const std::array bindings = {
+			vk::DescriptorSetLayoutBinding{.binding = 0, .descriptorType = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute},
+			vk::DescriptorSetLayoutBinding{.binding = 1, .descriptorType = vk::DescriptorType::eStorageImage, .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute},
+		};
+		m_DescriptorSetLayout = vk::raii::DescriptorSetLayout(device, vk::DescriptorSetLayoutCreateInfo{.bindingCount = static_cast<uint32_t>(bindings.size()), .pBindings = bindings.data()});
+
+		const vk::PushConstantRange pushConstantRange{.stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = sizeof(FxaaParameters)};
+		m_PipelineLayout = vk::raii::PipelineLayout(device, vk::PipelineLayoutCreateInfo{
+			                                            .setLayoutCount = 1, .pSetLayouts = &*m_DescriptorSetLayout,
+			                                            .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange
+		                                            });
+
+		const vk::raii::ShaderModule shaderModule(device, vk::ShaderModuleCreateInfo{.codeSize = spirv.size() * sizeof(char), .pCode = reinterpret_cast<const uint32_t *>(spirv.data())});
+		const vk::ComputePipelineCreateInfo pipelineInfo{
+			.stage = {.stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "fxaaMain"},
+			.layout = m_PipelineLayout,
+		};
+		m_Pipeline = vk::raii::Pipeline(device, nullptr, pipelineInfo);
+
+		// The edge search samples between texels, clamped at the borders.
+		m_Sampler = vk::raii::Sampler(device, vk::SamplerCreateInfo{
+			                              .magFilter = vk::Filter::eLinear, .minFilter = vk::Filter::eLinear, .mipmapMode = vk::SamplerMipmapMode::eNearest,
+			                              .addressModeU = vk::SamplerAddressMode::eClampToEdge, .addressModeV = vk::SamplerAddressMode::eClampToEdge, .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+			                              .maxLod = 0.0f,
+		                              });
+
+		constexpr uint32_t setCount = FrameScheduler::c_MaxFramesInFlight;
+		const std::array poolSizes = {
+			vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, setCount},
+			vk::DescriptorPoolSize{vk::DescriptorType::eStorageImage, setCount},
+		};
+		m_Pool = vk::raii::DescriptorPool(device, vk::DescriptorPoolCreateInfo{
+			                                  .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+			                                  .maxSets = setCount,
+			                                  .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+			                                  .pPoolSizes = poolSizes.data()
+		                                  });
+		const std::vector layouts(setCount, *m_DescriptorSetLayout);
+		m_Sets = device.allocateDescriptorSets({.descriptorPool = m_Pool, .descriptorSetCount = setCount, .pSetLayouts = layouts.data()});
+	}
+
+	void FxaaPass::record(const vk::raii::CommandBuffer &commandBuffer, const uint32_t slot, const vk::ImageView source, const vk::ImageView destination, const vk::Extent2D extent, const vk::Extent2D imageExtent) const {
+		// The transient views of the slot may have been rebuilt since its last frame, the set is rewritten every time.
+		const vk::DescriptorImageInfo sourceInfo{.sampler = m_Sampler, .imageView = source, .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal};
+		const vk::DescriptorImageInfo destinationInfo{.imageView = destination, .imageLayout = vk::ImageLayout::eGeneral};
+		const std::array writes = {
+			vk::WriteDescriptorSet{.dstSet = m_Sets[slot], .dstBinding = 0, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eCombinedImageSampler, .pImageInfo = &sourceInfo},
+			vk::WriteDescriptorSet{.dstSet = m_Sets[slot], .dstBinding = 1, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eStorageImage, .pImageInfo = &destinationInfo},
+		};
+		m_Device->updateDescriptorSets(writes, {});
+
+		const FxaaParameters parameters{
+			.inverseWidth = 1.0f / static_cast<float>(imageExtent.width), .inverseHeight = 1.0f / static_cast<float>(imageExtent.height),
+			.width = extent.width, .height = extent.height,
+			.maxU = (static_cast<float>(extent.width) - 0.5f) / static_cast<float>(imageExtent.width),
+			.maxV = (static_cast<float>(extent.height) - 0.5f) / static_cast<float>(imageExtent.height),
+		};
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_Pipeline);
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_PipelineLayout, 0, *m_Sets[slot], nullptr);
+		commandBuffer.pushConstants<FxaaParameters>(m_PipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, parameters);
+		commandBuffer.dispatch((extent.width + c_FxaaGroupSize - 1) / c_FxaaGroupSize, (extent.height + c_FxaaGroupSize - 1) / c_FxaaGroupSize, 1);
+	}
+
+	void FxaaPass::clear() {
+		m_Sets.clear();
+		m_Pool.clear();
+		m_Sampler.clear();
+		m_Pipeline.clear();
+		m_PipelineLayout.clear();
+		m_DescriptorSetLayout.clear();
+		m_Device = nullptr;
+	}
+} // MVT
@@ -6,11 +6,18 @@
 
 
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
 #include <cstdlib>
-#include <iostream>
+#include <format>
+#include <optional>
+#include <sstream>
 #include <stb_image.h>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
@@ -18,6 +25,7 @@
 #include <tiny_obj_loader.h>
 
 #include "MVT/GLM.hpp"
+#include "MVT/Log.hpp"
 #include "MVT/Mesh.hpp"
 #include "MVT/SlangCompiler.hpp"
 #include "MVT/UniformBufferObject.hpp"
@@ -26,26 +34,161 @@
 #define MVT_ALIGN_SIZE(size, alignement) (size % alignment == 0 ? size : ((size / alignment) + 1) * alignment)
 
 namespace MVT {
+	/// Cook a texture kept on the CPU, for the residency to stream it.
+	static Task<void> CookTextureAsync(const TextureCookRequest request, std::optional<Ktx2Texture> &texture) {
+		co_await ScheduleOnJobs{};
+		auto cooked = TextureCooker::Cook(request.source, request.format, request.persist);
+		if (cooked.has_error()) {
+			throw std::runtime_error(cooked.error());
+		}
+		texture.emplace(std::move(cooked.value()));
+	}
+
+	/// `then` once `first` finished, for a load reading from the cache what `first` cooked.
+	static Task<void> AfterAsync(StartedTask<void> &first, Task<void> then) {
+		co_await first.whenReady();
+		co_await then;
+	}
+
+	/// Read and parse an OBJ on a worker, every shape merged in a single mesh.
+	static Task<MeshData> ParseObjAsync(const std::filesystem::path path) {
+		// The parsing continues on the worker that read the file.
+		const std::vector<char> bytes = co_await ReadFileAsync(path);
+		std::istringstream stream(std::string(bytes.data(), bytes.size()));
+
+		MeshData mesh;
+		std::vector<Vertex> &vertices = mesh.vertices;
+		std::vector<uint32_t> &indices = mesh.indices;
+
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+		std::vector<tinyobj::material_t> materials;
+		std::string warn, err;
+
+		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &stream)) {
+			throw std::runtime_error(warn + err);
+		}
+
+		vertices.reserve(attrib.vertices.size());
+		indices.reserve(attrib.vertices.size());
+
+		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+		uniqueVertices.reserve(attrib.vertices.size());
+
+		// We’re going to combine all the faces in the file into a single model, so just iterate over all the shapes
+		for (const auto& shape : shapes) {
+			for (const auto& index : shape.mesh.indices) {
+				Vertex vertex{};
+
+				vertex.pos = {
+					attrib.vertices[3 * index.vertex_index + 0],
+					attrib.vertices[3 * index.vertex_index + 1],
+					attrib.vertices[3 * index.vertex_index + 2]
+				};
+
+				vertex.uv = {
+					attrib.texcoords[2 * index.texcoord_index + 0],
+					1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+				};
+
+				vertex.color = {1.0f, 1.0f, 1.0f};
+
+				if (!uniqueVertices.contains(vertex)) {
+					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+					vertices.push_back(vertex);
+				}
+
+				indices.push_back(uniqueVertices[vertex]);
+			}
+		}
+
+		co_return mesh;
+	}
+
+	/// Record `task` in `trace`, from when it is awaited to when it finished.
+	template<typename T>
+	static Task<T> TraceAsync(StartupTrace &trace, const char *name, Task<T> task) {
+		const StartupTrace::Clock::time_point begin = StartupTrace::Clock::now();
+		if constexpr (std::is_void_v<T>) {
+			co_await task;
+			trace.record(name, begin, StartupTrace::Clock::now());
+		}
+		else {
+			T result = co_await task;
+			trace.record(name, begin, StartupTrace::Clock::now());
+			co_return result;
+		}
+	}
+
 	static VKAPI_ATTR vk::Bool32 VKAPI_CALL debugCallback(vk::DebugUtilsMessageSeverityFlagBitsEXT severity, vk::DebugUtilsMessageTypeFlagsEXT type, const vk::DebugUtilsMessengerCallbackDataEXT *pCallbackData, void *) {
-		if (severity >= vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo) {
-			std::cerr << "validation layer: type " << to_string(type) << " msg: " << pCallbackData->pMessage << std::endl;
+		spdlog::level::level_enum level = spdlog::level::trace;
+		switch (severity) {
+			case vk::DebugUtilsMessageSeverityFlagBitsEXT::eError: level = spdlog::level::err;
+				break;
+			case vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning: level = spdlog::level::warn;
+				break;
+			case vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo: level = spdlog::level::debug;
+				break;
+			default: break;
 		}
+		spdlog::logger *logger = Log::Get(LogCategory::Validation);
+		if (!logger->should_log(level)) return vk::False;
 
+		// The same message every frame is only logged a few times per second. Limited per message id, shared on collisions.
+		static std::array<LogRateLimiter, 64> s_RateLimiters;
+		uint32_t suppressed = 0;
+		if (!s_RateLimiters[static_cast<uint32_t>(pCallbackData->messageIdNumber) % s_RateLimiters.size()].allow(suppressed)) return vk::False;
+
+		if (suppressed > 0) {
+			logger->log(level, "{} similar message(s) suppressed.", suppressed);
+		}
+		logger->log(level, "{} {}", to_string(type), pCallbackData->pMessage);
 		return vk::False;
 	}
 
-	Application::Application() {
-		initWindow("Modern Vulkan");
-		initVulkan("Modern Vulkan");
-	}
+	Application::Application() = default;
 
-	Application::~Application() = default;
+	Application::~Application() {
+		// A joinable thread would terminate the process.
+		stopRenderThread();
+	}
 
 	void Application::run() {
+		// Not in the constructor: the settings given in between apply at the initialization.
+		startupTrace.start();
+		{
+			auto phase = startupTrace.phase("Window");
+			initWindow("Modern Vulkan");
+		}
+		initVulkan("Modern Vulkan");
 		mainLoop();
 		cleanup();
 	}
 
+	void Application::setRecordingThreads(const uint32_t count) {
+		recordingThreads = count;
+		if (*device) {
+			// The pending frames execute secondaries allocated from the current pools.
+			deletionQueue.retire(std::move(parallelRecorder), frameScheduler.getLastSubmittedValue());
+			createParallelRecorder();
+		}
+	}
+
+	void Application::setFramesInFlight(const uint32_t count) {
+		framesInFlight = std::clamp<uint32_t>(count, 1, MAX_FRAMES_IN_FLIGHT);
+		if (frameScheduler.isValid()) {
+			frameScheduler.setFramesInFlight(framesInFlight);
+		}
+		MVT_LOG_INFO(Vulkan, "{} frame(s) in flight.", framesInFlight);
+	}
+
+	void Application::setAllocationCheck(const uint32_t frames) {
+		if constexpr (!AllocationTracker::c_Enabled) {
+			throw std::runtime_error("[Allocations] Checking the allocations needs a build with MVT_TRACK_ALLOCATIONS.");
+		}
+		allocationCheckFrames = frames;
+	}
+
 	void Application::initWindow(const char *appName, WindowParameters parameters) {
 		// We initialize SDL and create a window with it.
 		SDL_Init(SDL_INIT_VIDEO);
@@ -61,49 +204,121 @@ namespace MVT {
 	}
 
 	void Application::initVulkan(const char *appName) {
-		createInstance(appName);
-		setupDebugMessenger();
-		createSurface();
-		pickPhysicalDevice();
-		createLogicalDevice();
-		createVMA();
-
-		createSwapChain();
-		createSwapChainViews();
-		createColorResources();
-		createDepthResources();
+		const char *modelPath = "EngineAssets/Models/viking_room.obj";
+		std::array modelTextures = {"EngineAssets/Textures/viking_room.png"};
+
+		// Neither needs a device: the workers start on them while the main thread creates it.
+		prefetchShaders();
+		StartedTask<MeshData> modelGeometry{TraceAsync(startupTrace, "Mesh parse", ParseObjAsync(modelPath))};
+
+		{
+			auto phase = startupTrace.phase("Device");
+			createInstance(appName);
+			setupDebugMessenger();
+			createSurface();
+			pickPhysicalDevice();
+			createLogicalDevice();
+			createVMA();
+		}
 
-		createDescriptorSetLayout();
-		createGraphicsPipeline();
+		// The texture formats depend on the device features. Only the CPU work starts here: the steps of the model
+		// waiting on this thread are resumed once everything they use exists, when it is joined.
+		std::optional<Ktx2Texture> defaultCooked;
+		std::optional<StartedTask<void>> defaultCook;
+		const vk::Format defaultFormat = selectTextureFormat(TextureUsage::Color);
+		if (TextureCooker::GetBlockFormat(defaultFormat).has_value()) {
+			defaultCook.emplace(TraceAsync(startupTrace, "Default texture cook", CookTextureAsync(TextureCookRequest{.source = c_DefaultTexturePath, .format = defaultFormat, .persist = true}, defaultCooked)));
+		}
+		// The model shares the default texture: its load waits for this cook instead of running the same one.
+		StartedTask<void> model{loadModelAsync(std::move(modelGeometry), modelTextures.data(), modelTextures.size(), defaultCook ? &*defaultCook : nullptr)};
+
+		{
+			auto phase = startupTrace.phase("Swapchain");
+			createSwapChain();
+			createSwapChainViews();
+			createRenderGraph();
+			createAntiAliasing();
+			createDynamicResolution();
+		}
 
-		createCommandPool();
-		createCommandBuffer();
-		createSyncObjects();
+		{
+			auto phase = startupTrace.phase("Pipelines");
+			createDescriptorSetLayout();
+			createBindlessTable();
+			createGraphicsPipeline();
+		}
 
-		createTextureImage();
+		{
+			auto phase = startupTrace.phase("Frame resources");
+			createCommandPool();
+			createCommandBuffer();
+			createSyncObjects();
+			createParallelRecorder();
+			createStaticDraws();
+			createMipGenerators();
+		}
 
-		std::array textures = {"EngineAssets/Textures/viking_room.png"};
+		{
+			auto phase = startupTrace.phase("Default texture");
+			if (defaultCook) {
+				defaultCook->join();
+			}
+			createTextureImage(defaultCooked);
+			defaultMaterial = createMaterial(texture);
+			createTextureResidency();
+		}
 
-		loadModel("EngineAssets/Models/viking_room.obj", textures.data(), textures.size());
+		{
+			auto phase = startupTrace.phase("Model");
+			joinLoad(model);
+		}
 
-		createVertexBuffer(two_rectangle_vertices);
-		createIndexBuffer(two_rectangle_indices);
-		createUniformBuffers();
-		createDescriptorPool();
-		createDescriptorSets();
+		{
+			auto phase = startupTrace.phase("Buffers");
+			createVertexBuffer(two_rectangle_vertices);
+			createIndexBuffer(two_rectangle_indices);
+			createUniformBuffers();
+			createDescriptorPool();
+			createDescriptorSets();
+		}
 
-		// createCommandBuffer();
-		// createSyncObjects();
+		// The shaders the device did not need.
+		startupSpirv.clear();
+		startupTrace.report("Initialized");
 	}
 
 	void Application::mainLoop() {
+		// Polled: an editor saving by rename makes the file briefly missing, which keeps the previous date.
 		const auto shaderFile = std::filesystem::path{"./EngineAssets/Shaders/mesh.slang"};
-		auto date = std::filesystem::last_write_time(shaderFile);
+		std::error_code dateError;
+		auto date = std::filesystem::last_write_time(shaderFile, dateError);
+
+		// From here on, only the render thread uses Vulkan. This thread handles the events and produces the packets.
+		publishFramePacket();
+		renderThreadStop.store(false, std::memory_order_relaxed);
+		renderThread = std::thread(&Application::renderLoop, this);
+
+		// Whatever leaves this function, the render thread stops before the members it uses are destroyed.
+		struct RenderThreadStopper {
+			Application *application;
+
+			~RenderThreadStopper() { application->stopRenderThread(); }
+		} stopper{this};
+
+		auto nextTick = std::chrono::steady_clock::now();
 		while (!m_ShouldClose) {
+			// Animated, wake up for the next simulation tick. Otherwise block until an event comes, the timeout keeps
+			// the hot reload alive.
+			const bool ticking = animate && !windowMinimized;
+			const auto untilTick = std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - std::chrono::steady_clock::now()).count();
+			const auto timeout = static_cast<int32_t>(ticking ? std::clamp<int64_t>(untilTick, 0, c_IdleEventTimeoutMs) : c_IdleEventTimeoutMs);
+			bool dirty = false;
+
 			// Handle SDL Events
 			{
 				SDL_Event e;
-				while (SDL_PollEvent(&e) != 0) {
+				bool hasEvent = SDL_WaitEventTimeout(&e, timeout);
+				for (; hasEvent; hasEvent = SDL_PollEvent(&e)) {
 					// ImGui_ImplSDL3_ProcessEvent(&e);
 
 					switch (e.type) {
@@ -114,19 +329,35 @@ namespace MVT {
 
 						case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
 						case SDL_EVENT_WINDOW_METAL_VIEW_RESIZED: {
-							framebufferResized = true;
+							framebufferResized.store(true, std::memory_order_relaxed);
 							windowMinimized = e.window.data1 == 0 || e.window.data2 == 0;
+							dirty = true;
 						}
 						break;
 						case SDL_EVENT_WINDOW_MINIMIZED: {
 							windowMinimized = true;
-							framebufferResized = true;
+							framebufferResized.store(true, std::memory_order_relaxed);
+							dirty = true;
+						}
+						break;
+						case SDL_EVENT_KEY_DOWN: {
+							// 1 to 4: frames in flight, applied by the render thread.
+							if (e.key.key >= SDLK_1 && e.key.key <= SDLK_4) {
+								pendingFramesInFlight.store(static_cast<uint32_t>(e.key.key - SDLK_1) + 1, std::memory_order_relaxed);
+							}
+							dirty = true;
 						}
 						break;
 						case SDL_EVENT_WINDOW_RESTORED:
 						case SDL_EVENT_WINDOW_MAXIMIZED: {
-							windowMinimized = true;
-							framebufferResized = true;
+							windowMinimized = false;
+							framebufferResized.store(true, std::memory_order_relaxed);
+							dirty = true;
+						}
+						break;
+						case SDL_EVENT_WINDOW_EXPOSED:
+						case SDL_EVENT_WINDOW_SHOWN: {
+							dirty = true;
 						}
 						break;
 						default: {
@@ -136,52 +367,219 @@ namespace MVT {
 				}
 			}
 
-			auto newDate = std::filesystem::last_write_time(shaderFile);
-			if (newDate > date) {
-				device.waitIdle();
-				createGraphicsPipeline();
-				std::cout << "Hot Reload Shader" << std::endl;
+			const auto newDate = std::filesystem::last_write_time(shaderFile, dateError);
+			if (!dateError && newDate > date) {
+				shaderReloadRequested.store(true, std::memory_order_relaxed);
 				date = newDate;
+				dirty = true;
 			}
 
-			if (!windowMinimized) {
-				// Rest of the code
+			if (ticking && std::chrono::steady_clock::now() >= nextTick) {
+				// A late tick doesn't try to catch up.
+				nextTick = std::max(nextTick + c_SimulationStep, std::chrono::steady_clock::now());
+				dirty = true;
+			}
+
+			// The packet publish is a release: the atomics written above are visible to the render thread with it.
+			if (dirty) {
+				publishFramePacket();
+			}
+		}
+
+		stopRenderThread();
+		if (renderThreadError) {
+			std::rethrow_exception(renderThreadError);
+		}
+	}
+
+	void Application::stopRenderThread() {
+		if (!renderThread.joinable()) return;
+
+		renderThreadStop.store(true, std::memory_order_release);
+		frameMailbox.wake();
+		renderThread.join();
+	}
+
+	void Application::publishFramePacket() {
+		const auto now = std::chrono::steady_clock::now();
+		// The animation only advances while enabled, and resumes where it stopped.
+		if (animate && lastAnimationTime != std::chrono::steady_clock::time_point{}) {
+			animationSeconds += std::chrono::duration<float, std::chrono::seconds::period>(now - lastAnimationTime).count();
+		}
+		lastAnimationTime = now;
+
+		const auto [width, height] = GetFramebufferSize();
+		FramePacket &packet = frameMailbox.getBack();
+		packet = FramePacket{
+			.sequence = ++publishedPackets,
+			.published = now,
+			.cameraPosition = cameraPosition,
+			.cameraFovDegrees = cameraFovDegrees,
+			.sceneModel = rotate(glm::mat4(1.0f), animationSeconds * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
+			.framebufferExtent = {static_cast<uint32_t>(std::max(width, 0)), static_cast<uint32_t>(std::max(height, 0))},
+			.minimized = windowMinimized,
+			.animating = animate,
+		};
+		frameMailbox.publish();
+	}
+
+	void Application::renderLoop() {
+		// What the render thread allocates outside of the scopes of the other categories is a frame allocation.
+		const AllocationScope frameScope{AllocationCategory::Frame};
+		try {
+			uint64_t consumedSequence = 0;
+			while (!renderThreadStop.load(std::memory_order_acquire)) {
+				const uint64_t sequence = frameMailbox.getSequence();
+				if (frameMailbox.consume()) {
+					const FramePacket &packet = frameMailbox.getFront();
+					const double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - packet.published).count();
+					packetLatencyMilliseconds += latency;
+					packetLatencyMaxMilliseconds = std::max(packetLatencyMaxMilliseconds, latency);
+					packetsConsumed += 1;
+					packetsSkipped += consumedSequence == 0 ? 0 : packet.sequence - consumedSequence - 1;
+					consumedSequence = packet.sequence;
+					redrawRequested = true;
+
+					if (packetsConsumed == c_RecordingReportInterval) {
+						MVT_LOG_INFO(Render, "[RenderThread] Packet latency {:.3f} ms average, {:.3f} ms max, {} packet(s) replaced before being drawn.", packetLatencyMilliseconds / packetsConsumed, packetLatencyMaxMilliseconds, packetsSkipped);
+						packetLatencyMilliseconds = 0.0;
+						packetLatencyMaxMilliseconds = 0.0;
+						packetsConsumed = 0;
+						packetsSkipped = 0;
+					}
+				}
+
+				if (const uint32_t count = pendingFramesInFlight.exchange(0, std::memory_order_relaxed)) {
+					const AllocationScope scope{AllocationCategory::Resources};
+					setFramesInFlight(count);
+				}
+				if (shaderReloadRequested.exchange(false, std::memory_order_relaxed)) {
+					const AllocationScope scope{AllocationCategory::Resources};
+					createGraphicsPipeline();
+					MVT_LOG_INFO(Shaders, "Hot Reload Shader");
+				}
+
+				// Nothing new to show: sleep until the next packet.
+				const FramePacket &packet = frameMailbox.getFront();
+				if (packet.minimized || (renderOnDemand && !redrawRequested && !packet.animating)) {
+					frameMailbox.wait(sequence);
+					continue;
+				}
+
+				// Cleared before drawing: the frame itself may ask for another one (swapchain recreated, mips streamed in).
+				redrawRequested = false;
+				waitForFrameCap();
+				const AllocationCounts before = AllocationTracker::GetCounts(AllocationCategory::Frame);
 				drawFrame();
+				trackFrameAllocations(before);
+				if (!firstFrameReported) {
+					firstFrameReported = true;
+					startupTrace.report("First frame");
+				}
 			}
-			else {
-				device.waitIdle();
-				// recreateSwapChain();
+		} catch (...) {
+			renderThreadError = std::current_exception();
+			SDL_Event quit{};
+			quit.type = SDL_EVENT_QUIT;
+			SDL_PushEvent(&quit);
+		}
+	}
+
+	void Application::waitForFrameCap() {
+		if (frameRateCap == 0) return;
+
+		using Clock = std::chrono::steady_clock;
+		const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRateCap));
+		const Clock::time_point now = Clock::now();
+		if (nextFrameTime <= now) {
+			// Late, or the first capped frame: start a new cadence instead of catching up.
+			nextFrameTime = now + period;
+			return;
+		}
+
+		// The OS may oversleep by a scheduler tick: sleep until close to the deadline and yield the rest.
+		if (nextFrameTime - now > c_FrameCapSpinTime) {
+			std::this_thread::sleep_until(nextFrameTime - c_FrameCapSpinTime);
+		}
+		while (Clock::now() < nextFrameTime) {
+			std::this_thread::yield();
+		}
+		nextFrameTime += period;
+	}
+
+	void Application::trackFrameAllocations(const AllocationCounts &before) {
+		if constexpr (!AllocationTracker::c_Enabled) return;
+
+		trackedFrames += 1;
+		if (trackedFrames > c_AllocationWarmupFrames) {
+			const AllocationCounts after = AllocationTracker::GetCounts(AllocationCategory::Frame);
+			if (after.allocations != before.allocations) {
+				if (allocationCheckFrames != 0) {
+					throw std::runtime_error(std::format("[Allocations] Frame {} allocated {} time(s), {} byte(s), in its steady state.", trackedFrames, after.allocations - before.allocations, after.bytes - before.bytes));
+				}
+				MVT_LOG_LIMITED(WARN, Render, "[Allocations] Frame {} allocated {} time(s), {} byte(s), in its steady state.", trackedFrames, after.allocations - before.allocations, after.bytes - before.bytes);
+			}
+		}
+
+		if (trackedFrames % c_RecordingReportInterval == 0) {
+			for (size_t i = 0; i < allocationReportStart.size(); ++i) {
+				const auto category = static_cast<AllocationCategory>(i);
+				const AllocationCounts counts = AllocationTracker::GetCounts(category);
+				MVT_LOG_INFO(Core, "[Allocations] {}: {} allocation(s), {} KiB over the last {} frames.", AllocationTracker::GetName(category), counts.allocations - allocationReportStart[i].allocations, (counts.bytes - allocationReportStart[i].bytes) / 1024, c_RecordingReportInterval);
+				allocationReportStart[i] = counts;
 			}
 		}
+
+		if (allocationCheckFrames != 0 && trackedFrames == c_AllocationWarmupFrames + allocationCheckFrames) {
+			MVT_LOG_INFO(Core, "[Allocations] {} steady state frame(s) drawn without allocating.", allocationCheckFrames);
+			allocationCheckFrames = 0;
+			SDL_Event quit{};
+			quit.type = SDL_EVENT_QUIT;
+			SDL_PushEvent(&quit);
+		}
 	}
 
 	void Application::cleanup() {
 		if (*device) {
 			device.waitIdle();
 		}
+		deletionQueue.flush();
 
 		descriptorSets.clear();
 
 		descriptorPool.clear();
 
-		uniformBuffersMemory.clear();
-		uniformBuffersMapped.clear();
-		uniformBuffers.clear();
+		if (materialsMapped) {
+			materialBufferMemory.unmapMemory();
+			materialsMapped = nullptr;
+		}
+		materialBuffer.clear();
+		materialBufferMemory.clear();
+		textureResidency.clear();
+		streamingSampler.clear();
+		bindlessTable.clear();
+
+		frameAllocator.clear();
 
 		indexBufferMemory.clear();
 		indexBuffer.clear();
 
 		vertexBufferMemory.clear();
 		vertexBuffer.clear();
+		positionBufferMemory.clear();
+		positionBuffer.clear();
 
 		m_Meshes.clear();
 
 		presentCompleteSemaphores.clear();
 		renderFinishedSemaphores.clear();
-		inFlightFences.clear();
-		transferFence.clear();
+		frameScheduler.clear();
 
 		texture.clear();
+		mipDownsampler.clear();
+		mipTimer.clear();
+		fxaaPass.clear();
+		frameTimer.clear();
 		// textureSampler.clear();
 		// textureView.clear();
 		// textureImageMemory.clear();
@@ -189,24 +587,25 @@ namespace MVT {
 
 
 		commandBuffers.clear();
+		parallelRecorder.reset();
+		for (StaticDraws &cache: staticDraws) {
+			cache.commandBuffer.clear();
+			cache.depthCommandBuffer.clear();
+			cache.pool.clear();
+		}
 		// transferCommands.clear();
 
 		commandPool.clear();
 		//transfersPool.clear();
 
 		graphicsPipeline.clear();
+		depthPrepassPipeline.clear();
 
 		pipelineLayout.clear();
 
 		descriptorSetLayout.clear();
 
-		colorImages.clear();
-		colorImageMemories.clear();
-		colorImageViews.clear();
-
-		depthImageViews.clear();
-		depthImageMemory.clear();
-		depthImages.clear();
+		renderGraph.clear();
 
 		cleanupSwapChain();
 
@@ -236,81 +635,96 @@ namespace MVT {
 
 	void Application::drawFrame() {
 		if (!*graphicsPipeline) {
-			std::cerr << "No Graphics Pipeline available." << std::endl;
+			MVT_LOG_LIMITED(ERROR, Render, "No Graphics Pipeline available.");
 			return;
 		}
 
-		while (vk::Result::eTimeout == device.waitForFences(*inFlightFences[currentFrame], vk::True, UINT64_MAX)) {
-			std::cerr << "Waiting for 'inFlightFences' timed out. Waiting again." << std::endl;
+		// Waits on the timeline until the slot, and the frame `framesInFlight` behind, completed.
+		currentFrame = frameScheduler.beginFrame();
+		frameCount = frameScheduler.getFrameCount() - 1;
+		frameScratch.reset();
+		releaseRetiredSwapChains();
+		deletionQueue.collect(frameScheduler.getCompletedValue());
+		// Loads waiting on the render thread continue between frames.
+		{
+			const AllocationScope scope{AllocationCategory::Assets};
+			gpuResumer.resume(frameScheduler.getCompletedValue());
 		}
 
-		auto [result, imageIndex] = swapChain.acquireNextImage(UINT64_MAX, *presentCompleteSemaphores[semaphoreIndex], nullptr);
+		// The raii wrappers throw on an out of date swapchain, an expected result here: call the plain functions.
+		uint32_t imageIndex = 0;
+		vk::Result result = (*device).acquireNextImageKHR(*swapChain, UINT64_MAX, *presentCompleteSemaphores[currentFrame], nullptr, &imageIndex, *device.getDispatcher());
 		switch (result) {
 			case vk::Result::eSuccess: {
 				break;
 			}
 			case vk::Result::eSuboptimalKHR: {
-				framebufferResized = true;
+				framebufferResized.store(true, std::memory_order_relaxed);
 				break;
 			}
 			case vk::Result::eErrorOutOfDateKHR: {
+				// Nothing was acquired, the frame is dropped.
+				const AllocationScope scope{AllocationCategory::Resources};
 				recreateSwapChain();
-				break;
+				requestRedraw();
+				return;
 			}
 			default:
 				throw std::runtime_error("[Vulkan] Failed to acquire swap chain image!");
 				break;
 		}
 
-		device.resetFences(*inFlightFences[currentFrame]);
+		// What the completed frames sampled can go.
+		if (const uint64_t completedFrames = frameScheduler.getCompletedFrameCount(); completedFrames > 0) {
+			textureResidency.retire(completedFrames - 1);
+		}
+		if (textureStreaming) {
+			updateTextureStreaming();
+		}
+
+		// The slot's region was retired with its previous frame.
+		frameAllocator.beginFrame(currentFrame);
+		updateUniformBuffer();
+
 		commandBuffers[currentFrame].reset();
 		recordCommandBuffer(imageIndex);
 
-		updateUniformBuffer(currentFrame);
+		uploadMaterials(currentFrame);
 
-		vk::PipelineStageFlags waitDestinationStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput);
-		const vk::SubmitInfo submitInfo{
-			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = &*presentCompleteSemaphores[semaphoreIndex],
-			.pWaitDstStageMask = &waitDestinationStageMask,
-			.commandBufferCount = 1,
-			.pCommandBuffers = &*commandBuffers[currentFrame],
-			.signalSemaphoreCount = 1,
-			.pSignalSemaphores = &*renderFinishedSemaphores[semaphoreIndex],
-		};
-		graphicsQueue.submit(submitInfo, *inFlightFences[currentFrame]);
+		const vk::SemaphoreSubmitInfo waitInfo{.semaphore = presentCompleteSemaphores[currentFrame], .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput};
+		const vk::SemaphoreSubmitInfo signalInfo{.semaphore = renderFinishedSemaphores[imageIndex], .stageMask = vk::PipelineStageFlagBits2::eAllCommands};
+		const vk::CommandBufferSubmitInfo commandBufferInfo{.commandBuffer = commandBuffers[currentFrame]};
+		frameScheduler.submitFrame(*graphicsQueue, {&commandBufferInfo, 1}, {&waitInfo, 1}, {&signalInfo, 1});
 
 		// const vk::PresentInfoKHR presentInfoKHR( **renderFinishedSemaphore, **swapChain, imageIndex );
 		const vk::PresentInfoKHR presentInfoKHR{
 			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = &*renderFinishedSemaphores[semaphoreIndex],
+			.pWaitSemaphores = &*renderFinishedSemaphores[imageIndex],
 			.swapchainCount = 1,
 			.pSwapchains = &*swapChain,
 			.pImageIndices = &imageIndex,
 			.pResults = nullptr,
 		};
-		result = presentQueue.presentKHR(presentInfoKHR);
+		result = (*presentQueue).presentKHR(&presentInfoKHR, *presentQueue.getDispatcher());
 
 		switch (result) {
 			case vk::Result::eSuccess:
 				break;
 			case vk::Result::eSuboptimalKHR:
 			case vk::Result::eErrorOutOfDateKHR: {
-				framebufferResized = true;
+				framebufferResized.store(true, std::memory_order_relaxed);
 				break;
 			}
 			default:
 				break; // an unexpected result is returned!
 		}
 
-		if (framebufferResized) {
-			framebufferResized = false;
+		if (framebufferResized.exchange(false, std::memory_order_relaxed)) {
+			const AllocationScope scope{AllocationCategory::Resources};
 			recreateSwapChain();
+			requestRedraw();
 		}
 
-		semaphoreIndex = (semaphoreIndex + 1) % presentCompleteSemaphores.size();
-		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
-		frameCount += 1;
 	}
 
 	void Application::createInstance(const char *appName) {
@@ -363,12 +777,10 @@ namespace MVT {
 			// 	auto [result, exts] = context.enumerateInstanceExtensionProperties();
 			// 	std::cout << "available extensions:\n";
 			auto exts = context.enumerateInstanceExtensionProperties();
-			std::cout << "available vulkan extensions:\n";
-
+			MVT_LOG_DEBUG(Vulkan, "{} available instance extension(s):", exts.size());
 			for (const auto &extension: exts) {
-				std::cout << '\t' << extension.extensionName << '\n';
+				MVT_LOG_DEBUG(Vulkan, "\t{}", &extension.extensionName[0]);
 			}
-			std::cout << std::endl;
 		}
 	}
 
@@ -400,13 +812,20 @@ namespace MVT {
 			return false;
 		}
 
+		// Application can't function without bindless resources
+		const auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>().get<vk::PhysicalDeviceVulkan12Features>();
+		if (!features12.descriptorIndexing || !features12.runtimeDescriptorArray || !features12.descriptorBindingPartiallyBound ||
+			!features12.descriptorBindingSampledImageUpdateAfterBind || !features12.descriptorBindingStorageBufferUpdateAfterBind ||
+			!features12.descriptorBindingUpdateUnusedWhilePending || !features12.timelineSemaphore ||
+			!deviceFeatures.shaderSampledImageArrayDynamicIndexing || !deviceFeatures.shaderStorageBufferArrayDynamicIndexing) {
+			return false;
+		}
+
 		// // Application can't function without Anisotropy Sampler
 		if (deviceFeatures.samplerAnisotropy) {
 			score += deviceProperties.limits.maxSamplerAnisotropy * 10;
 		}
 
-		score *= static_cast<uint32_t>(getMaxUsableSampleCount(device));
-
 		// Maximum possible size of textures affects graphics quality
 		score += deviceProperties.limits.maxImageDimension2D;
 
@@ -438,9 +857,8 @@ namespace MVT {
 		// Check if the best candidate is suitable at all
 		if (candidates.rbegin()->first > 0) {
 			physicalDevice = candidates.rbegin()->second;
-			msaaSamples = getMaxUsableSampleCount();
 			const auto properties = physicalDevice.getProperties();
-			std::cout << "Select GPU '" << &properties.deviceName[0] << "'" << std::endl;
+			MVT_LOG_INFO(Vulkan, "Select GPU '{}'", &properties.deviceName[0]);
 		}
 		else {
 			throw std::runtime_error("[Vulkan] failed to find a suitable GPU!");
@@ -528,10 +946,27 @@ namespace MVT {
 		// }
 
 		vk::PhysicalDeviceFeatures physicalDeviceFeatures = physicalDevice.getFeatures();
+		textureCompressionBC = physicalDeviceFeatures.textureCompressionBC;
+		// The compute downsampler writes (and reads back) typeless storage images, indexed in an array.
+		storageImageWithoutFormat = physicalDeviceFeatures.shaderStorageImageReadWithoutFormat && physicalDeviceFeatures.shaderStorageImageWriteWithoutFormat && physicalDeviceFeatures.shaderStorageImageArrayDynamicIndexing;
 
 		// Create a chain of feature structures
-		vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain = {
-			{.features = {.samplerAnisotropy = physicalDeviceFeatures.samplerAnisotropy}}, // vk::PhysicalDeviceFeatures2 (empty for now)
+		vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain = {
+			{
+				.features = {
+					.samplerAnisotropy = physicalDeviceFeatures.samplerAnisotropy, .textureCompressionBC = physicalDeviceFeatures.textureCompressionBC,
+					.shaderStorageImageReadWithoutFormat = storageImageWithoutFormat, .shaderStorageImageWriteWithoutFormat = storageImageWithoutFormat,
+					.shaderSampledImageArrayDynamicIndexing = true, .shaderStorageBufferArrayDynamicIndexing = true,
+					.shaderStorageImageArrayDynamicIndexing = storageImageWithoutFormat
+				}
+			}, // vk::PhysicalDeviceFeatures2
+			{
+				.descriptorIndexing = true,
+				.descriptorBindingSampledImageUpdateAfterBind = true, .descriptorBindingStorageBufferUpdateAfterBind = true,
+				.descriptorBindingUpdateUnusedWhilePending = true, .descriptorBindingPartiallyBound = true,
+				.runtimeDescriptorArray = true,
+				.timelineSemaphore = true,
+			}, // Bindless resources and timeline semaphores from Vulkan 1.2
 			{.synchronization2 = true, .dynamicRendering = true,}, // Enable dynamic rendering from Vulkan 1.3
 			{.extendedDynamicState = true} // Enable extended dynamic state from the extension
 		};
@@ -582,7 +1017,7 @@ namespace MVT {
 		surface = {instance, tmpSurface, nullptr};
 	}
 
-	void Application::createSwapChain() {
+	void Application::createSwapChain(const vk::SwapchainKHR oldSwapchain) {
 		auto surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(surface);
 		std::vector<vk::SurfaceFormatKHR> availableFormats = physicalDevice.getSurfaceFormatsKHR(surface);
 		std::vector<vk::PresentModeKHR> availablePresentModes = physicalDevice.getSurfacePresentModesKHR(surface);
@@ -602,16 +1037,23 @@ namespace MVT {
 			imageCount = surfaceCapabilities.maxImageCount;
 		}
 
+		// The FXAA path blits its output in the swapchain image.
+		vk::ImageUsageFlags imageUsage = vk::ImageUsageFlagBits::eColorAttachment;
+		swapChainTransferDst = static_cast<bool>(surfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferDst);
+		if (swapChainTransferDst) {
+			imageUsage |= vk::ImageUsageFlagBits::eTransferDst;
+		}
+
 		vk::SwapchainCreateInfoKHR swapChainCreateInfo{
 			.flags = vk::SwapchainCreateFlagsKHR(),
 			.surface = surface,
 			.minImageCount = minImageCount,
 			.imageFormat = swapChainSurfaceFormat.format, .imageColorSpace = swapChainSurfaceFormat.colorSpace,
 			.imageExtent = swapChainExtent, .imageArrayLayers = 1,
-			.imageUsage = vk::ImageUsageFlagBits::eColorAttachment, .imageSharingMode = vk::SharingMode::eExclusive,
+			.imageUsage = imageUsage, .imageSharingMode = vk::SharingMode::eExclusive,
 			.preTransform = surfaceCapabilities.currentTransform, .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
 			.presentMode = chooseSwapPresentMode(physicalDevice.getSurfacePresentModesKHR(surface)),
-			.clipped = true, .oldSwapchain = nullptr
+			.clipped = true, .oldSwapchain = oldSwapchain
 		};
 
 		uint32_t queueFamilyIndices[] = {graphicsFamily, presentFamily};
@@ -627,6 +1069,7 @@ namespace MVT {
 			swapChainCreateInfo.pQueueFamilyIndices = nullptr; // Optional
 		}
 		swapChain = vk::raii::SwapchainKHR(device, swapChainCreateInfo);
+		swapChainVersion += 1;
 		swapChainImages = swapChain.getImages();
 
 		this->swapChainImageFormat = swapChainSurfaceFormat.format;
@@ -644,8 +1087,9 @@ namespace MVT {
 
 	void Application::createDescriptorSetLayout() {
 		std::array bindings{
-			vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex, nullptr),
-			vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment, nullptr),
+			vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex, nullptr),
+			vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment, nullptr),
+			vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex, nullptr),
 		};
 
 		vk::DescriptorSetLayoutCreateInfo layoutInfo{
@@ -655,12 +1099,22 @@ namespace MVT {
 		descriptorSetLayout = vk::raii::DescriptorSetLayout(device, layoutInfo);
 	}
 
+	void Application::createBindlessTable() {
+		bindlessTable = BindlessTable(device, physicalDevice);
+
+		// One material table per frame in flight, persistently mapped and bound in set 0.
+		constexpr vk::DeviceSize size = sizeof(GpuMaterial) * c_MaxMaterials * MAX_FRAMES_IN_FLIGHT;
+		createBuffer(size, vk::BufferUsageFlagBits::eStorageBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, materialBuffer, materialBufferMemory);
+		materialsMapped = static_cast<GpuMaterial *>(materialBufferMemory.mapMemory(0, size));
+		uploadedMaterialsVersion.fill(~0ull);
+	}
+
 	void Application::createGraphicsPipeline() {
 		//Basic code, we could upgrade it with an all-in-one function that seatch and find every function name in the slang shader available.
 
-		auto spirvCode = SlangCompiler::s_OneShotCompile("mesh");
+		auto spirvCode = compileShader("mesh");
 		if (spirvCode.has_error()) {
-			std::cerr << "Fail to compile mesh.slang" << std::endl;
+			MVT_LOG_ERROR(Shaders, "Fail to compile mesh.slang: {}", spirvCode.error());
 			return;
 		}
 
@@ -686,8 +1140,10 @@ namespace MVT {
 
 		vk::PipelineRasterizationStateCreateInfo rasterizer{
 			.depthClampEnable = vk::False, .rasterizerDiscardEnable = vk::False,
+			// With a right-handed view and the flipped Y, counter-clockwise meshes stay counter-clockwise on screen. The
+			// left-handed view mirrors X on top of that: they end up clockwise.
 			.polygonMode = vk::PolygonMode::eFill, .cullMode = vk::CullModeFlagBits::eNone,
-			.frontFace = vk::FrontFace::eCounterClockwise, .depthBiasEnable = vk::False,
+			.frontFace = vk::FrontFace::eClockwise, .depthBiasEnable = vk::False,
 			.depthBiasSlopeFactor = 1.0f, .lineWidth = 1.0f
 		};
 
@@ -717,14 +1173,26 @@ namespace MVT {
 
 		vk::PipelineColorBlendStateCreateInfo colorBlending{.logicOpEnable = vk::False, .logicOp = vk::LogicOp::eCopy, .attachmentCount = 1, .pAttachments = &colorBlendAttachment};
 
+		// Culling and depth states are set per draw: they depend on the material and on the depth pre-pass.
 		std::vector dynamicStates = {
 			vk::DynamicState::eViewport,
-			vk::DynamicState::eScissor
+			vk::DynamicState::eScissor,
+			vk::DynamicState::eCullMode,
+			vk::DynamicState::eDepthCompareOp,
+			vk::DynamicState::eDepthWriteEnable,
 		};
 
 		vk::PipelineDynamicStateCreateInfo dynamicState{.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()), .pDynamicStates = dynamicStates.data()};
 
-		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{.setLayoutCount = 1, .pSetLayouts = &*descriptorSetLayout, .pushConstantRangeCount = 0, .pPushConstantRanges = nullptr};
+		// Set 0 is the per frame data, set 1 the bindless table.
+		const std::array setLayouts = {*descriptorSetLayout, bindlessTable.getLayout()};
+		const vk::PushConstantRange pushConstantRange{.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, .offset = 0, .size = sizeof(DrawPushConstants)};
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{.setLayoutCount = setLayouts.size(), .pSetLayouts = setLayouts.data(), .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange};
+
+		// Pending frames may still use the previous layout and pipeline, e.g. on a shader hot reload.
+		deletionQueue.retire(std::move(pipelineLayout), frameScheduler.getLastSubmittedValue());
+		deletionQueue.retire(std::move(graphicsPipeline), frameScheduler.getLastSubmittedValue());
+		deletionQueue.retire(std::move(depthPrepassPipeline), frameScheduler.getLastSubmittedValue());
 
 		pipelineLayout = vk::raii::PipelineLayout(device, pipelineLayoutInfo);
 
@@ -749,6 +1217,59 @@ namespace MVT {
 		};
 
 		graphicsPipeline = vk::raii::Pipeline(device, nullptr, pipelineInfo.get<vk::GraphicsPipelineCreateInfo>());
+
+		// Depth pre-pass: vertex stage only, positions only, no color attachment.
+		const vk::PipelineShaderStageCreateInfo depthShaderStageInfo{.stage = vk::ShaderStageFlagBits::eVertex, .module = shaderModule, .pName = "depthMain"};
+		const vk::VertexInputBindingDescription positionBinding{.binding = 0, .stride = sizeof(glm::vec3), .inputRate = vk::VertexInputRate::eVertex};
+		const vk::VertexInputAttributeDescription positionAttribute{.location = 0, .binding = 0, .format = vk::Format::eR32G32B32Sfloat, .offset = 0};
+		const vk::PipelineVertexInputStateCreateInfo positionInputInfo{
+			.vertexBindingDescriptionCount = 1, .pVertexBindingDescriptions = &positionBinding,
+			.vertexAttributeDescriptionCount = 1, .pVertexAttributeDescriptions = &positionAttribute
+		};
+		const std::array depthDynamicStates = {vk::DynamicState::eViewport, vk::DynamicState::eScissor, vk::DynamicState::eCullMode};
+		const vk::PipelineDynamicStateCreateInfo depthDynamicState{.dynamicStateCount = depthDynamicStates.size(), .pDynamicStates = depthDynamicStates.data()};
+		const vk::PipelineColorBlendStateCreateInfo noColorBlending{.logicOpEnable = vk::False, .attachmentCount = 0};
+
+		vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineRenderingCreateInfo> depthPipelineInfo{
+			{
+				.stageCount = 1, .pStages = &depthShaderStageInfo,
+				.pVertexInputState = &positionInputInfo, .pInputAssemblyState = &inputAssembly,
+				.pViewportState = &viewportState, .pRasterizationState = &rasterizer,
+				.pMultisampleState = &multisampling, .pDepthStencilState = &depthStencil, .pColorBlendState = &noColorBlending,
+				.pDynamicState = &depthDynamicState, .layout = pipelineLayout, .renderPass = nullptr,
+			},
+			{
+				.colorAttachmentCount = 0,
+				.depthAttachmentFormat = depthFormat
+			}
+		};
+		depthPrepassPipeline = vk::raii::Pipeline(device, nullptr, depthPipelineInfo.get<vk::GraphicsPipelineCreateInfo>());
+		pipelineVersion += 1;
+	}
+
+	void Application::prefetchShaders() {
+		// The Slang session is not thread safe: a single job compiles them in turn, `compileShader` waits for it.
+		JobSystem::Run([this]() {
+			auto phase = startupTrace.phase("Shaders");
+			for (const char *shaderName: {"mesh", "fxaa", "downsample"}) {
+				startupSpirv.emplace(shaderName, SlangCompiler::s_OneShotCompile(shaderName));
+			}
+		}, startupShaders);
+	}
+
+	Expected<std::vector<char>, std::string> Application::compileShader(const char *shaderName) {
+		if (!startupShaders.isDone()) {
+			auto phase = startupTrace.phase("Shader wait");
+			JobSystem::Help(startupShaders);
+		}
+		JobSystem::Wait(startupShaders);
+
+		if (const auto found = startupSpirv.find(shaderName); found != startupSpirv.end()) {
+			Expected<std::vector<char>, std::string> spirvCode = std::move(found->second);
+			startupSpirv.erase(found);
+			return spirvCode;
+		}
+		return SlangCompiler::s_OneShotCompile(shaderName);
 	}
 
 	void Application::createCommandPool() { {
@@ -762,67 +1283,24 @@ namespace MVT {
 		// }
 	}
 
-	void Application::createColorResources() {
-		const vk::Format colorFormat = swapChainImageFormat;
-
-		colorImages.clear();
-		colorImageMemories.clear();
-		colorImageViews.clear();
-
-		colorImages.reserve(depthCount);
-		colorImageMemories.reserve(depthCount);
-		colorImageViews.reserve(depthCount);
-
-		for (uint64_t i = 0; i < depthCount; ++i) {
-			colorImages.emplace_back(nullptr);
-			colorImageMemories.emplace_back(nullptr);
-			colorImageViews.emplace_back(nullptr);
-
-			createImage(swapChainExtent.width, swapChainExtent.height, 1, msaaSamples, colorFormat, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eColorAttachment,  vk::MemoryPropertyFlagBits::eDeviceLocal, colorImages.back(), colorImageMemories.back());
-			colorImageViews.back() = createImageView(colorImages.back(), colorFormat, vk::ImageAspectFlagBits::eColor, 1);
-		}
-	}
-
-	void Application::createDepthResources() {
-		// One memory allocation for all the depths images needed.
+	void Application::createRenderGraph() {
 		depthFormat = findDepthFormat();
+		renderGraph = RenderGraph(device, vma->allocator);
+	}
 
-		depthImageViews.clear();
-		depthImageMemory.clear();
-		depthImages.clear();
-
-		depthImages.reserve(depthCount);
-		depthImageViews.reserve(depthCount);
-
-		vk::ImageCreateInfo imageInfo{
-			.imageType = vk::ImageType::e2D, .format = depthFormat,
-			.extent = {swapChainExtent.width, swapChainExtent.height, 1}, .mipLevels = 1, .arrayLayers = 1,
-			.samples = msaaSamples, .tiling = vk::ImageTiling::eOptimal,
-			.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment,
-			.sharingMode = vk::SharingMode::eExclusive,
-		};
-
-		for (int i = 0; i < depthCount; ++i) {
-			depthImages.push_back(vk::raii::Image(device, imageInfo));
-		}
-
-		vk::MemoryRequirements memRequirements = depthImages.front().getMemoryRequirements();
-		const auto offset = memRequirements.size % memRequirements.alignment == 0 ? memRequirements.size : ((memRequirements.size / memRequirements.alignment) + 1) * memRequirements.alignment;
-		const auto total = memRequirements.size + offset * (depthCount - 1);
-		vk::MemoryAllocateInfo allocInfo{
-			.allocationSize = total,
-			.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal)
-		};
-
-		depthImageMemory = vk::raii::DeviceMemory(device, allocInfo);
+	VkTexture Application::createTextureImage(const char *path, const TextureUsage usage) {
+		const vk::Format format = selectTextureFormat(usage);
+		const bool compressed = TextureCooker::GetBlockFormat(format).has_value();
 
-		for (int i = 0; i < depthCount; ++i) {
-			depthImages[i].bindMemory(depthImageMemory, i * offset);
-			depthImageViews.push_back(createImageView(depthImages[i], depthFormat, vk::ImageAspectFlagBits::eDepth, 1));
+		// Block compressed formats cannot be blit, and some formats cannot be linearly filtered: both go through the CPU.
+		if (compressed || !supportsGpuMipGeneration(format)) {
+			auto cooked = TextureCooker::Cook(path, format, compressed || persistMipChains);
+			if (cooked.has_error()) {
+				throw std::runtime_error(cooked.error());
+			}
+			return createTextureImage(cooked.value());
 		}
-	}
 
-	VkTexture Application::createTextureImage(const char *path) {
 		VkTexture texture;
 
 		int texWidth, texHeight, texChannels;
@@ -851,62 +1329,290 @@ namespace MVT {
 
 		// vk::raii::Image textureImageTemp({});
 		// vk::raii::DeviceMemory textureImageMemoryTemp({});
-		texture.format = vk::Format::eR8G8B8A8Srgb;
-		createImage(texture.width, texture.height, texture.mipLevels, vk::SampleCountFlagBits::e1, texture.format, vk::ImageTiling::eOptimal,  vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::MemoryPropertyFlagBits::eDeviceLocal, texture.image, texture.memory);
+		texture.format = format;
+		if (mipGenerationMode == MipGenerationMode::Compute) {
+			// Written through UNORM storage views when the texture is sRGB.
+			createImage(texture.width, texture.height, texture.mipLevels, vk::SampleCountFlagBits::e1, texture.format, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage, vk::MemoryPropertyFlagBits::eDeviceLocal, texture.image, texture.memory, {graphicsFamily}, vk::ImageCreateFlagBits::eMutableFormat | vk::ImageCreateFlagBits::eExtendedUsage);
+		}
+		else {
+			createImage(texture.width, texture.height, texture.mipLevels, vk::SampleCountFlagBits::e1, texture.format, vk::ImageTiling::eOptimal,  vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::MemoryPropertyFlagBits::eDeviceLocal, texture.image, texture.memory);
+		}
 
 		transitionImageLayout(texture.image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, QueueType::Transfer, texture.mipLevels);
 		copyBufferToImage(stagingBuffer, texture.image, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), QueueType::Transfer);
 		// transitionImageLayout(texture.image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, QueueType::Graphics, texture.mipLevels);
 		//transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-		generateMipmaps(texture.image, texture.format, texture.width, texture.height, texture.mipLevels);
+		if (mipGenerationMode == MipGenerationMode::Compute) {
+			generateMipmapsCompute(texture.image, texture.format, texture.width, texture.height, texture.mipLevels);
+		}
+		else {
+			generateMipmaps(texture.image, texture.format, texture.width, texture.height, texture.mipLevels);
+		}
 
-		texture.view = createImageView(texture.image, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor, texture.mipLevels);
+		texture.view = createImageView(texture.image, texture.format, vk::ImageAspectFlagBits::eColor, texture.mipLevels);
 		texture.sampler = createImageSampler();
+		registerTexture(texture);
 
 		return texture;
 	}
 
-	void Application::generateMipmaps(vk::Image image, vk::Format imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels) {
+	VkTexture Application::createTextureImage(const Ktx2Texture &source) {
+		VkTexture texture;
+		frameScheduler.wait(submitTextureUpload(source, texture));
 
-		// Check if image format supports linear blit-ing
-		vk::FormatProperties formatProperties = physicalDevice.getFormatProperties(imageFormat);
-		if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
-			// TODO: Do a software resizing with std_image_resize for example.
-			throw std::runtime_error("texture image format does not support linear blitting!");
+		texture.view = createImageView(texture.image, texture.format, vk::ImageAspectFlagBits::eColor, texture.mipLevels);
+		texture.sampler = createImageSampler();
+		registerTexture(texture);
+
+		return texture;
+	}
+
+	uint64_t Application::submitTextureUpload(const Ktx2Texture &source, VkTexture &texture) {
+		texture.width = source.width;
+		texture.height = source.height;
+		texture.channels = 4;
+		texture.mipLevels = static_cast<uint32_t>(source.levels.size());
+		texture.format = source.format;
+
+		// Every level goes in the same staging buffer, copied in one go. Offsets stay aligned on the block size.
+		std::vector<vk::BufferImageCopy> regions;
+		regions.reserve(texture.mipLevels);
+		vk::DeviceSize imageSize = 0;
+		for (uint32_t level = 0; level < texture.mipLevels; ++level) {
+			imageSize = (imageSize + 15) & ~static_cast<vk::DeviceSize>(15);
+			regions.push_back(vk::BufferImageCopy{
+				.bufferOffset = imageSize, .bufferRowLength = 0, .bufferImageHeight = 0,
+				.imageSubresource = {vk::ImageAspectFlagBits::eColor, level, 0, 1},
+				.imageOffset = {0, 0, 0}, .imageExtent = {source.GetLevelWidth(level), source.GetLevelHeight(level), 1}
+			});
+			imageSize += source.levels[level].size();
 		}
 
+		vk::raii::Buffer stagingBuffer({});
+		vk::raii::DeviceMemory stagingBufferMemory({});
 
-		vk::raii::CommandBuffer commandBuffer = beginSingleTimeCommands(QueueType::Graphics);
+		createBuffer(imageSize, vk::BufferUsageFlagBits::eTransferSrc, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer, stagingBufferMemory);
 
-		vk::ImageMemoryBarrier barrier = {
-			.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
-			.dstAccessMask = vk::AccessFlagBits::eTransferRead,
-			.oldLayout = vk::ImageLayout::eTransferDstOptimal,
-			.newLayout = vk::ImageLayout::eTransferSrcOptimal,
-			.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
-			.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
-			.image = image,
-			.subresourceRange = {
-				.aspectMask = vk::ImageAspectFlagBits::eColor,
-				.baseMipLevel = 0,
-				.levelCount = 1,
-				.baseArrayLayer = 0,
-				.layerCount = 1
+		auto *data = static_cast<uint8_t *>(stagingBufferMemory.mapMemory(0, imageSize));
+		for (uint32_t level = 0; level < texture.mipLevels; ++level) {
+			memcpy(data + regions[level].bufferOffset, source.levels[level].data(), source.levels[level].size());
+		}
+		stagingBufferMemory.unmapMemory();
+
+		createImage(texture.width, texture.height, texture.mipLevels, vk::SampleCountFlagBits::e1, texture.format, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::MemoryPropertyFlagBits::eDeviceLocal, texture.image, texture.memory);
+
+		// Both transitions and the copy in a single submission.
+		auto cmd = beginSingleTimeCommands(QueueType::Transfer);
+		const vk::ImageMemoryBarrier2 toTransfer = MakeLayoutBarrier(texture.image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, texture.mipLevels);
+		cmd.pipelineBarrier2(vk::DependencyInfo{.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toTransfer});
+		cmd.copyBufferToImage(stagingBuffer, texture.image, vk::ImageLayout::eTransferDstOptimal, regions);
+		const vk::ImageMemoryBarrier2 toShader = MakeLayoutBarrier(texture.image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, texture.mipLevels);
+		cmd.pipelineBarrier2(vk::DependencyInfo{.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toShader});
+		cmd.end();
+
+		const vk::CommandBufferSubmitInfo commandBufferInfo{.commandBuffer = cmd};
+		const uint64_t value = frameScheduler.submit(*graphicsQueue, {&commandBufferInfo, 1});
+		deletionQueue.retire(std::move(cmd), value);
+		deletionQueue.retire(std::move(stagingBuffer), value);
+		deletionQueue.retire(std::move(stagingBufferMemory), value);
+		return value;
+	}
+
+	std::vector<VkTexture> Application::createTextureImages(const std::span<const char *const> paths, const TextureUsage usage) {
+		const vk::Format format = selectTextureFormat(usage);
+		const bool compressed = TextureCooker::GetBlockFormat(format).has_value();
+
+		// Decode, filter and encode in parallel, the uploads are recorded on this thread.
+		std::vector<VkTexture> textures(paths.size());
+		std::vector<Task<void>> loads;
+		loads.reserve(paths.size());
+		for (size_t i = 0; i < paths.size(); ++i) {
+			loads.push_back(loadTextureAsync({.source = paths[i], .format = format, .persist = compressed || persistMipChains}, usage, textures[i]));
+		}
+		runLoad(WhenAll(std::move(loads)));
+
+		return textures;
+	}
+
+	Task<void> Application::loadTextureAsync(const TextureCookRequest request, const TextureUsage usage, VkTexture &texture) {
+		if (!TextureCooker::GetBlockFormat(request.format).has_value()) {
+			// Decided on the render thread, the mip generators may not exist yet when the load starts.
+			co_await gpuResumer.after(0);
+			if (supportsGpuMipGeneration(request.format)) {
+				// Mips generated on the GPU: nothing to do off the render thread.
+				texture = createTextureImage(request.source.string().c_str(), usage);
+				co_return;
 			}
-		};
-		uint32_t mipWidth = texWidth;
-		uint32_t mipHeight = texHeight;
+		}
 
-		for (uint32_t i = 1; i < mipLevels; ++i) {
-			barrier.subresourceRange.baseMipLevel = i - 1;
-			barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-			barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
-			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-			barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+		co_await ScheduleOnJobs{};
+		auto cooked = TextureCooker::Cook(request.source, request.format, request.persist);
+		if (cooked.has_error()) {
+			throw std::runtime_error(cooked.error());
+		}
 
-			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, barrier);
+		co_await gpuResumer.after(0);
+		const uint64_t uploaded = submitTextureUpload(cooked.value(), texture);
+		texture.view = createImageView(texture.image, texture.format, vk::ImageAspectFlagBits::eColor, texture.mipLevels);
+		texture.sampler = createImageSampler();
 
-			vk::ArrayWrapper1D<vk::Offset3D, 2> offsets, dstOffsets;
+		// Only visible to the shaders once its levels landed.
+		co_await gpuResumer.after(uploaded);
+		registerTexture(texture);
+	}
+
+	bool Application::supportsLinearBlit(const vk::Format format) {
+		constexpr vk::FormatFeatureFlags blitFeatures = vk::FormatFeatureFlagBits::eSampledImageFilterLinear | vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst;
+		const vk::FormatProperties properties = physicalDevice.getFormatProperties(format);
+		return (properties.optimalTilingFeatures & blitFeatures) == blitFeatures;
+	}
+
+	bool Application::supportsGpuMipGeneration(const vk::Format format) {
+		switch (mipGenerationMode) {
+			case MipGenerationMode::Blit:
+				return supportsLinearBlit(format);
+			case MipGenerationMode::Compute:
+				return mipDownsampler.isValid() && ComputeDownsampler::GetStorageFormat(physicalDevice, format) != vk::Format::eUndefined;
+			case MipGenerationMode::Cpu:
+			default:
+				return false;
+		}
+	}
+
+	void Application::createAntiAliasing() {
+		// Two timestamps around each frame, per slot: the adaptive policy reads them once the slot comes back.
+		frameTimer = GpuTimer(device, physicalDevice, graphicsFamily, 2 * MAX_FRAMES_IN_FLIGHT);
+		frameTimerPending = {};
+
+		// FXAA filters in a float storage image and blits it in the swapchain image, converting to its format.
+		const vk::FormatFeatureFlags outputFeatures = physicalDevice.getFormatProperties(FxaaPass::c_OutputFormat).optimalTilingFeatures;
+		const vk::FormatFeatureFlags swapChainFeatures = physicalDevice.getFormatProperties(swapChainImageFormat).optimalTilingFeatures;
+		bool fxaaSupported = swapChainTransferDst && (outputFeatures & vk::FormatFeatureFlagBits::eStorageImage) && (outputFeatures & vk::FormatFeatureFlagBits::eBlitSrc) &&
+		                     (swapChainFeatures & vk::FormatFeatureFlagBits::eBlitDst);
+		if (fxaaSupported) {
+			auto spirvCode = compileShader("fxaa");
+			if (spirvCode.has_error()) {
+				MVT_LOG_ERROR(Shaders, "Fail to compile fxaa.slang: {}", spirvCode.error());
+				fxaaSupported = false;
+			}
+			else {
+				fxaaPass = FxaaPass(device, spirvCode.value());
+			}
+		}
+
+		const vk::PhysicalDeviceLimits limits = physicalDevice.getProperties().limits;
+		antiAliasing = AntiAliasingPolicy(antiAliasingSettings, limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts, fxaaSupported);
+		msaaSamples = antiAliasing.getSamples();
+	}
+
+	void Application::createDynamicResolution() {
+		// The scaled scene is blitted in the swapchain image with a linear filter.
+		const vk::FormatFeatureFlags features = physicalDevice.getFormatProperties(swapChainImageFormat).optimalTilingFeatures;
+		DynamicResolutionSettings settings = dynamicResolutionSettings;
+		if (settings.enabled && !(swapChainTransferDst && (features & vk::FormatFeatureFlagBits::eBlitSrc) && (features & vk::FormatFeatureFlagBits::eBlitDst) &&
+		                          (features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear))) {
+			MVT_LOG_WARN(Render, "[DynamicResolution] The swapchain images cannot be blitted to, rendering at full resolution.");
+			settings.enabled = false;
+		}
+		dynamicResolution = DynamicResolution(settings);
+	}
+
+	void Application::updateFrameControllers() {
+		const uint32_t query = 2 * currentFrame;
+		if (!frameTimerPending[currentFrame]) return;
+		frameTimerPending[currentFrame] = false;
+
+		// The slot's previous frame completed, its timestamps are available.
+		const std::optional<double> elapsed = frameTimer.getElapsedMilliseconds(query, query + 1);
+		if (!elapsed) return;
+
+		// The resolution reacts every frame, the anti-aliasing mode only when a whole window stays off budget.
+		dynamicResolution.update(*elapsed);
+		if (!antiAliasing.update(*elapsed)) return;
+
+		// The pipelines and the graph's attachments follow the new sample count, the pending frames keep the old ones.
+		msaaSamples = antiAliasing.getSamples();
+		const AllocationScope scope{AllocationCategory::Resources};
+		createGraphicsPipeline();
+	}
+
+	void Application::createMipGenerators() {
+		// Two timestamps around each GPU mip generation, to compare the blit and compute paths.
+		mipTimer = GpuTimer(device, physicalDevice, graphicsFamily, 2);
+
+		if (!storageImageWithoutFormat) {
+			return;
+		}
+
+		auto spirvCode = compileShader("downsample");
+		if (spirvCode.has_error()) {
+			MVT_LOG_ERROR(Shaders, "Fail to compile downsample.slang: {}", spirvCode.error());
+			return;
+		}
+
+		mipDownsampler = ComputeDownsampler(device, physicalDevice, spirvCode.value());
+	}
+
+	vk::Format Application::selectTextureFormat(const TextureUsage usage) {
+		constexpr vk::FormatFeatureFlags requiredFeatures = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear | vk::FormatFeatureFlagBits::eTransferDst;
+
+		const auto candidates = TextureCooker::GetFormatCandidates(usage);
+		for (const vk::Format format: candidates) {
+			if (TextureCooker::GetBlockFormat(format) && !textureCompressionBC) {
+				continue;
+			}
+
+			const vk::FormatProperties properties = physicalDevice.getFormatProperties(format);
+			if ((properties.optimalTilingFeatures & requiredFeatures) == requiredFeatures) {
+				return format;
+			}
+		}
+
+		// The uncompressed format is mandatory for sampling, keep it as the last resort.
+		return candidates.back();
+	}
+
+	void Application::generateMipmaps(vk::Image image, vk::Format imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels) {
+
+		// Check if image format supports linear blit-ing, the callers use the MipGenerator when it doesn't.
+		if (!supportsLinearBlit(imageFormat)) {
+			throw std::runtime_error("texture image format does not support linear blitting!");
+		}
+
+
+		vk::raii::CommandBuffer commandBuffer = beginSingleTimeCommands(QueueType::Graphics);
+		mipTimer.reset(commandBuffer, 0, 2);
+		mipTimer.write(commandBuffer, vk::PipelineStageFlagBits2::eTopOfPipe, 0);
+
+		vk::ImageMemoryBarrier barrier = {
+			.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+			.dstAccessMask = vk::AccessFlagBits::eTransferRead,
+			.oldLayout = vk::ImageLayout::eTransferDstOptimal,
+			.newLayout = vk::ImageLayout::eTransferSrcOptimal,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.image = image,
+			.subresourceRange = {
+				.aspectMask = vk::ImageAspectFlagBits::eColor,
+				.baseMipLevel = 0,
+				.levelCount = 1,
+				.baseArrayLayer = 0,
+				.layerCount = 1
+			}
+		};
+		uint32_t mipWidth = texWidth;
+		uint32_t mipHeight = texHeight;
+
+		for (uint32_t i = 1; i < mipLevels; ++i) {
+			barrier.subresourceRange.baseMipLevel = i - 1;
+			barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+			barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+			barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, barrier);
+
+			vk::ArrayWrapper1D<vk::Offset3D, 2> offsets, dstOffsets;
 			offsets[0] = vk::Offset3D(0, 0, 0);
 			offsets[1] = vk::Offset3D(mipWidth, mipHeight, 1);
 			dstOffsets[0] = vk::Offset3D(0, 0, 0);
@@ -935,14 +1641,118 @@ namespace MVT {
 
 		commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, barrier);
 
+		mipTimer.write(commandBuffer, vk::PipelineStageFlagBits2::eBottomOfPipe, 1);
 		endSingleTimeCommands(commandBuffer, QueueType::Graphics);
+
+		if (const auto elapsed = mipTimer.getElapsedMilliseconds(0, 1)) {
+			MVT_LOG_INFO(Assets, "[Mipmaps] Blit {}x{} ({} levels): {:.3f} ms", texWidth, texHeight, mipLevels, *elapsed);
+		}
 	}
 
-	void Application::createTextureImage() {
-		// const char* path = "EngineAssets/Textures/texture.jpg";
-		const char* path = "EngineAssets/Textures/viking_room.png";
+	void Application::generateMipmapsCompute(vk::Image image, vk::Format imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels) {
+		const vk::Format storageFormat = ComputeDownsampler::GetStorageFormat(physicalDevice, imageFormat);
+		if (!mipDownsampler.isValid() || storageFormat == vk::Format::eUndefined) {
+			throw std::runtime_error("texture image format cannot be downsampled in a compute shader!");
+		}
+
+		vk::raii::CommandBuffer commandBuffer = beginSingleTimeCommands(QueueType::Graphics);
+		mipTimer.reset(commandBuffer, 0, 2);
+		mipTimer.write(commandBuffer, vk::PipelineStageFlagBits2::eTopOfPipe, 0);
+
+		// The views and descriptors must outlive the submission, endSingleTimeCommands waits for it.
+		const ComputeDownsampler::Resources resources = mipDownsampler.record(commandBuffer, {
+			                                                                      .image = image, .sampledFormat = imageFormat, .storageFormat = storageFormat,
+			                                                                      .width = texWidth, .height = texHeight, .mipLevels = mipLevels,
+			                                                                      .reduction = DownsampleReduction::Average
+		                                                                      });
 
-		texture = createTextureImage(path);
+		mipTimer.write(commandBuffer, vk::PipelineStageFlagBits2::eBottomOfPipe, 1);
+		endSingleTimeCommands(commandBuffer, QueueType::Graphics);
+
+		if (const auto elapsed = mipTimer.getElapsedMilliseconds(0, 1)) {
+			MVT_LOG_INFO(Assets, "[Mipmaps] Compute {}x{} ({} levels): {:.3f} ms", texWidth, texHeight, mipLevels, *elapsed);
+		}
+	}
+
+	void Application::createTextureImage(std::optional<Ktx2Texture> &cooked) {
+		// Cooked ahead on a worker when the format is block compressed, the only case where it is known before the mip generators.
+		texture = cooked ? createTextureImage(*cooked) : createTextureImage(c_DefaultTexturePath);
+		cooked.reset();
+	}
+
+	void Application::registerTexture(VkTexture &texture) {
+		texture.textureSlot = bindlessTable.allocateTexture(texture.view);
+		texture.samplerSlot = bindlessTable.allocateSampler(texture.sampler);
+	}
+
+	void Application::releaseTexture(VkTexture &texture) {
+		bindlessTable.release(BindlessResource::Texture, texture.textureSlot);
+		bindlessTable.release(BindlessResource::Sampler, texture.samplerSlot);
+		texture.clear();
+	}
+
+	uint32_t Application::createMaterial(const VkTexture &albedo, const glm::vec4 baseColor, const uint32_t flags) {
+		if (materials.size() >= c_MaxMaterials) {
+			throw std::runtime_error("[Vulkan] Too many materials!");
+		}
+
+		materials.push_back(GpuMaterial{.baseColor = baseColor, .albedoTexture = albedo.textureSlot, .albedoSampler = albedo.samplerSlot, .flags = flags});
+		materialStreamedTextures.push_back(TextureResidency::c_InvalidHandle);
+		materialsVersion += 1;
+		return static_cast<uint32_t>(materials.size() - 1);
+	}
+
+	uint32_t Application::createStreamedMaterial(const uint32_t streamedTexture, const glm::vec4 baseColor, const uint32_t flags) {
+		if (materials.size() >= c_MaxMaterials) {
+			throw std::runtime_error("[Vulkan] Too many materials!");
+		}
+
+		// Points to the fallback texture until the first mips are uploaded.
+		materials.push_back(GpuMaterial{.baseColor = baseColor, .albedoTexture = textureResidency.getTextureSlot(streamedTexture), .albedoSampler = textureResidency.getSamplerSlot(), .flags = flags});
+		materialStreamedTextures.push_back(streamedTexture);
+		materialsVersion += 1;
+		return static_cast<uint32_t>(materials.size() - 1);
+	}
+
+	void Application::refreshStreamedMaterials() {
+		for (size_t i = 0; i < materials.size(); ++i) {
+			if (materialStreamedTextures[i] != TextureResidency::c_InvalidHandle) {
+				materials[i].albedoTexture = textureResidency.getTextureSlot(materialStreamedTextures[i]);
+			}
+		}
+		materialsVersion += 1;
+	}
+
+	void Application::uploadMaterials(const uint32_t frame) {
+		// Each frame in flight reads its own copy, so a pending frame never sees a slot it wasn't recorded with.
+		if (uploadedMaterialsVersion[frame] == materialsVersion) {
+			return;
+		}
+
+		memcpy(materialsMapped + static_cast<size_t>(frame) * c_MaxMaterials, materials.data(), materials.size() * sizeof(GpuMaterial));
+		uploadedMaterialsVersion[frame] = materialsVersion;
+	}
+
+	void Application::createTextureResidency() {
+		streamingSampler = createImageSampler();
+		textureResidency = TextureResidency(device, vma->allocator, bindlessTable, streamingSampler, texture.textureSlot);
+	}
+
+	void Application::updateTextureStreaming() {
+		const FramePacket &packet = frameMailbox.getFront();
+		const float focal = static_cast<float>(swapChainExtent.height) * 0.5f / std::tan(glm::radians(packet.cameraFovDegrees) * 0.5f);
+
+		for (const VkMesh &mesh: m_Meshes) {
+			if (mesh.streamedTextures.empty()) continue;
+
+			// Screen diameter of the bounding sphere, the textures are assumed to cover it once.
+			const float distance = std::max(glm::length(packet.cameraPosition - mesh.boundsCenter), 0.01f);
+			const float screenExtent = 2.0f * mesh.boundsRadius * focal / distance;
+
+			for (const uint32_t handle: mesh.streamedTextures) {
+				textureResidency.requestExtent(handle, screenExtent, frameCount);
+			}
+		}
 	}
 
 	// void Application::createTextureImageView() {
@@ -983,8 +1793,9 @@ namespace MVT {
 		createImage(width, height, mipLevel, numSamples, format, tiling, usage, properties, image, imageMemory, {graphicsFamily});
 	}
 
-	void Application::createImage(uint32_t width, uint32_t height, uint32_t mipLevel, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image &image, vk::raii::DeviceMemory &imageMemory, const std::vector<uint32_t> &families) {
+	void Application::createImage(uint32_t width, uint32_t height, uint32_t mipLevel, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image &image, vk::raii::DeviceMemory &imageMemory, const std::vector<uint32_t> &families, const vk::ImageCreateFlags flags) {
 		vk::ImageCreateInfo imageInfo{
+			.flags = flags,
 			.imageType = vk::ImageType::e2D, .format = format,
 			.extent = {width, height, 1}, .mipLevels = mipLevel, .arrayLayers = 1,
 			.samples = numSamples, .tiling = tiling,
@@ -1066,66 +1877,88 @@ namespace MVT {
 	}
 
 	void Application::loadModel(const char *cModelPath, const char** cTexturesPaths, uint32_t textureCount) {
-		auto models = loadModel(cModelPath);
-		auto& model = models[0];
-		model.textures.reserve(textureCount);
-		for (uint32_t i = 0; i < textureCount; ++i) {
-			model.textures.emplace_back(createTextureImage(cTexturesPaths[i]));
-		}
-
-		m_Meshes = std::move(models);
+		runLoad(loadModelAsync(StartedTask<MeshData>{ParseObjAsync(cModelPath)}, cTexturesPaths, textureCount));
 	}
 
-	std::vector<MVT::VkMesh> Application::loadModel(const char *cpath) {
-		std::vector<Vertex> vertices;
-		std::vector<uint32_t> indices;
+	Task<void> Application::loadModelAsync(StartedTask<MeshData> geometry, const char **cTexturesPaths, const uint32_t textureCount, StartedTask<void> *defaultCook) {
+		std::vector<std::optional<Ktx2Texture>> cooked;
+		std::vector<VkTexture> textures;
+		const bool streamed = textureStreaming && textureCount > 0;
 
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warn, err;
-
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, cpath)) {
-			throw std::runtime_error(warn + err);
-		}
+		const vk::Format format = selectTextureFormat(TextureUsage::Color);
 
-		vertices.reserve(attrib.vertices.size());
-		indices.reserve(attrib.vertices.size());
+		// Persisted like the default texture, in the same format: the cook reads what the default one saved.
+		const auto takeDefaultCook = [&defaultCook](const char *path) -> StartedTask<void> * {
+			if (!defaultCook || std::string_view{path} != c_DefaultTexturePath) return nullptr;
+			return std::exchange(defaultCook, nullptr); // A started task has a single waiter.
+		};
 
-		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-		uniqueVertices.reserve(attrib.vertices.size());
+		std::vector<Task<void>> loads;
+		loads.reserve(textureCount);
+		if (streamed) {
+			// Kept in RAM as cooked KTX2 chains, the residency uploads the mips the camera needs within the budget.
+			cooked.resize(textureCount);
+			for (uint32_t i = 0; i < textureCount; ++i) {
+				Task<void> load = CookTextureAsync(TextureCookRequest{.source = cTexturesPaths[i], .format = format, .persist = true}, cooked[i]);
+				StartedTask<void> *const after = takeDefaultCook(cTexturesPaths[i]);
+				loads.push_back(after ? AfterAsync(*after, std::move(load)) : std::move(load));
+			}
+		}
+		else {
+			const bool compressed = TextureCooker::GetBlockFormat(format).has_value();
+			textures.resize(textureCount);
+			for (uint32_t i = 0; i < textureCount; ++i) {
+				Task<void> load = loadTextureAsync(TextureCookRequest{.source = cTexturesPaths[i], .format = format, .persist = compressed || persistMipChains}, TextureUsage::Color, textures[i]);
+				StartedTask<void> *const after = takeDefaultCook(cTexturesPaths[i]);
+				loads.push_back(after ? AfterAsync(*after, std::move(load)) : std::move(load));
+			}
+		}
+		co_await TraceAsync(startupTrace, "Textures", WhenAll(std::move(loads)));
+		const MeshData mesh = co_await geometry;
 
-		// We’re going to combine all the faces in the file into a single model, so just iterate over all the shapes
-		for (const auto& shape : shapes) {
-			for (const auto& index : shape.mesh.indices) {
-				Vertex vertex{};
+		// The last load may have finished on a worker.
+		co_await gpuResumer.after(0);
+		std::vector<VkMesh> models;
+		models.emplace_back(createMesh(mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()), mesh.indices.data(), mesh.indices.size()));
+		auto& model = models[0];
+		if (streamed) {
+			for (std::optional<Ktx2Texture> &texture: cooked) {
+				model.streamedTextures.push_back(textureResidency.add(std::move(*texture)));
+			}
+			model.materialIndex = createStreamedMaterial(model.streamedTextures.front(), glm::vec4{1.0f}, modelMaterialFlags);
+		}
+		else {
+			model.textures = std::move(textures);
+			model.materialIndex = model.textures.empty() ? defaultMaterial : createMaterial(model.textures.front(), glm::vec4{1.0f}, modelMaterialFlags);
+		}
 
-				vertex.pos = {
-					attrib.vertices[3 * index.vertex_index + 0],
-					attrib.vertices[3 * index.vertex_index + 1],
-					attrib.vertices[3 * index.vertex_index + 2]
-				};
+		m_Meshes = std::move(models);
+		sceneVersion += 1;
+	}
 
-				vertex.uv = {
-					attrib.texcoords[2 * index.texcoord_index + 0],
-					1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-				};
+	std::vector<MVT::VkMesh> Application::loadModel(const char *cpath) {
+		std::vector<MVT::VkMesh> meshes;
+		runLoad(loadMeshesAsync(cpath, meshes));
+		return meshes;
+	}
 
-				vertex.color = {1.0f, 1.0f, 1.0f};
+	Task<void> Application::loadMeshesAsync(const std::filesystem::path path, std::vector<VkMesh> &meshes) {
+		const MeshData mesh = co_await ParseObjAsync(path);
 
-				if (!uniqueVertices.contains(vertex)) {
-					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-					vertices.push_back(vertex);
-				}
+		// The buffers are created and uploaded by the render thread.
+		co_await gpuResumer.after(0);
+		meshes.emplace_back(createMesh(mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()), mesh.indices.data(), mesh.indices.size()));
+	}
 
-				indices.push_back(uniqueVertices[vertex]);
-			}
+	void Application::resumeLoads() {
+		const std::optional<uint64_t> next = gpuResumer.getNextValue();
+		if (!next) {
+			// Everything runs on the workers for now.
+			std::this_thread::yield();
+			return;
 		}
-
-		VkMesh mesh = createMesh(vertices.data(), static_cast<uint32_t>(vertices.size()), indices.data(), indices.size());
-		std::vector<MVT::VkMesh> meshes;
-		meshes.emplace_back(std::move(mesh));
-		return std::move(meshes);
+		frameScheduler.wait(*next);
+		gpuResumer.resume(frameScheduler.getCompletedValue());
 	}
 
 	MVT::VkMesh Application::createMesh(const Vertex *pVertices, uint32_t verticesCount) {
@@ -1145,6 +1978,10 @@ namespace MVT {
 		mesh.m_VertexBuffer = std::move(vert.first);
 		mesh.m_VertexMemory = std::move(vert.second);
 
+		auto positions = makePositionBuffer(pVertices, verticesCount);
+		mesh.m_PositionBuffer = std::move(positions.first);
+		mesh.m_PositionMemory = std::move(positions.second);
+
 		auto ind = makeIndexBuffer(pIndices, indicesCount);
 		mesh.m_IndexBuffer = std::move(ind.first);
 		mesh.m_IndicesMemory = std::move(ind.second);
@@ -1152,6 +1989,17 @@ namespace MVT {
 		mesh.indicesCount = indicesCount;
 		mesh.vertexCount = verticesCount;
 
+		// Bounding sphere around the AABB, used to pick the streamed mips.
+		if (verticesCount > 0) {
+			glm::vec3 min{pVertices[0].pos}, max{pVertices[0].pos};
+			for (uint32_t i = 1; i < verticesCount; ++i) {
+				min = glm::min(min, pVertices[i].pos);
+				max = glm::max(max, pVertices[i].pos);
+			}
+			mesh.boundsCenter = (min + max) * 0.5f;
+			mesh.boundsRadius = glm::length(max - min) * 0.5f;
+		}
+
 		return std::move(mesh);
 	}
 
@@ -1159,12 +2007,6 @@ namespace MVT {
 		createVertexBuffer(vertices.data(), vertices.size());
 	}
 
-	void Application::waitAndResetFence() {
-		auto result = device.waitForFences(*transferFence, true, UINT64_MAX);
-		assert(result == vk::Result::eSuccess);
-		device.resetFences(*transferFence);
-	}
-
 	void Application::createVertexBuffer(const Vertex *vertices, const uint64_t count) {
 		const vk::DeviceSize bufferSize = sizeof(Vertex) * count;
 
@@ -1178,9 +2020,12 @@ namespace MVT {
 
 		createBuffer(bufferSize, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst, vk::MemoryPropertyFlagBits::eDeviceLocal, vertexBuffer, vertexBufferMemory);
 
-		copyBuffer(stagingBuffer, vertexBuffer, bufferSize, transferFence, commandPool, graphicsQueue);
-		waitAndResetFence();
+		copyBuffer(stagingBuffer, vertexBuffer, bufferSize, commandPool, graphicsQueue);
 		//transferBufferQueue(vertexBuffer, QueueType::Transfer, QueueType::Graphics,vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eVertexInput);
+
+		auto positions = makePositionBuffer(vertices, count);
+		positionBuffer = std::move(positions.first);
+		positionBufferMemory = std::move(positions.second);
 	}
 
 	std::pair<vk::raii::Buffer, vk::raii::DeviceMemory> Application::makeVertexBuffer(const Vertex *vertices, const uint64_t count) {
@@ -1197,13 +2042,34 @@ namespace MVT {
 
 		createBuffer(bufferSize, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst, vk::MemoryPropertyFlagBits::eDeviceLocal, pair.first, pair.second);
 
-		copyBuffer(stagingBuffer, pair.first, bufferSize, transferFence, commandPool, graphicsQueue);
-		waitAndResetFence();
+		copyBuffer(stagingBuffer, pair.first, bufferSize, commandPool, graphicsQueue);
 		//transferBufferQueue(pair.first, QueueType::Transfer, QueueType::Graphics,vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eVertexInput);
 
 		return std::move(pair);
 	}
 
+	std::pair<vk::raii::Buffer, vk::raii::DeviceMemory> Application::makePositionBuffer(const Vertex *vertices, const uint64_t count) {
+		std::pair<vk::raii::Buffer, vk::raii::DeviceMemory> pair{nullptr, nullptr};
+		const vk::DeviceSize bufferSize = sizeof(glm::vec3) * count;
+
+		vk::raii::Buffer stagingBuffer = nullptr;
+		vk::raii::DeviceMemory stagingBufferMemory = nullptr;
+		createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer, stagingBufferMemory);
+
+		// 12 bytes per vertex instead of `sizeof(Vertex)`: the pre-pass fetches nothing it does not use.
+		auto *positions = static_cast<glm::vec3 *>(stagingBufferMemory.mapMemory(0, bufferSize));
+		for (uint64_t i = 0; i < count; ++i) {
+			positions[i] = vertices[i].pos;
+		}
+		stagingBufferMemory.unmapMemory();
+
+		createBuffer(bufferSize, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst, vk::MemoryPropertyFlagBits::eDeviceLocal, pair.first, pair.second);
+
+		copyBuffer(stagingBuffer, pair.first, bufferSize, commandPool, graphicsQueue);
+
+		return std::move(pair);
+	}
+
 	void Application::createIndexBuffer(const uint32_t *indices, const uint32_t count) {
 		indices_count = count;
 		vk::DeviceSize bufferSize = sizeof(indices[0]) * count;
@@ -1218,8 +2084,7 @@ namespace MVT {
 
 		createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, indexBuffer, indexBufferMemory);
 
-		copyBuffer(stagingBuffer, indexBuffer, bufferSize, transferFence, commandPool, graphicsQueue);
-		waitAndResetFence();
+		copyBuffer(stagingBuffer, indexBuffer, bufferSize, commandPool, graphicsQueue);
 		//transferBufferQueue(indexBuffer, QueueType::Transfer, QueueType::Graphics,vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eVertexInput);
 	}
 
@@ -1239,35 +2104,21 @@ namespace MVT {
 
 		createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, pair.first, pair.second);
 
-		copyBuffer(stagingBuffer, pair.first, bufferSize, transferFence, commandPool, graphicsQueue);
-		waitAndResetFence();
+		copyBuffer(stagingBuffer, pair.first, bufferSize, commandPool, graphicsQueue);
 		//transferBufferQueue(pair.first, QueueType::Transfer, QueueType::Graphics,vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eVertexInput);
 
 		return std::move(pair);
 	}
 
 	void Application::createUniformBuffers() {
-		uniformBuffers.clear();
-		uniformBuffersMemory.clear();
-		uniformBuffersMapped.clear();
-
-		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-			vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
-			vk::raii::Buffer buffer({});
-			vk::raii::DeviceMemory bufferMem({});
-
-			createBuffer(bufferSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, bufferMem, {graphicsFamily});
-
-			uniformBuffers.emplace_back(std::move(buffer));
-			uniformBuffersMemory.emplace_back(std::move(bufferMem));
-			uniformBuffersMapped.emplace_back(uniformBuffersMemory[i].mapMemory(0, bufferSize));
-		}
+		// Every uniform lives in the frame allocator, the descriptors only differ by their dynamic offset.
+		frameAllocator = FrameAllocator(vma->allocator, physicalDevice, c_FrameAllocatorRegionSize);
 	}
 
 	void Application::createDescriptorPool() {
 		std::array poolSize{
-			vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT),
-			vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, MAX_FRAMES_IN_FLIGHT),
+			vk::DescriptorPoolSize(vk::DescriptorType::eUniformBufferDynamic, MAX_FRAMES_IN_FLIGHT * 2),
+			vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, MAX_FRAMES_IN_FLIGHT),
 		};
 
 		vk::DescriptorPoolCreateInfo poolInfo{.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, .maxSets = MAX_FRAMES_IN_FLIGHT, .poolSizeCount = poolSize.size(), .pPoolSizes = poolSize.data()};
@@ -1282,12 +2133,14 @@ namespace MVT {
 		descriptorSets = device.allocateDescriptorSets(allocInfo);
 
 		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			vk::DescriptorBufferInfo bufferInfo{.buffer = uniformBuffers[i], .offset = 0, .range = sizeof(UniformBufferObject)};
-			vk::DescriptorImageInfo imageInfo{.sampler = texture.sampler, .imageView = texture.view, .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal};
+			const vk::DescriptorBufferInfo bufferInfo = frameAllocator.getDescriptorInfo(sizeof(UniformBufferObject));
+			const vk::DescriptorBufferInfo objectInfo = frameAllocator.getDescriptorInfo(sizeof(ObjectUniform));
+			vk::DescriptorBufferInfo materialInfo{.buffer = materialBuffer, .offset = i * sizeof(GpuMaterial) * c_MaxMaterials, .range = sizeof(GpuMaterial) * c_MaxMaterials};
 
 			std::array descriptors{
-				vk::WriteDescriptorSet{.dstSet = descriptorSets[i], .dstBinding = 0, .dstArrayElement = 0, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eUniformBuffer, .pBufferInfo = &bufferInfo},
-				vk::WriteDescriptorSet{.dstSet = descriptorSets[i], .dstBinding = 1, .dstArrayElement = 0, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eCombinedImageSampler, .pImageInfo = &imageInfo},
+				vk::WriteDescriptorSet{.dstSet = descriptorSets[i], .dstBinding = 0, .dstArrayElement = 0, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eUniformBufferDynamic, .pBufferInfo = &bufferInfo},
+				vk::WriteDescriptorSet{.dstSet = descriptorSets[i], .dstBinding = 1, .dstArrayElement = 0, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = &materialInfo},
+				vk::WriteDescriptorSet{.dstSet = descriptorSets[i], .dstBinding = 2, .dstArrayElement = 0, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eUniformBufferDynamic, .pBufferInfo = &objectInfo},
 			};
 			device.updateDescriptorSets(descriptors, {});
 		}
@@ -1354,145 +2207,427 @@ namespace MVT {
 
 	void Application::createSyncObjects() {
 		presentCompleteSemaphores.clear();
-		renderFinishedSemaphores.clear();
-		inFlightFences.clear();
-		transferFence.clear();
+		frameScheduler.clear();
+
+		// Acquire semaphores are reused with their slot, once the timeline says the frame that waited on them completed.
+		presentCompleteSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+			presentCompleteSemaphores.emplace_back(device, vk::SemaphoreCreateInfo());
+		}
+		createRenderFinishedSemaphores();
 
-		presentCompleteSemaphores.reserve(swapChainImages.size());
+		frameScheduler = FrameScheduler(device, framesInFlight);
+	}
+
+	void Application::createRenderFinishedSemaphores() {
+		// Presentation has no completion signal: a semaphore is only signaled again once its image is acquired again.
+		renderFinishedSemaphores.clear();
 		renderFinishedSemaphores.reserve(swapChainImages.size());
 		for (size_t i = 0; i < swapChainImages.size(); i++) {
-			presentCompleteSemaphores.emplace_back(device, vk::SemaphoreCreateInfo());
 			renderFinishedSemaphores.emplace_back(device, vk::SemaphoreCreateInfo());
 		}
+	}
 
-		inFlightFences.reserve(MAX_FRAMES_IN_FLIGHT);
-		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-			inFlightFences.emplace_back(device, vk::FenceCreateInfo{.flags = vk::FenceCreateFlagBits::eSignaled});
+	void Application::createParallelRecorder() {
+		parallelRecorder.reset();
+		parallelRecorder = std::make_unique<ParallelRecorder>(device, graphicsFamily, recordingThreads);
+		MVT_LOG_INFO(Vulkan, "Recording on {} thread(s).", parallelRecorder->getThreadCount());
+	}
+
+	void Application::createStaticDraws() {
+		for (StaticDraws &cache: staticDraws) {
+			cache.commandBuffer.clear();
+			cache.depthCommandBuffer.clear();
+			cache.pool = vk::raii::CommandPool(device, vk::CommandPoolCreateInfo{.queueFamilyIndex = graphicsFamily});
+			auto buffers = device.allocateCommandBuffers(vk::CommandBufferAllocateInfo{.commandPool = cache.pool, .level = vk::CommandBufferLevel::eSecondary, .commandBufferCount = 2});
+			cache.commandBuffer = std::move(buffers[0]);
+			cache.depthCommandBuffer = std::move(buffers[1]);
+			cache.key = 0;
+		}
+	}
+
+	void Application::prepareStaticDraws(const vk::CommandBufferInheritanceRenderingInfo &mainRendering, const vk::CommandBufferInheritanceRenderingInfo &depthRendering) {
+		const auto hash = [](const uint64_t hash, const uint64_t value) { return (hash ^ value) * 0x100000001b3ull; };
+
+		// Everything recorded in the secondaries. The uniform offsets are the same every frame of a slot as long as the
+		// allocations happen in the same order.
+		uint64_t key = 0xcbf29ce484222325ull;
+		for (const uint64_t value: {sceneVersion, pipelineVersion, swapChainVersion, uint64_t{stressDrawCopies}, static_cast<uint64_t>(perDrawPath), uint64_t{depthPrepass}, (uint64_t{renderExtent.width} << 32) | renderExtent.height, uint64_t{frameUniformOffset}, uint64_t{identityObjectOffset}}) {
+			key = hash(key, value);
+		}
+
+		// The draws are sorted front to back from the camera: once it moved far enough from the scene, the order is redone.
+		const glm::vec3 sceneCamera = glm::vec3(glm::inverse(sceneModel) * glm::vec4(frameMailbox.getFront().cameraPosition, 1.0f));
+		const glm::ivec3 sortCell = glm::ivec3(glm::floor(sceneCamera / c_StaticDrawsResortDistance));
+		for (int axis = 0; axis < 3; ++axis) {
+			key = hash(key, static_cast<uint32_t>(sortCell[axis]));
+		}
+
+		if (perDrawPath == PerDrawPath::DynamicUniform) {
+			// The object blocks live in the frame allocator: rewrite them every frame, the draws read them at the same offsets.
+			buildDrawList();
+			key = hash(key, drawList.size() > 1 ? drawList[1].objectOffset : 0);
+		}
+
+		StaticDraws &cache = staticDraws[currentFrame];
+		if (cache.key == key) {
+			return;
+		}
+
+		if (perDrawPath == PerDrawPath::PushConstants) {
+			buildDrawList();
+		}
+
+		// The slot's previous frame completed, nothing pending uses the secondaries.
+		cache.pool.reset();
+		const vk::CommandBufferInheritanceInfo mainInheritance{.pNext = &mainRendering};
+		cache.commandBuffer.begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue, .pInheritanceInfo = &mainInheritance});
+		recordDraws(cache.commandBuffer, 0, static_cast<uint32_t>(drawList.size()));
+		cache.commandBuffer.end();
+
+		const vk::CommandBufferInheritanceInfo depthInheritance{.pNext = &depthRendering};
+		cache.depthCommandBuffer.begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue, .pInheritanceInfo = &depthInheritance});
+		recordDraws(cache.depthCommandBuffer, 0, opaqueDrawCount, true);
+		cache.depthCommandBuffer.end();
+		cache.key = key;
+
+		MVT_LOG_DEBUG(Render, "[Recording] Static draws of slot {} recorded: {} draws.", currentFrame, drawList.size());
+	}
+
+	void Application::buildDrawList() {
+		unsortedDraws.clear();
+		drawQueue.clear();
+
+		// Sort keys: pipeline, material, mesh and a depth bucket, from the distance of the bounds to the camera.
+		const glm::mat4 view = lookAt(frameMailbox.getFront().cameraPosition, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+		constexpr float farPlane = 10.0f;
+		const auto pushDraw = [this, &view](DrawCommand draw, const uint32_t mesh, const glm::vec3 &center) {
+			// Left-handed view: z grows in front of the camera.
+			const glm::vec4 viewPosition = view * sceneModel * draw.model * glm::vec4(center, 1.0f);
+			if (draw.materialIndex < materials.size()) {
+				const GpuMaterial &material = materials[draw.materialIndex];
+				draw.transparent = material.baseColor.a < 1.0f;
+				draw.singleSided = (material.flags & c_MaterialSingleSided) != 0;
+			}
+			drawQueue.push(DrawQueue::MakeKey(draw.transparent ? DrawPass::Transparent : DrawPass::Opaque, 0, draw.materialIndex, mesh, viewPosition.z / farPlane), static_cast<uint32_t>(unsortedDraws.size()));
+			unsortedDraws.push_back(draw);
+		};
+
+		// The dynamic uniform path bumps the frame allocator once per object, the push constant path only needs the identity block.
+		const uint32_t identity = identityObjectOffset;
+		pushDraw(DrawCommand{.vertexBuffer = vertexBuffer, .positionBuffer = positionBuffer, .indexBuffer = indexBuffer, .indexCount = indices_count, .materialIndex = defaultMaterial, .objectOffset = identity}, 0, glm::vec3{0.0f});
+
+		for (uint32_t copy = 0; copy <= stressDrawCopies; ++copy) {
+			// Stress copies are laid out on a grid under the original.
+			const glm::vec3 offset = copy == 0 ? glm::vec3{0.0f} : glm::vec3{static_cast<float>(copy % 32) - 16.0f, static_cast<float>(copy / 32 % 32) - 16.0f, -1.0f - static_cast<float>(copy / 1024)};
+			const glm::mat4 model = glm::translate(glm::mat4(1.0f), offset);
+			const uint32_t objectOffset = perDrawPath == PerDrawPath::DynamicUniform ? frameAllocator.push(ObjectUniform{.model = model}).getDynamicOffset() : identity;
+			for (uint32_t mesh = 0; mesh < m_Meshes.size(); ++mesh) {
+				const VkMesh &vkMesh = m_Meshes[mesh];
+				pushDraw(DrawCommand{.vertexBuffer = vkMesh.m_VertexBuffer, .positionBuffer = vkMesh.m_PositionBuffer, .indexBuffer = vkMesh.m_IndexBuffer, .indexCount = vkMesh.indicesCount, .materialIndex = vkMesh.materialIndex, .objectOffset = objectOffset, .model = model}, mesh + 1, vkMesh.boundsCenter);
+			}
+		}
+
+		drawQueue.sort();
+		drawList.clear();
+		drawList.reserve(unsortedDraws.size());
+		opaqueDrawCount = 0;
+		for (const DrawPacket &packet: drawQueue.getPackets()) {
+			drawList.push_back(unsortedDraws[packet.draw]);
+			opaqueDrawCount += drawList.back().transparent ? 0 : 1;
 		}
+	}
+
+	void Application::recordDraws(const vk::raii::CommandBuffer &commandBuffer, const uint32_t begin, const uint32_t end, const bool depthOnly) const {
+		// Nothing is inherited from the primary but the attachments.
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, depthOnly ? depthPrepassPipeline : graphicsPipeline);
+		commandBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height), 0.0f, 1.0f));
+		commandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), renderExtent));
 
-		transferFence = {device, vk::FenceCreateInfo{}};
+		// After a pre-pass, opaque draws only shade the fragments whose depth was laid, transparent ones test against it.
+		vk::CullModeFlags boundCull = vk::CullModeFlagBits::eNone;
+		bool boundTransparent = false;
+		commandBuffer.setCullMode(boundCull);
+		if (!depthOnly) {
+			commandBuffer.setDepthWriteEnable(!depthPrepass);
+			commandBuffer.setDepthCompareOp(depthPrepass ? vk::CompareOp::eEqual : vk::CompareOp::eLess);
+		}
+
+		// The bindless set is bound once. Set 0 is bound once too with the push constant path, per draw otherwise.
+		if (!depthOnly) {
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 1, bindlessTable.getDescriptorSet(), nullptr);
+		}
+		const vk::DescriptorSet frameSet = descriptorSets[currentFrame];
+		const bool pushTransforms = perDrawPath == PerDrawPath::PushConstants;
+
+		constexpr vk::ShaderStageFlags pushStages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+		constexpr uint32_t materialIndexOffset = offsetof(DrawPushConstants, materialIndex);
+		if (begin < end) {
+			const std::array dynamicOffsets = {frameUniformOffset, drawList[begin].objectOffset};
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, frameSet, dynamicOffsets);
+			// Push constants persist across draws: the uniform path only updates the material index afterward.
+			commandBuffer.pushConstants<DrawPushConstants>(pipelineLayout, pushStages, 0, DrawPushConstants{.model = pushTransforms ? drawList[begin].model : glm::mat4(1.0f)});
+		}
+
+		// The draws are sorted by state, only what changed from the previous draw is bound.
+		vk::Buffer boundVertices{}, boundIndices{};
+		uint32_t boundObject = begin < end ? drawList[begin].objectOffset : 0;
+		uint32_t boundMaterial = ~0u;
+		for (uint32_t i = begin; i < end; ++i) {
+			const DrawCommand &draw = drawList[i];
+			const vk::Buffer vertices = depthOnly ? draw.positionBuffer : draw.vertexBuffer;
+			if (vertices != boundVertices) {
+				commandBuffer.bindVertexBuffers(0, vertices, {0});
+				boundVertices = vertices;
+			}
+			if (draw.indexBuffer != boundIndices) {
+				commandBuffer.bindIndexBuffer(draw.indexBuffer, 0, vk::IndexType::eUint32);
+				boundIndices = draw.indexBuffer;
+			}
+
+			const vk::CullModeFlags cull = draw.singleSided ? vk::CullModeFlagBits::eBack : vk::CullModeFlagBits::eNone;
+			if (cull != boundCull) {
+				commandBuffer.setCullMode(cull);
+				boundCull = cull;
+			}
+			if (!depthOnly && depthPrepass && draw.transparent != boundTransparent) {
+				commandBuffer.setDepthCompareOp(draw.transparent ? vk::CompareOp::eLess : vk::CompareOp::eEqual);
+				boundTransparent = draw.transparent;
+			}
+
+			if (pushTransforms) {
+				commandBuffer.pushConstants<DrawPushConstants>(pipelineLayout, pushStages, 0, DrawPushConstants{.model = draw.model, .materialIndex = draw.materialIndex});
+			}
+			else {
+				if (draw.objectOffset != boundObject) {
+					const std::array dynamicOffsets = {frameUniformOffset, draw.objectOffset};
+					commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, frameSet, dynamicOffsets);
+					boundObject = draw.objectOffset;
+				}
+				if (draw.materialIndex != boundMaterial) {
+					commandBuffer.pushConstants<uint32_t>(pipelineLayout, pushStages, materialIndexOffset, draw.materialIndex);
+					boundMaterial = draw.materialIndex;
+				}
+			}
+			commandBuffer.drawIndexed(draw.indexCount, 1, 0, 0, 0);
+		}
 	}
 
 	void Application::recordCommandBuffer(const uint32_t imageIndex) {
+		updateFrameControllers();
+		// The targets keep the swapchain size, only the viewport follows the scale.
+		renderExtent = dynamicResolution.isEnabled() ? dynamicResolution.getRenderExtent(swapChainExtent) : swapChainExtent;
+
 		commandBuffers[currentFrame].begin({});
+		frameTimer.reset(commandBuffers[currentFrame], 2 * currentFrame, 2);
+		frameTimer.write(commandBuffers[currentFrame], vk::PipelineStageFlagBits2::eTopOfPipe, 2 * currentFrame);
+
+		if (textureResidency.isValid()) {
+			textureResidency.record(commandBuffers[currentFrame], frameCount, frameScratch);
+			if (textureResidency.consumeSlotChanges()) {
+				refreshStreamedMaterials();
+				// More mips may be on the way, keep drawing until the streaming settles.
+				requestRedraw();
+			}
+		}
+
+		// The secondaries only inherit the attachment formats of the pass executing them.
+		const vk::CommandBufferInheritanceRenderingInfo mainRendering{
+			.colorAttachmentCount = 1,
+			.pColorAttachmentFormats = &swapChainImageFormat,
+			.depthAttachmentFormat = depthFormat,
+			.rasterizationSamples = msaaSamples,
+		};
+		const vk::CommandBufferInheritanceRenderingInfo depthRendering{
+			.colorAttachmentCount = 0,
+			.depthAttachmentFormat = depthFormat,
+			.rasterizationSamples = msaaSamples,
+		};
+
+		// Both passes are recorded before the graph runs: by the recording threads, or once per slot for static scenes.
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		std::span<const vk::CommandBuffer> mainSecondaries;
+		std::array<vk::CommandBuffer, 2> staticSecondaries{};
+		if (staticDrawsEnabled) {
+			prepareStaticDraws(mainRendering, depthRendering);
+			staticSecondaries = {*staticDraws[currentFrame].depthCommandBuffer, *staticDraws[currentFrame].commandBuffer};
+			depthSecondaries.assign(staticSecondaries.begin(), staticSecondaries.begin() + 1);
+			mainSecondaries = {&staticSecondaries[1], 1};
+		}
+		else {
+			buildDrawList();
+			parallelRecorder->beginFrame(currentFrame);
+			depthSecondaries.clear();
+			if (depthPrepass) {
+				// Copied: the next `record` reuses the recorder's output.
+				const auto recorded = parallelRecorder->record(currentFrame, depthRendering, opaqueDrawCount, c_MinDrawsPerRecordingThread, [this](const vk::raii::CommandBuffer &secondary, const uint32_t begin, const uint32_t end) {
+					recordDraws(secondary, begin, end, true);
+				});
+				depthSecondaries.assign(recorded.begin(), recorded.end());
+			}
+			mainSecondaries = parallelRecorder->record(currentFrame, mainRendering, static_cast<uint32_t>(drawList.size()), c_MinDrawsPerRecordingThread, [this](const vk::raii::CommandBuffer &secondary, const uint32_t begin, const uint32_t end) {
+				recordDraws(secondary, begin, end);
+			});
+		}
+
+		recordingMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		if (++recordingSamples == c_RecordingReportInterval) {
+			const RenderGraphStats &stats = renderGraph.getStats();
+			const double milliseconds = recordingMilliseconds / recordingSamples;
+			const char *pathName = perDrawPath == PerDrawPath::PushConstants ? "push constants" : "dynamic uniform";
+			MVT_LOG_INFO(Render, "[Recording] {} draws in {} secondaries ({}): {:.3f} ms", drawList.size(), mainSecondaries.size() + (depthPrepass ? depthSecondaries.size() : 0), pathName, milliseconds);
+			MVT_LOG_INFO(Render, "[RenderGraph] {} pass(es), {} culled, {} barrier(s) in {} batch(es).", stats.passes, stats.culledPasses, stats.barriers, stats.barrierBatches);
+			if (perDrawBenchmark) {
+				perDrawMilliseconds[static_cast<uint32_t>(perDrawPath)] = milliseconds;
+				if (perDrawPath == PerDrawPath::DynamicUniform) {
+					MVT_LOG_INFO(Render, "[PerDraw] {} draws: push constants {:.3f} ms, dynamic uniform {:.3f} ms", drawList.size(), perDrawMilliseconds[0], perDrawMilliseconds[1]);
+				}
+				perDrawPath = perDrawPath == PerDrawPath::PushConstants ? PerDrawPath::DynamicUniform : PerDrawPath::PushConstants;
+			}
+			recordingMilliseconds = 0.0;
+			recordingSamples = 0;
+		}
+
+		// The MSAA color and the depth only live for the frame, the graph places them and emits every barrier.
+		renderGraph.reset(frameScratch);
+		const RenderGraphHandle backbuffer = renderGraph.importImage("Backbuffer", RenderGraphImportedImage{
+			.image = swapChainImages[imageIndex], .view = swapChainImageViews[imageIndex],
+			.desc = {.format = swapChainImageFormat, .extent = swapChainExtent},
+			// Chains with the acquire semaphore, waited at the color attachment output stage.
+			.initialLayout = vk::ImageLayout::eUndefined, .initialStages = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+			.finalLayout = vk::ImageLayout::ePresentSrcKHR,
+		});
+		// Without dynamic resolution, the scene is drawn in the backbuffer without anti-aliasing, resolved in it with MSAA,
+		// filtered then blitted in it with FXAA. With it, the scene always ends in an offscreen target upscaled by a blit.
+		const AntiAliasingMode antiAliasingMode = antiAliasing.getMode();
+		const bool upscale = dynamicResolution.isEnabled();
+		const bool resolve = antiAliasingMode == AntiAliasingMode::Msaa;
+		const bool offscreen = upscale || antiAliasingMode == AntiAliasingMode::Fxaa;
+		const RenderGraphHandle scene = offscreen ? renderGraph.createImage("Scene", {.format = swapChainImageFormat, .extent = swapChainExtent}) : backbuffer;
+		const RenderGraphHandle color = resolve ? renderGraph.createImage("Color", {.format = swapChainImageFormat, .extent = swapChainExtent, .samples = msaaSamples}) : scene;
+		const RenderGraphHandle depth = renderGraph.createImage("Depth", {.format = depthFormat, .extent = swapChainExtent, .samples = msaaSamples});
 
-		auto& swapImg = swapChainImages[imageIndex];
-		auto& swapVw = swapChainImageViews[imageIndex];
-		auto& depthImg = depthImages[frameCount % depthCount];
-		auto& depthVw = depthImageViews[frameCount % depthCount];
-		auto& colorImg = colorImages[frameCount % depthCount];
-		auto& colorVw = colorImageViews[frameCount % depthCount];
-
-		// Before starting rendering, transition the swapchain image to COLOR_ATTACHMENT_OPTIMAL
-		transition_image_layout(
-			swapImg,
-			vk::ImageLayout::eUndefined,
-			vk::ImageLayout::eColorAttachmentOptimal,
-			{}, // srcAccessMask (no need to wait for previous operations)
-			vk::AccessFlagBits2::eColorAttachmentWrite, // dstAccessMask
-			vk::PipelineStageFlagBits2::eColorAttachmentOutput, // srcStage
-			vk::PipelineStageFlagBits2::eColorAttachmentOutput // dstStage
-			, vk::ImageAspectFlagBits::eColor
-		);
-		transition_image_layout(
-			colorImg,
-			vk::ImageLayout::eUndefined,
-			vk::ImageLayout::eColorAttachmentOptimal,
-			vk::AccessFlagBits2::eColorAttachmentWrite, // srcAccessMask
-			vk::AccessFlagBits2::eColorAttachmentWrite, // dstAccessMask
-			vk::PipelineStageFlagBits2::eColorAttachmentOutput, // srcStage
-			vk::PipelineStageFlagBits2::eColorAttachmentOutput // dstStage
-			, vk::ImageAspectFlagBits::eColor
-		);
-		transition_image_layout(
-			depthImg,
-			vk::ImageLayout::eUndefined,
-			vk::ImageLayout::eDepthAttachmentOptimal,
-			vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
-			vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
-			vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
-			vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
-			vk::ImageAspectFlagBits::eDepth);
-
-		// Clear buffer with clear color
-#ifdef MVT_DEBUG
-		vk::ClearValue clearColor = vk::ClearColorValue(1.0f, 0.0f, 0.5f, 1.0f);
-#else
-		vk::ClearValue clearColor = vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f);
-#endif
 		vk::ClearValue clearDepth = vk::ClearDepthStencilValue(1.0f, 0);
 
-		vk::RenderingAttachmentInfo attachmentInfo = {
-			.imageView = colorVw,
-			.imageLayout = vk::ImageLayout::eColorAttachmentOptimal,
-			.resolveMode        = vk::ResolveModeFlagBits::eAverage,
-			.resolveImageView   = swapVw,
-			.resolveImageLayout = vk::ImageLayout::eColorAttachmentOptimal,
-			.loadOp = vk::AttachmentLoadOp::eClear,
-			.storeOp = vk::AttachmentStoreOp::eStore,
-			.clearValue = clearColor
-		};
+		if (depthPrepass) {
+			renderGraph.addPass("DepthPrepass", [this, depth, clearDepth](const vk::raii::CommandBuffer &commandBuffer, const RenderGraph &graph) {
+				const vk::RenderingAttachmentInfo depthAttachmentInfo = {
+					.imageView = graph.getImageView(depth),
+					.imageLayout = RenderGraph::GetAccessInfo(RenderGraphAccess::DepthAttachmentWrite).layout,
+					.loadOp = vk::AttachmentLoadOp::eClear,
+					.storeOp = vk::AttachmentStoreOp::eStore,
+					.clearValue = clearDepth
+				};
+				const vk::RenderingInfo renderingInfo = {
+					.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers,
+					.renderArea = {.offset = {0, 0}, .extent = renderExtent},
+					.layerCount = 1,
+					.pDepthAttachment = &depthAttachmentInfo,
+				};
 
-		vk::RenderingAttachmentInfo depthAttachmentInfo = {
-			.imageView = depthVw,
-			.imageLayout = vk::ImageLayout::eDepthAttachmentOptimal,
-			.loadOp = vk::AttachmentLoadOp::eClear,
-			.storeOp = vk::AttachmentStoreOp::eDontCare,
-			.clearValue = clearDepth
-		};
+				commandBuffer.beginRendering(renderingInfo);
+				commandBuffer.executeCommands(depthSecondaries);
+				commandBuffer.endRendering();
+			})
+			.write(depth, RenderGraphAccess::DepthAttachmentWrite);
+		}
 
-		vk::RenderingInfo renderingInfo = {
-			.renderArea = {.offset = {0, 0}, .extent = swapChainExtent},
-			.layerCount = 1,
-			.colorAttachmentCount = 1,
-			.pColorAttachments = &attachmentInfo,
-			.pDepthAttachment = &depthAttachmentInfo,
-		}; {
-			commandBuffers[currentFrame].beginRendering(renderingInfo);
+		const RenderGraphAccess depthAccess = depthPrepass ? RenderGraphAccess::DepthAttachmentRead : RenderGraphAccess::DepthAttachmentWrite;
+		auto mainPass = renderGraph.addPass("Main", [this, scene, color, resolve, depth, depthAccess, clearDepth, mainSecondaries](const vk::raii::CommandBuffer &commandBuffer, const RenderGraph &graph) {
+			// Clear buffer with clear color
+#ifdef MVT_DEBUG
+			vk::ClearValue clearColor = vk::ClearColorValue(1.0f, 0.0f, 0.5f, 1.0f);
+#else
+			vk::ClearValue clearColor = vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f);
+#endif
 
-			commandBuffers[currentFrame].bindPipeline(vk::PipelineBindPoint::eGraphics, graphicsPipeline);
-			commandBuffers[currentFrame].setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(swapChainExtent.width), static_cast<float>(swapChainExtent.height), 0.0f, 1.0f));
-			commandBuffers[currentFrame].setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), swapChainExtent));
+			vk::RenderingAttachmentInfo attachmentInfo = {
+				.imageView = graph.getImageView(color),
+				.imageLayout = vk::ImageLayout::eColorAttachmentOptimal,
+				.resolveMode        = resolve ? vk::ResolveModeFlagBits::eAverage : vk::ResolveModeFlagBits::eNone,
+				.resolveImageView   = resolve ? graph.getImageView(scene) : vk::ImageView{},
+				.resolveImageLayout = vk::ImageLayout::eColorAttachmentOptimal,
+				.loadOp = vk::AttachmentLoadOp::eClear,
+				.storeOp = resolve ? vk::AttachmentStoreOp::eDontCare : vk::AttachmentStoreOp::eStore,
+				.clearValue = clearColor
+			};
 
-			commandBuffers[currentFrame].bindVertexBuffers(0, *vertexBuffer, {0});
-			commandBuffers[currentFrame].bindIndexBuffer(*indexBuffer, 0, vk::IndexType::eUint32);
+			vk::RenderingAttachmentInfo depthAttachmentInfo = {
+				.imageView = graph.getImageView(depth),
+				.imageLayout = RenderGraph::GetAccessInfo(depthAccess).layout,
+				.loadOp = depthPrepass ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eClear,
+				.storeOp = vk::AttachmentStoreOp::eDontCare,
+				.clearValue = clearDepth
+			};
 
-			commandBuffers[currentFrame].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, *descriptorSets[currentFrame], nullptr);
-			commandBuffers[currentFrame].drawIndexed(indices_count, 1, 0, 0, 0);
+			// The draws are recorded in secondaries by the recording threads, the primary only executes them.
+			vk::RenderingInfo renderingInfo = {
+				.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers,
+				.renderArea = {.offset = {0, 0}, .extent = renderExtent},
+				.layerCount = 1,
+				.colorAttachmentCount = 1,
+				.pColorAttachments = &attachmentInfo,
+				.pDepthAttachment = &depthAttachmentInfo,
+			};
 
-			for (auto& mesh : m_Meshes) {
-				commandBuffers[currentFrame].bindVertexBuffers(0, *mesh.m_VertexBuffer, {0});
-				commandBuffers[currentFrame].bindIndexBuffer(*mesh.m_IndexBuffer, 0, vk::IndexType::eUint32);
+			commandBuffer.beginRendering(renderingInfo);
+			commandBuffer.executeCommands(mainSecondaries);
+			commandBuffer.endRendering();
+		});
+		mainPass.write(color, RenderGraphAccess::ColorAttachmentWrite);
+		if (resolve) {
+			mainPass.write(scene, RenderGraphAccess::ColorAttachmentWrite);
+		}
+		if (depthPrepass) {
+			mainPass.read(depth, depthAccess);
+		}
+		else {
+			mainPass.write(depth, depthAccess);
+		}
 
-				commandBuffers[currentFrame].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, *descriptorSets[currentFrame], nullptr);
-				commandBuffers[currentFrame].drawIndexed(mesh.indicesCount, 1, 0, 0, 0);
-			}
+		RenderGraphHandle output = scene;
+		if (antiAliasingMode == AntiAliasingMode::Fxaa) {
+			output = renderGraph.createImage("Antialiased", {.format = FxaaPass::c_OutputFormat, .extent = swapChainExtent});
+			renderGraph.addPass("FXAA", [this, scene, output](const vk::raii::CommandBuffer &commandBuffer, const RenderGraph &graph) {
+				fxaaPass.record(commandBuffer, currentFrame, graph.getImageView(scene), graph.getImageView(output), renderExtent, swapChainExtent);
+			})
+			.read(scene, RenderGraphAccess::SampledRead)
+			.write(output, RenderGraphAccess::StorageWrite);
+		}
 
-			commandBuffers[currentFrame].endRendering();
+		if (output != backbuffer) {
+			// Stretch the rendered corner over the whole swapchain image, a plain copy at full resolution.
+			renderGraph.addPass("Blit", [this, output, backbuffer](const vk::raii::CommandBuffer &commandBuffer, const RenderGraph &graph) {
+				vk::ArrayWrapper1D<vk::Offset3D, 2> offsets, dstOffsets;
+				offsets[0] = vk::Offset3D(0, 0, 0);
+				offsets[1] = vk::Offset3D(static_cast<int32_t>(renderExtent.width), static_cast<int32_t>(renderExtent.height), 1);
+				dstOffsets[0] = vk::Offset3D(0, 0, 0);
+				dstOffsets[1] = vk::Offset3D(static_cast<int32_t>(swapChainExtent.width), static_cast<int32_t>(swapChainExtent.height), 1);
+				const vk::ImageBlit blit = {
+					.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1), .srcOffsets = offsets,
+					.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1), .dstOffsets = dstOffsets
+				};
+				const bool scaled = renderExtent != swapChainExtent;
+				commandBuffer.blitImage(graph.getImage(output), vk::ImageLayout::eTransferSrcOptimal, graph.getImage(backbuffer), vk::ImageLayout::eTransferDstOptimal, {blit}, scaled ? vk::Filter::eLinear : vk::Filter::eNearest);
+			})
+			.read(output, RenderGraphAccess::TransferRead)
+			.write(backbuffer, RenderGraphAccess::TransferWrite);
 		}
 
-		// After rendering, transition the swapchain image to PRESENT_SRC
-		transition_image_layout(
-			swapImg,
-			vk::ImageLayout::eColorAttachmentOptimal,
-			vk::ImageLayout::ePresentSrcKHR,
-			vk::AccessFlagBits2::eColorAttachmentWrite, // srcAccessMask
-			{}, // dstAccessMask
-			vk::PipelineStageFlagBits2::eColorAttachmentOutput, // srcStage
-			vk::PipelineStageFlagBits2::eBottomOfPipe // dstStage
-			, vk::ImageAspectFlagBits::eColor
-		);
+		renderGraph.compile(currentFrame);
+		renderGraph.execute(commandBuffers[currentFrame]);
 
+		frameTimer.write(commandBuffers[currentFrame], vk::PipelineStageFlagBits2::eBottomOfPipe, 2 * currentFrame + 1);
+		frameTimerPending[currentFrame] = frameTimer.isValid();
 		commandBuffers[currentFrame].end();
 	}
 
-#define PRINT_GLM_VAR(VAR) std::cout << #VAR << ":\n" << glm::to_string(VAR) << std::endl;
-
-	void Application::updateUniformBuffer(const uint32_t currentImage) {
-		static auto startTime = std::chrono::high_resolution_clock::now();
+#define PRINT_GLM_VAR(VAR) MVT_LOG_DEBUG(Render, "{}:\n{}", #VAR, glm::to_string(VAR));
 
-		const auto currentTime = std::chrono::high_resolution_clock::now();
-		const float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+	void Application::updateUniformBuffer() {
+		// Camera and animation come from the latest packet of the main thread.
+		const FramePacket &packet = frameMailbox.getFront();
 
 		UniformBufferObject ubo{};
 		//
@@ -1500,51 +2635,15 @@ namespace MVT {
 		// ubo.view = glm::identity<glm::mat4x4>();
 		// ubo.proj = glm::identity<glm::mat4x4>();
 
-		ubo.model = rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		ubo.view = lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		ubo.proj = glm::perspective(glm::radians(45.0f), static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height), 0.1f, 10.0f);
+		ubo.model = packet.sceneModel;
+		sceneModel = ubo.model;
+		ubo.view = lookAt(packet.cameraPosition, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+		ubo.proj = glm::perspective(glm::radians(packet.cameraFovDegrees), static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height), 0.1f, 10.0f);
 		ubo.proj[1][1] *= -1;
 
 
-		memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
-	}
-
-	void Application::transition_image_layout(
-		vk::Image image,
-		vk::ImageLayout oldLayout,
-		vk::ImageLayout newLayout,
-		vk::AccessFlags2 srcAccessMask,
-		vk::AccessFlags2 dstAccessMask,
-		vk::PipelineStageFlags2 srcStageMask,
-		vk::PipelineStageFlags2 dstStageMask,
-		vk::ImageAspectFlags image_aspect_flags
-	) {
-		vk::ImageMemoryBarrier2 barrier = {
-			.srcStageMask = srcStageMask,
-			.srcAccessMask = srcAccessMask,
-			.dstStageMask = dstStageMask,
-			.dstAccessMask = dstAccessMask,
-			.oldLayout = oldLayout,
-			.newLayout = newLayout,
-			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-			.image = image, //swapChainImages[imageIndex],
-			.subresourceRange = {
-				.aspectMask = image_aspect_flags,
-				.baseMipLevel = 0,
-				.levelCount = 1,
-				.baseArrayLayer = 0,
-				.layerCount = 1
-			}
-		};
-
-		vk::DependencyInfo dependencyInfo = {
-			.dependencyFlags = {},
-			.imageMemoryBarrierCount = 1,
-			.pImageMemoryBarriers = &barrier
-		};
-
-		commandBuffers[currentFrame].pipelineBarrier2(dependencyInfo);
+		frameUniformOffset = frameAllocator.push(ubo).getDynamicOffset();
+		identityObjectOffset = frameAllocator.push(ObjectUniform{.model = glm::mat4(1.0f)}).getDynamicOffset();
 	}
 
 	// void Application::transferBufferQueue(const vk::Buffer &buffer, QueueType oldQueue, QueueType newQueue, vk::PipelineStageFlags src, vk::PipelineStageFlags dst) {
@@ -1566,48 +2665,40 @@ namespace MVT {
 
 
 	void Application::transitionImageLayout(const vk::raii::Image &image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, QueueType type, uint32_t mipLevels) {
-		vk::PipelineStageFlags sourceStage;
-		vk::PipelineStageFlags destinationStage;
-		vk::ImageMemoryBarrier barrier{.oldLayout = oldLayout, .newLayout = newLayout, .image = image, .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, mipLevels, 0, 1}};
-
-		if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal) {
-			barrier.srcAccessMask = {};
-			barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-
-			sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-			destinationStage = vk::PipelineStageFlagBits::eTransfer;
-			barrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
-			barrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
-		}
-		else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-			barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-			sourceStage = vk::PipelineStageFlagBits::eTransfer;
-			destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
-			barrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored; //transferFamily;
-			barrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored; //graphicsFamily;
-			// type = QueueType::Graphics;
-		}
-		else {
-			throw std::invalid_argument("unsupported layout transition!");
-		}
+		const vk::ImageMemoryBarrier2 barrier = MakeLayoutBarrier(image, oldLayout, newLayout, mipLevels);
 
 		auto cmd = beginSingleTimeCommands(type);
-		cmd.pipelineBarrier(sourceStage, destinationStage, {}, {}, nullptr, barrier);
-		endSingleTimeCommands(cmd, type, false);
+		cmd.pipelineBarrier2(vk::DependencyInfo{.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &barrier});
+		endSingleTimeCommands(cmd, type);
+	}
+
+	vk::ImageMemoryBarrier2 Application::MakeLayoutBarrier(const vk::Image image, const vk::ImageLayout oldLayout, const vk::ImageLayout newLayout, const uint32_t mipLevels) {
+		// Same stage and access tables as the render graph, so any pair of layouts it knows is supported.
+		const RenderGraphAccessInfo src = RenderGraph::GetLayoutAccessInfo(oldLayout);
+		const RenderGraphAccessInfo dst = RenderGraph::GetLayoutAccessInfo(newLayout);
+		return vk::ImageMemoryBarrier2{
+			.srcStageMask = src.stages, .srcAccessMask = src.write ? src.access : vk::AccessFlags2{},
+			.dstStageMask = dst.stages, .dstAccessMask = dst.access,
+			.oldLayout = oldLayout, .newLayout = newLayout,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.image = image, .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, mipLevels, 0, 1}
+		};
 	}
 
 	void Application::copyBufferToImage(const vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height, QueueType queue) {
-		auto cmd = beginSingleTimeCommands(queue);
 		vk::BufferImageCopy region{.bufferOffset = 0, .bufferRowLength = 0, .bufferImageHeight = 0, .imageSubresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, .imageOffset = {0, 0, 0}, .imageExtent = {width, height, 1}};
-		cmd.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, {region});
-		endSingleTimeCommands(cmd, queue, false);
+		copyBufferToImage(buffer, image, std::vector{region}, queue);
 		// if (queue == QueueType::Graphics) {
 		// 	waitAndResetFence();
 		// }
 	}
 
+	void Application::copyBufferToImage(const vk::Buffer buffer, vk::Image image, const std::vector<vk::BufferImageCopy> &regions, QueueType queue) {
+		auto cmd = beginSingleTimeCommands(queue);
+		cmd.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, regions);
+		endSingleTimeCommands(cmd, queue);
+	}
+
 	vk::SurfaceFormatKHR Application::chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR> &availableFormats) {
 		for (const auto &availableFormat: availableFormats) {
 			if (availableFormat.format == vk::Format::eB8G8R8A8Srgb && availableFormat.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear) {
@@ -1636,7 +2727,9 @@ namespace MVT {
 			return capabilities.currentExtent;
 		}
 
-		const auto [width, height] = GetFramebufferSize();
+		// Past the initialization, the render thread takes the size the main thread saw.
+		const vk::Extent2D packetExtent = frameMailbox.getFront().framebufferExtent;
+		const auto [width, height] = packetExtent.width > 0 ? std::pair<int, int>(packetExtent.width, packetExtent.height) : GetFramebufferSize();
 
 		return {
 			std::clamp<uint32_t>(width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width),
@@ -1662,28 +2755,43 @@ namespace MVT {
 		throw std::runtime_error("failed to find suitable memory type!");
 	}
 
-	void Application::copyBuffer(const vk::raii::Buffer &srcBuffer, const vk::raii::Buffer &vk_buffer, const vk::DeviceSize size, vk::Fence fence, vk::CommandPool pool, vk::Queue queue) {
+	void Application::copyBuffer(const vk::raii::Buffer &srcBuffer, const vk::raii::Buffer &vk_buffer, const vk::DeviceSize size, vk::CommandPool pool, vk::Queue queue) {
 		auto cmd = beginSingleTimeCommands(pool);
 		assert(*cmd);
 		// transferCommands[currentFrame].begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
 		cmd.copyBuffer(srcBuffer, vk_buffer, vk::BufferCopy(0, 0, size));
-		endSingleTimeCommands(cmd, queue, fence);
+		endSingleTimeCommands(cmd, queue);
 	}
 
 	void Application::cleanupSwapChain() {
+		retiredSwapChains.clear();
 		swapChainImageViews.clear();
 
 		swapChain = nullptr;
 	}
 
 	void Application::recreateSwapChain() {
-		device.waitIdle();
-
-		cleanupSwapChain();
-
-		createSwapChain();
+		// The frames in flight still present the old images, and wait on its render finished semaphores.
+		retiredSwapChains.push_back(RetiredSwapChain{
+			.swapChain = std::move(swapChain),
+			.imageViews = std::move(swapChainImageViews),
+			.renderFinishedSemaphores = std::move(renderFinishedSemaphores),
+			.value = frameScheduler.getLastSubmittedValue(),
+			.frame = frameScheduler.getFrameCount(),
+		});
+
+		createSwapChain(*retiredSwapChains.back().swapChain);
 		createSwapChainViews();
-		createDepthResources();
+		createRenderFinishedSemaphores();
+		// The size dependent attachments are render graph transients, each frame slot rebuilds them on its next frame.
+	}
+
+	void Application::releaseRetiredSwapChains() {
+		// The timeline only covers rendering, not presentation: also let a few frames go through the new swapchain
+		// so the presentation engine is done with the old images and semaphores.
+		std::erase_if(retiredSwapChains, [this](const RetiredSwapChain &retired) {
+			return frameScheduler.isComplete(retired.value) && frameScheduler.getFrameCount() >= retired.frame + MAX_FRAMES_IN_FLIGHT;
+		});
 	}
 
 	vk::raii::CommandBuffer Application::beginSingleTimeCommands(QueueType type) {
@@ -1713,26 +2821,25 @@ namespace MVT {
 		return commandBuffer;
 	}
 
-	void Application::endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, QueueType type, bool fence) {
+	void Application::endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, QueueType type) {
 		switch (type) {
 			case QueueType::Present:
-				endSingleTimeCommands(commandBuffer, presentQueue, nullptr);
+				endSingleTimeCommands(commandBuffer, presentQueue);
 				break;
 			case QueueType::Transfer:
-			// endSingleTimeCommands(commandBuffer, transferQueue, fence ? *transferFence : nullptr);
+			// endSingleTimeCommands(commandBuffer, transferQueue);
 			// break;
 			case QueueType::Graphics:
-				endSingleTimeCommands(commandBuffer, graphicsQueue, fence ? *transferFence : nullptr);
+				endSingleTimeCommands(commandBuffer, graphicsQueue);
 				break;
 		}
 	}
 
-	void Application::endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, vk::Queue queue, vk::Fence fence) {
+	void Application::endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer, vk::Queue queue) {
 		commandBuffer.end();
 
-		vk::SubmitInfo submitInfo{.commandBufferCount = 1, .pCommandBuffers = &*commandBuffer};
-		queue.submit(submitInfo, fence);
-		queue.waitIdle();
+		const vk::CommandBufferSubmitInfo commandBufferInfo{.commandBuffer = commandBuffer};
+		frameScheduler.wait(frameScheduler.submit(queue, {&commandBufferInfo, 1}));
 	}
 
 	uint32_t Application::getFamilyIndex(const QueueType type) const {
@@ -1751,25 +2858,6 @@ namespace MVT {
 		return -1;
 	}
 
-	vk::SampleCountFlagBits Application::getMaxUsableSampleCount() const {
-		return getMaxUsableSampleCount(physicalDevice);
-	}
-
-	vk::SampleCountFlagBits Application::getMaxUsableSampleCount(const vk::PhysicalDevice device) const {
-		const vk::PhysicalDeviceProperties physicalDeviceProperties = device.getProperties();
-
-		const vk::SampleCountFlags counts = physicalDeviceProperties.limits.framebufferColorSampleCounts & physicalDeviceProperties.limits.framebufferDepthSampleCounts;
-		if (counts & vk::SampleCountFlagBits::e64) { return vk::SampleCountFlagBits::e64; }
-		if (counts & vk::SampleCountFlagBits::e32) { return vk::SampleCountFlagBits::e32; }
-		if (counts & vk::SampleCountFlagBits::e16) { return vk::SampleCountFlagBits::e16; }
-		if (counts & vk::SampleCountFlagBits::e8) { return vk::SampleCountFlagBits::e8; }
-		if (counts & vk::SampleCountFlagBits::e4) { return vk::SampleCountFlagBits::e4; }
-		if (counts & vk::SampleCountFlagBits::e2) { return vk::SampleCountFlagBits::e2; }
-
-		return vk::SampleCountFlagBits::e1;
-
-	}
-
 	std::vector<const char *> Application::GetExtensions() {
 		std::vector<const char *> vecExtensions;
 		Uint32 extensionCount;
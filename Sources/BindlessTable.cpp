@@ -0,0 +1,157 @@
+//
+// Created by ianpo on 06/01/2026.
+//
+
+#include "MVT/BindlessTable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace MVT {
+	uint32_t BindlessTable::SlotAllocator::allocate() {
+		if (!freeSlots.empty()) {
+			const uint32_t slot = freeSlots.back();
+			freeSlots.pop_back();
+			return slot;
+		}
+
+		if (next >= capacity) {
+			return c_InvalidSlot;
+		}
+
+		return next++;
+	}
+
+	void BindlessTable::SlotAllocator::release(const uint32_t slot) {
+		if (slot < next) {
+			freeSlots.push_back(slot);
+		}
+	}
+
+	BindlessTable::BindlessTable(const vk::raii::Device &device, const vk::raii::PhysicalDevice &physicalDevice, const BindlessCapacity capacity) : m_Device(&device) {
+		const auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+		const auto &limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+		m_Textures.capacity = std::min({capacity.textures, limits.maxPerStageDescriptorUpdateAfterBindSampledImages, limits.maxDescriptorSetUpdateAfterBindSampledImages});
+		m_Samplers.capacity = std::min({capacity.samplers, limits.maxPerStageDescriptorUpdateAfterBindSamplers, limits.maxDescriptorSetUpdateAfterBindSamplers});
+		m_Buffers.capacity = std::min({capacity.buffers, limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers, limits.maxDescriptorSetUpdateAfterBindStorageBuffers});
+
+		constexpr vk::ShaderStageFlags stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute;
+		const std::array bindings{
+			vk::DescriptorSetLayoutBinding(GetBinding(BindlessResource::Texture), vk::DescriptorType::eSampledImage, m_Textures.capacity, stages, nullptr),
+			vk::DescriptorSetLayoutBinding(GetBinding(BindlessResource::Sampler), vk::DescriptorType::eSampler, m_Samplers.capacity, stages, nullptr),
+			vk::DescriptorSetLayoutBinding(GetBinding(BindlessResource::Buffer), vk::DescriptorType::eStorageBuffer, m_Buffers.capacity, stages, nullptr),
+		};
+
+		constexpr vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+		const std::array flags{bindingFlags, bindingFlags, bindingFlags};
+
+		const vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{.bindingCount = static_cast<uint32_t>(flags.size()), .pBindingFlags = flags.data()};
+		const vk::DescriptorSetLayoutCreateInfo layoutInfo{
+			.pNext = &bindingFlagsInfo,
+			.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+			.bindingCount = static_cast<uint32_t>(bindings.size()),
+			.pBindings = bindings.data(),
+		};
+		m_DescriptorSetLayout = vk::raii::DescriptorSetLayout(device, layoutInfo);
+
+		const std::array poolSizes{
+			vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, m_Textures.capacity),
+			vk::DescriptorPoolSize(vk::DescriptorType::eSampler, m_Samplers.capacity),
+			vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, m_Buffers.capacity),
+		};
+		const vk::DescriptorPoolCreateInfo poolInfo{
+			.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind | vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+			.maxSets = 1,
+			.poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+			.pPoolSizes = poolSizes.data()
+		};
+		m_DescriptorPool = vk::raii::DescriptorPool(device, poolInfo);
+
+		const vk::DescriptorSetAllocateInfo allocInfo{.descriptorPool = m_DescriptorPool, .descriptorSetCount = 1, .pSetLayouts = &*m_DescriptorSetLayout};
+		m_DescriptorSet = std::move(device.allocateDescriptorSets(allocInfo).front());
+	}
+
+	uint32_t BindlessTable::allocateTexture(const vk::ImageView view, const vk::ImageLayout layout) {
+		const uint32_t slot = m_Textures.allocate();
+		if (slot == c_InvalidSlot) {
+			throw std::runtime_error("[Vulkan] The bindless texture table is full!");
+		}
+
+		updateTexture(slot, view, layout);
+		return slot;
+	}
+
+	uint32_t BindlessTable::allocateSampler(const vk::Sampler sampler) {
+		const uint32_t slot = m_Samplers.allocate();
+		if (slot == c_InvalidSlot) {
+			throw std::runtime_error("[Vulkan] The bindless sampler table is full!");
+		}
+
+		const vk::DescriptorImageInfo imageInfo{.sampler = sampler};
+		const vk::WriteDescriptorSet write{.dstSet = m_DescriptorSet, .dstBinding = GetBinding(BindlessResource::Sampler), .dstArrayElement = slot, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eSampler, .pImageInfo = &imageInfo};
+		m_Device->updateDescriptorSets(write, {});
+		return slot;
+	}
+
+	uint32_t BindlessTable::allocateBuffer(const vk::Buffer buffer, const vk::DeviceSize offset, const vk::DeviceSize range) {
+		const uint32_t slot = m_Buffers.allocate();
+		if (slot == c_InvalidSlot) {
+			throw std::runtime_error("[Vulkan] The bindless buffer table is full!");
+		}
+
+		const vk::DescriptorBufferInfo bufferInfo{.buffer = buffer, .offset = offset, .range = range};
+		const vk::WriteDescriptorSet write{.dstSet = m_DescriptorSet, .dstBinding = GetBinding(BindlessResource::Buffer), .dstArrayElement = slot, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = &bufferInfo};
+		m_Device->updateDescriptorSets(write, {});
+		return slot;
+	}
+
+	void BindlessTable::updateTexture(const uint32_t slot, const vk::ImageView view, const vk::ImageLayout layout) const {
+		const vk::DescriptorImageInfo imageInfo{.imageView = view, .imageLayout = layout};
+		const vk::WriteDescriptorSet write{.dstSet = m_DescriptorSet, .dstBinding = GetBinding(BindlessResource::Texture), .dstArrayElement = slot, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eSampledImage, .pImageInfo = &imageInfo};
+		m_Device->updateDescriptorSets(write, {});
+	}
+
+	void BindlessTable::release(const BindlessResource type, const uint32_t slot) {
+		if (slot == c_InvalidSlot) return;
+		// Partially bound: the stale descriptor stays in place but is never read again.
+		getAllocator(type).release(slot);
+	}
+
+	uint32_t BindlessTable::getCapacity(const BindlessResource type) const {
+		return getAllocator(type).capacity;
+	}
+
+	uint32_t BindlessTable::getUsedCount(const BindlessResource type) const {
+		return getAllocator(type).used();
+	}
+
+	void BindlessTable::clear() {
+		m_DescriptorSet.clear();
+		m_DescriptorPool.clear();
+		m_DescriptorSetLayout.clear();
+		m_Textures = {};
+		m_Samplers = {};
+		m_Buffers = {};
+		m_Device = nullptr;
+	}
+
+	BindlessTable::SlotAllocator &BindlessTable::getAllocator(const BindlessResource type) {
+		switch (type) {
+			case BindlessResource::Texture: return m_Textures;
+			case BindlessResource::Sampler: return m_Samplers;
+			case BindlessResource::Buffer:
+			default: return m_Buffers;
+		}
+	}
+
+	const BindlessTable::SlotAllocator &BindlessTable::getAllocator(const BindlessResource type) const {
+		switch (type) {
+			case BindlessResource::Texture: return m_Textures;
+			case BindlessResource::Sampler: return m_Samplers;
+			case BindlessResource::Buffer:
+			default: return m_Buffers;
+		}
+	}
+} // MVT
@@ -0,0 +1,572 @@
+//
+// Created by ianpo on 03/01/2026.
+//
+
+#include "MVT/BlockCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "MVT/JobSystem.hpp"
+
+namespace MVT {
+	namespace {
+		constexpr uint32_t c_BlockPixels = 16;
+		constexpr std::array<uint32_t, 16> c_BC7Weights4 = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+		template<uint32_t N>
+		struct PrincipalAxis {
+			std::array<float, N> mean{};
+			std::array<float, N> axis{};
+			float minT = 0.0f;
+			float maxT = 0.0f;
+		};
+
+		/// Fit a line through the block using the covariance matrix principal eigenvector (power iteration).
+		template<uint32_t N>
+		PrincipalAxis<N> ComputePrincipalAxis(const uint8_t *block) {
+			PrincipalAxis<N> result{};
+
+			for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+				for (uint32_t c = 0; c < N; ++c) {
+					result.mean[c] += block[i * 4 + c];
+				}
+			}
+			for (uint32_t c = 0; c < N; ++c) {
+				result.mean[c] /= static_cast<float>(c_BlockPixels);
+			}
+
+			std::array<float, N * N> covariance{};
+			for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+				std::array<float, N> d{};
+				for (uint32_t c = 0; c < N; ++c) {
+					d[c] = static_cast<float>(block[i * 4 + c]) - result.mean[c];
+				}
+				for (uint32_t r = 0; r < N; ++r) {
+					for (uint32_t c = 0; c < N; ++c) {
+						covariance[r * N + c] += d[r] * d[c];
+					}
+				}
+			}
+
+			result.axis.fill(1.0f);
+			for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+				std::array<float, N> next{};
+				for (uint32_t r = 0; r < N; ++r) {
+					for (uint32_t c = 0; c < N; ++c) {
+						next[r] += covariance[r * N + c] * result.axis[c];
+					}
+				}
+				float length = 0.0f;
+				for (const float v: next) length += v * v;
+				if (length < 1e-8f) break;
+				length = std::sqrt(length);
+				for (uint32_t c = 0; c < N; ++c) result.axis[c] = next[c] / length;
+			}
+
+			float axisLength = 0.0f;
+			for (const float v: result.axis) axisLength += v * v;
+			axisLength = std::sqrt(axisLength);
+			for (float &v: result.axis) v /= axisLength;
+
+			result.minT = std::numeric_limits<float>::max();
+			result.maxT = std::numeric_limits<float>::lowest();
+			for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+				float t = 0.0f;
+				for (uint32_t c = 0; c < N; ++c) {
+					t += (static_cast<float>(block[i * 4 + c]) - result.mean[c]) * result.axis[c];
+				}
+				result.minT = std::min(result.minT, t);
+				result.maxT = std::max(result.maxT, t);
+			}
+
+			return result;
+		}
+
+		uint16_t PackRGB565(const float r, const float g, const float b) {
+			const auto q = [](const float v, const int max) {
+				return static_cast<uint16_t>(std::clamp(static_cast<int>(std::lround(v * static_cast<float>(max) / 255.0f)), 0, max));
+			};
+			return static_cast<uint16_t>((q(r, 31) << 11) | (q(g, 63) << 5) | q(b, 31));
+		}
+
+		void UnpackRGB565(const uint16_t c, uint8_t *rgb) {
+			const uint8_t r = (c >> 11) & 0x1F;
+			const uint8_t g = (c >> 5) & 0x3F;
+			const uint8_t b = c & 0x1F;
+			rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+			rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+			rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+		}
+
+		uint32_t SquaredDistance(const uint8_t *a, const uint8_t *b, const uint32_t channels) {
+			uint32_t sum = 0;
+			for (uint32_t c = 0; c < channels; ++c) {
+				const int d = static_cast<int>(a[c]) - static_cast<int>(b[c]);
+				sum += static_cast<uint32_t>(d * d);
+			}
+			return sum;
+		}
+
+		/// BC1 color part, always in 4 colors mode so it can be shared with BC3.
+		void EncodeColor(const uint8_t *block, uint8_t *out) {
+			const auto fit = ComputePrincipalAxis<3>(block);
+
+			// Inset the endpoints a bit to reduce the error of the two interpolated colors.
+			const float inset = (fit.maxT - fit.minT) / 16.0f;
+			std::array<float, 3> e0{}, e1{};
+			for (uint32_t c = 0; c < 3; ++c) {
+				e0[c] = std::clamp(fit.mean[c] + fit.axis[c] * (fit.maxT - inset), 0.0f, 255.0f);
+				e1[c] = std::clamp(fit.mean[c] + fit.axis[c] * (fit.minT + inset), 0.0f, 255.0f);
+			}
+
+			uint16_t c0 = PackRGB565(e0[0], e0[1], e0[2]);
+			uint16_t c1 = PackRGB565(e1[0], e1[1], e1[2]);
+			if (c0 < c1) std::swap(c0, c1);
+
+			uint32_t indices = 0;
+			if (c0 != c1) {
+				std::array<std::array<uint8_t, 3>, 4> palette{};
+				UnpackRGB565(c0, palette[0].data());
+				UnpackRGB565(c1, palette[1].data());
+				for (uint32_t c = 0; c < 3; ++c) {
+					palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+					palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+				}
+
+				for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+					uint32_t best = 0;
+					uint32_t bestError = std::numeric_limits<uint32_t>::max();
+					for (uint32_t p = 0; p < 4; ++p) {
+						const uint32_t error = SquaredDistance(&block[i * 4], palette[p].data(), 3);
+						if (error < bestError) {
+							bestError = error;
+							best = p;
+						}
+					}
+					indices |= best << (i * 2);
+				}
+			}
+
+			out[0] = static_cast<uint8_t>(c0 & 0xFF);
+			out[1] = static_cast<uint8_t>(c0 >> 8);
+			out[2] = static_cast<uint8_t>(c1 & 0xFF);
+			out[3] = static_cast<uint8_t>(c1 >> 8);
+			std::memcpy(out + 4, &indices, sizeof(indices));
+		}
+
+		void DecodeColor(const uint8_t *in, uint8_t *block, const bool allowThreeColors) {
+			const uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+			const uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+			uint32_t indices;
+			std::memcpy(&indices, in + 4, sizeof(indices));
+
+			std::array<std::array<uint8_t, 4>, 4> palette{};
+			UnpackRGB565(c0, palette[0].data());
+			UnpackRGB565(c1, palette[1].data());
+			palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+
+			if (c0 > c1 || !allowThreeColors) {
+				for (uint32_t c = 0; c < 3; ++c) {
+					palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+					palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+				}
+			}
+			else {
+				for (uint32_t c = 0; c < 3; ++c) {
+					palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+					palette[3][c] = 0;
+				}
+				palette[3][3] = 0;
+			}
+
+			for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+				const uint32_t index = (indices >> (i * 2)) & 0x3;
+				std::memcpy(&block[i * 4], palette[index].data(), 4);
+			}
+		}
+
+		void EncodeBC4(const uint8_t *block, const uint32_t channel, uint8_t *out) {
+			uint8_t minV = 255, maxV = 0;
+			for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+				minV = std::min(minV, block[i * 4 + channel]);
+				maxV = std::max(maxV, block[i * 4 + channel]);
+			}
+
+			out[0] = maxV;
+			out[1] = minV;
+
+			uint64_t indices = 0;
+			if (maxV != minV) {
+				std::array<int, 8> palette{};
+				palette[0] = maxV;
+				palette[1] = minV;
+				for (int i = 2; i < 8; ++i) {
+					palette[i] = ((8 - i) * maxV + (i - 1) * minV) / 7;
+				}
+
+				for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+					const int v = block[i * 4 + channel];
+					uint64_t best = 0;
+					int bestError = std::numeric_limits<int>::max();
+					for (uint32_t p = 0; p < 8; ++p) {
+						const int error = std::abs(palette[p] - v);
+						if (error < bestError) {
+							bestError = error;
+							best = p;
+						}
+					}
+					indices |= best << (i * 3);
+				}
+			}
+
+			for (uint32_t b = 0; b < 6; ++b) {
+				out[2 + b] = static_cast<uint8_t>((indices >> (b * 8)) & 0xFF);
+			}
+		}
+
+		void DecodeBC4(const uint8_t *in, const uint32_t channel, uint8_t *block) {
+			const int a0 = in[0];
+			const int a1 = in[1];
+
+			std::array<int, 8> palette{};
+			palette[0] = a0;
+			palette[1] = a1;
+			if (a0 > a1) {
+				for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+			}
+			else {
+				for (int i = 2; i < 6; ++i) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+
+			uint64_t indices = 0;
+			for (uint32_t b = 0; b < 6; ++b) {
+				indices |= static_cast<uint64_t>(in[2 + b]) << (b * 8);
+			}
+
+			for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+				block[i * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 0x7]);
+			}
+		}
+
+		class BitWriter {
+		public:
+			explicit BitWriter(uint8_t *out) : m_Out(out) { std::memset(m_Out, 0, 16); }
+
+			void write(uint32_t value, const uint32_t bits) {
+				for (uint32_t i = 0; i < bits; ++i, ++m_Position) {
+					if (value & (1u << i)) m_Out[m_Position >> 3] |= static_cast<uint8_t>(1u << (m_Position & 7));
+				}
+			}
+
+		private:
+			uint8_t *m_Out;
+			uint32_t m_Position = 0;
+		};
+
+		class BitReader {
+		public:
+			explicit BitReader(const uint8_t *in) : m_In(in) {}
+
+			uint32_t read(const uint32_t bits) {
+				uint32_t value = 0;
+				for (uint32_t i = 0; i < bits; ++i, ++m_Position) {
+					value |= static_cast<uint32_t>((m_In[m_Position >> 3] >> (m_Position & 7)) & 1u) << i;
+				}
+				return value;
+			}
+
+		private:
+			const uint8_t *m_In;
+			uint32_t m_Position = 0;
+		};
+
+		void FetchBlock(const uint8_t *rgba, const uint32_t width, const uint32_t height, const uint32_t bx, const uint32_t by, uint8_t *block) {
+			for (uint32_t y = 0; y < 4; ++y) {
+				const uint32_t sy = std::min(by * 4 + y, height - 1);
+				for (uint32_t x = 0; x < 4; ++x) {
+					const uint32_t sx = std::min(bx * 4 + x, width - 1);
+					std::memcpy(&block[(y * 4 + x) * 4], &rgba[(static_cast<uint64_t>(sy) * width + sx) * 4], 4);
+				}
+			}
+		}
+
+		void StoreBlock(const uint8_t *block, const uint32_t width, const uint32_t height, const uint32_t bx, const uint32_t by, uint8_t *rgba) {
+			for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y) {
+				for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x) {
+					std::memcpy(&rgba[(static_cast<uint64_t>(by * 4 + y) * width + bx * 4 + x) * 4], &block[(y * 4 + x) * 4], 4);
+				}
+			}
+		}
+
+		using EncodeBlockFunc = void(*)(const uint8_t *, uint8_t *);
+		using DecodeBlockFunc = void(*)(const uint8_t *, uint8_t *);
+
+		EncodeBlockFunc GetEncoder(const BlockFormat format) {
+			switch (format) {
+				case BlockFormat::BC1: return &BlockCompression::EncodeBlockBC1;
+				case BlockFormat::BC3: return &BlockCompression::EncodeBlockBC3;
+				case BlockFormat::BC5: return &BlockCompression::EncodeBlockBC5;
+				case BlockFormat::BC7: return &BlockCompression::EncodeBlockBC7;
+			}
+			return &BlockCompression::EncodeBlockBC7;
+		}
+
+		DecodeBlockFunc GetDecoder(const BlockFormat format) {
+			switch (format) {
+				case BlockFormat::BC1: return &BlockCompression::DecodeBlockBC1;
+				case BlockFormat::BC3: return &BlockCompression::DecodeBlockBC3;
+				case BlockFormat::BC5: return &BlockCompression::DecodeBlockBC5;
+				case BlockFormat::BC7: return &BlockCompression::DecodeBlockBC7;
+			}
+			return &BlockCompression::DecodeBlockBC7;
+		}
+	}
+
+	uint32_t BlockCompression::GetBlockSize(const BlockFormat format) {
+		return format == BlockFormat::BC1 ? 8 : 16;
+	}
+
+	uint64_t BlockCompression::GetEncodedSize(const BlockFormat format, const uint32_t width, const uint32_t height) {
+		const uint64_t blocksX = (width + 3) / 4;
+		const uint64_t blocksY = (height + 3) / 4;
+		return blocksX * blocksY * GetBlockSize(format);
+	}
+
+	std::vector<uint8_t> BlockCompression::Encode(const BlockFormat format, const uint8_t *rgba, const uint32_t width, const uint32_t height, const uint32_t threadCount) {
+		std::vector<uint8_t> blocks(GetEncodedSize(format, width, height));
+		Encode(format, rgba, width, height, blocks.data(), threadCount);
+		return blocks;
+	}
+
+	void BlockCompression::Encode(const BlockFormat format, const uint8_t *rgba, const uint32_t width, const uint32_t height, uint8_t *pBlocks, uint32_t threadCount) {
+		const uint32_t blocksX = (width + 3) / 4;
+		const uint32_t blocksY = (height + 3) / 4;
+		const uint32_t blockSize = GetBlockSize(format);
+		const EncodeBlockFunc encode = GetEncoder(format);
+
+		const auto encodeRows = [=](const uint32_t beginRow, const uint32_t endRow) {
+			std::array<uint8_t, c_BlockPixels * 4> block{};
+			for (uint32_t by = beginRow; by < endRow; ++by) {
+				for (uint32_t bx = 0; bx < blocksX; ++bx) {
+					FetchBlock(rgba, width, height, bx, by, block.data());
+					encode(block.data(), pBlocks + (static_cast<uint64_t>(by) * blocksX + bx) * blockSize);
+				}
+			}
+		};
+
+		if (threadCount == 1) {
+			encodeRows(0, blocksY);
+			return;
+		}
+
+		// Called from a cook job, the rows are spread over the idle workers.
+		JobSystem::ParallelFor(blocksY, 1, encodeRows, threadCount);
+	}
+
+	std::vector<uint8_t> BlockCompression::Decode(const BlockFormat format, const uint8_t *pBlocks, const uint32_t width, const uint32_t height) {
+		std::vector<uint8_t> rgba(static_cast<uint64_t>(width) * height * 4);
+		const uint32_t blocksX = (width + 3) / 4;
+		const uint32_t blocksY = (height + 3) / 4;
+		const uint32_t blockSize = GetBlockSize(format);
+		const DecodeBlockFunc decode = GetDecoder(format);
+
+		std::array<uint8_t, c_BlockPixels * 4> block{};
+		for (uint32_t by = 0; by < blocksY; ++by) {
+			for (uint32_t bx = 0; bx < blocksX; ++bx) {
+				decode(pBlocks + (static_cast<uint64_t>(by) * blocksX + bx) * blockSize, block.data());
+				StoreBlock(block.data(), width, height, bx, by, rgba.data());
+			}
+		}
+
+		return rgba;
+	}
+
+	double BlockCompression::ComputePSNR(const BlockFormat format, const uint8_t *reference, const uint8_t *decoded, const uint32_t width, const uint32_t height) {
+		uint32_t channels = 4;
+		switch (format) {
+			case BlockFormat::BC1: channels = 3; break;
+			case BlockFormat::BC5: channels = 2; break;
+			case BlockFormat::BC3:
+			case BlockFormat::BC7: channels = 4; break;
+		}
+
+		const uint64_t pixels = static_cast<uint64_t>(width) * height;
+		double sum = 0.0;
+		for (uint64_t i = 0; i < pixels; ++i) {
+			sum += SquaredDistance(&reference[i * 4], &decoded[i * 4], channels);
+		}
+
+		const double mse = sum / static_cast<double>(pixels * channels);
+		if (mse <= 0.0) {
+			return std::numeric_limits<double>::infinity();
+		}
+		return 10.0 * std::log10((255.0 * 255.0) / mse);
+	}
+
+	BlockEncodeStats BlockCompression::Benchmark(const BlockFormat format, const uint8_t *rgba, const uint32_t width, const uint32_t height, const uint32_t threadCount) {
+		BlockEncodeStats stats{};
+
+		const auto start = std::chrono::steady_clock::now();
+		const std::vector<uint8_t> blocks = Encode(format, rgba, width, height, threadCount);
+		const auto end = std::chrono::steady_clock::now();
+
+		stats.seconds = std::chrono::duration<double>(end - start).count();
+		stats.megaPixelsPerSecond = stats.seconds > 0.0 ? (static_cast<double>(width) * height / 1'000'000.0) / stats.seconds : 0.0;
+
+		const std::vector<uint8_t> decoded = Decode(format, blocks.data(), width, height);
+		stats.psnr = ComputePSNR(format, rgba, decoded.data(), width, height);
+
+		return stats;
+	}
+
+	void BlockCompression::EncodeBlockBC1(const uint8_t *block, uint8_t *out) {
+		EncodeColor(block, out);
+	}
+
+	void BlockCompression::EncodeBlockBC3(const uint8_t *block, uint8_t *out) {
+		EncodeBC4(block, 3, out);
+		EncodeColor(block, out + 8);
+	}
+
+	void BlockCompression::EncodeBlockBC5(const uint8_t *block, uint8_t *out) {
+		EncodeBC4(block, 0, out);
+		EncodeBC4(block, 1, out + 8);
+	}
+
+	void BlockCompression::EncodeBlockBC7(const uint8_t *block, uint8_t *out) {
+		// Mode 6: one subset, RGBA 7.7.7.7 endpoints with a unique P-bit each, 4 bits indices.
+		const auto fit = ComputePrincipalAxis<4>(block);
+
+		std::array<float, 4> e0{}, e1{};
+		for (uint32_t c = 0; c < 4; ++c) {
+			e0[c] = std::clamp(fit.mean[c] + fit.axis[c] * fit.minT, 0.0f, 255.0f);
+			e1[c] = std::clamp(fit.mean[c] + fit.axis[c] * fit.maxT, 0.0f, 255.0f);
+		}
+
+		std::array<uint32_t, 4> bestQ0{}, bestQ1{};
+		std::array<uint8_t, c_BlockPixels> bestIndices{};
+		uint32_t bestP0 = 0, bestP1 = 0;
+		uint64_t bestError = std::numeric_limits<uint64_t>::max();
+
+		for (uint32_t p0 = 0; p0 < 2; ++p0) {
+			for (uint32_t p1 = 0; p1 < 2; ++p1) {
+				std::array<uint32_t, 4> q0{}, q1{};
+				std::array<uint8_t, 4> v0{}, v1{};
+				for (uint32_t c = 0; c < 4; ++c) {
+					q0[c] = static_cast<uint32_t>(std::clamp(static_cast<int>(std::lround((e0[c] - static_cast<float>(p0)) * 0.5f)), 0, 127));
+					q1[c] = static_cast<uint32_t>(std::clamp(static_cast<int>(std::lround((e1[c] - static_cast<float>(p1)) * 0.5f)), 0, 127));
+					v0[c] = static_cast<uint8_t>((q0[c] << 1) | p0);
+					v1[c] = static_cast<uint8_t>((q1[c] << 1) | p1);
+				}
+
+				std::array<std::array<uint8_t, 4>, 16> palette{};
+				for (uint32_t i = 0; i < 16; ++i) {
+					const uint32_t w = c_BC7Weights4[i];
+					for (uint32_t c = 0; c < 4; ++c) {
+						palette[i][c] = static_cast<uint8_t>(((64 - w) * v0[c] + w * v1[c] + 32) >> 6);
+					}
+				}
+
+				uint64_t error = 0;
+				std::array<uint8_t, c_BlockPixels> indices{};
+				for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+					uint32_t pixelError = std::numeric_limits<uint32_t>::max();
+					for (uint32_t p = 0; p < 16; ++p) {
+						const uint32_t e = SquaredDistance(&block[i * 4], palette[p].data(), 4);
+						if (e < pixelError) {
+							pixelError = e;
+							indices[i] = static_cast<uint8_t>(p);
+						}
+					}
+					error += pixelError;
+				}
+
+				if (error < bestError) {
+					bestError = error;
+					bestQ0 = q0;
+					bestQ1 = q1;
+					bestP0 = p0;
+					bestP1 = p1;
+					bestIndices = indices;
+				}
+			}
+		}
+
+		// The anchor index only has 3 bits, its MSB must be 0.
+		if (bestIndices[0] & 0x8) {
+			std::swap(bestQ0, bestQ1);
+			std::swap(bestP0, bestP1);
+			for (auto &index: bestIndices) index = static_cast<uint8_t>(15 - index);
+		}
+
+		BitWriter writer{out};
+		writer.write(1u << 6, 7);
+		for (uint32_t c = 0; c < 4; ++c) {
+			writer.write(bestQ0[c], 7);
+			writer.write(bestQ1[c], 7);
+		}
+		writer.write(bestP0, 1);
+		writer.write(bestP1, 1);
+		writer.write(bestIndices[0], 3);
+		for (uint32_t i = 1; i < c_BlockPixels; ++i) {
+			writer.write(bestIndices[i], 4);
+		}
+	}
+
+	void BlockCompression::DecodeBlockBC1(const uint8_t *in, uint8_t *block) {
+		DecodeColor(in, block, true);
+	}
+
+	void BlockCompression::DecodeBlockBC3(const uint8_t *in, uint8_t *block) {
+		DecodeColor(in + 8, block, false);
+		DecodeBC4(in, 3, block);
+	}
+
+	void BlockCompression::DecodeBlockBC5(const uint8_t *in, uint8_t *block) {
+		DecodeBC4(in, 0, block);
+		DecodeBC4(in + 8, 1, block);
+		for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+			block[i * 4 + 2] = 0;
+			block[i * 4 + 3] = 255;
+		}
+	}
+
+	void BlockCompression::DecodeBlockBC7(const uint8_t *in, uint8_t *block) {
+		// Only mode 6 is decoded, which is the only mode our encoder emits.
+		if ((in[0] & 0x7F) != 0x40) {
+			std::memset(block, 0, c_BlockPixels * 4);
+			return;
+		}
+
+		BitReader reader{in};
+		reader.read(7);
+
+		std::array<uint32_t, 4> q0{}, q1{};
+		for (uint32_t c = 0; c < 4; ++c) {
+			q0[c] = reader.read(7);
+			q1[c] = reader.read(7);
+		}
+		const uint32_t p0 = reader.read(1);
+		const uint32_t p1 = reader.read(1);
+
+		std::array<uint32_t, 4> v0{}, v1{};
+		for (uint32_t c = 0; c < 4; ++c) {
+			v0[c] = (q0[c] << 1) | p0;
+			v1[c] = (q1[c] << 1) | p1;
+		}
+
+		for (uint32_t i = 0; i < c_BlockPixels; ++i) {
+			const uint32_t w = c_BC7Weights4[reader.read(i == 0 ? 3 : 4)];
+			for (uint32_t c = 0; c < 4; ++c) {
+				block[i * 4 + c] = static_cast<uint8_t>(((64 - w) * v0[c] + w * v1[c] + 32) >> 6);
+			}
+		}
+	}
+} // MVT
@@ -0,0 +1,234 @@
+//
+// Created by ianpo on 05/01/2026.
+//
+
+#include "MVT/ComputeDownsampler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace MVT {
+	struct DownsampleParameters {
+		uint32_t sourceWidth;
+		uint32_t sourceHeight;
+		uint32_t mips;
+		uint32_t workGroupCount;
+		uint32_t reduction;
+		uint32_t srgb;
+	};
+
+	static constexpr uint32_t c_TileSize = 64;
+	// Above this size, mip 6 no longer fits in the single tile of the last workgroup.
+	static constexpr uint32_t c_MaxSingleDispatchSize = 4096;
+
+	ComputeDownsampler::ComputeDownsampler(const vk::raii::Device &device, const vk::raii::PhysicalDevice &physicalDevice, const std::vector<char> &spirv) : m_Device(&device) {
+		const std::array bindings = {
+			vk::DescriptorSetLayoutBinding{.binding = 0, .descriptorType = vk::DescriptorType::eSampledImage, .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute},
+			vk::DescriptorSetLayoutBinding{.binding = 1, .descriptorType = vk::DescriptorType::eStorageImage, .descriptorCount = c_MaxMipsPerDispatch, .stageFlags = vk::ShaderStageFlagBits::eCompute},
+			vk::DescriptorSetLayoutBinding{.binding = 2, .descriptorType = vk::DescriptorType::eStorageImage, .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute},
+			vk::DescriptorSetLayoutBinding{.binding = 3, .descriptorType = vk::DescriptorType::eStorageBuffer, .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute},
+		};
+		m_DescriptorSetLayout = vk::raii::DescriptorSetLayout(device, vk::DescriptorSetLayoutCreateInfo{.bindingCount = static_cast<uint32_t>(bindings.size()), .pBindings = bindings.data()});
+
+		const vk::PushConstantRange pushConstantRange{.stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = sizeof(DownsampleParameters)};
+		m_PipelineLayout = vk::raii::PipelineLayout(device, vk::PipelineLayoutCreateInfo{
+			                                            .setLayoutCount = 1, .pSetLayouts = &*m_DescriptorSetLayout,
+			                                            .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange
+		                                            });
+
+		const vk::raii::ShaderModule shaderModule(device, vk::ShaderModuleCreateInfo{.codeSize = spirv.size() * sizeof(char), .pCode = reinterpret_cast<const uint32_t *>(spirv.data())});
+		const vk::ComputePipelineCreateInfo pipelineInfo{
+			.stage = {.stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "downsampleMain"},
+			.layout = m_PipelineLayout,
+		};
+		m_Pipeline = vk::raii::Pipeline(device, nullptr, pipelineInfo);
+
+		// The counter lives in host visible memory so it can be zeroed once, the shader keeps it at 0 afterward.
+		m_CounterBuffer = vk::raii::Buffer(device, vk::BufferCreateInfo{.size = sizeof(uint32_t), .usage = vk::BufferUsageFlagBits::eStorageBuffer, .sharingMode = vk::SharingMode::eExclusive});
+		const vk::MemoryRequirements requirements = m_CounterBuffer.getMemoryRequirements();
+		const vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
+		constexpr vk::MemoryPropertyFlags counterProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		uint32_t memoryType = memoryProperties.memoryTypeCount;
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+			if ((requirements.memoryTypeBits & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & counterProperties) == counterProperties) {
+				memoryType = i;
+				break;
+			}
+		}
+		if (memoryType == memoryProperties.memoryTypeCount) {
+			throw std::runtime_error("failed to find a host visible memory type for the downsampler counter!");
+		}
+
+		m_CounterMemory = vk::raii::DeviceMemory(device, vk::MemoryAllocateInfo{.allocationSize = requirements.size, .memoryTypeIndex = memoryType});
+		m_CounterBuffer.bindMemory(m_CounterMemory, 0);
+		void *counter = m_CounterMemory.mapMemory(0, sizeof(uint32_t));
+		std::memset(counter, 0, sizeof(uint32_t));
+		m_CounterMemory.unmapMemory();
+	}
+
+	bool ComputeDownsampler::IsSrgb(const vk::Format format) {
+		switch (format) {
+			case vk::Format::eR8G8B8A8Srgb:
+			case vk::Format::eB8G8R8A8Srgb:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	vk::Format ComputeDownsampler::GetStorageFormat(const vk::raii::PhysicalDevice &physicalDevice, const vk::Format format) {
+		vk::Format storageFormat;
+		switch (format) {
+			case vk::Format::eR8G8B8A8Srgb:
+			case vk::Format::eR8G8B8A8Unorm:
+				storageFormat = vk::Format::eR8G8B8A8Unorm;
+				break;
+			case vk::Format::eR16G16B16A16Sfloat:
+			case vk::Format::eR32Sfloat:
+			case vk::Format::eR16Sfloat:
+				storageFormat = format;
+				break;
+			default:
+				return vk::Format::eUndefined;
+		}
+
+		const vk::FormatProperties properties = physicalDevice.getFormatProperties(storageFormat);
+		return (properties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eStorageImage) ? storageFormat : vk::Format::eUndefined;
+	}
+
+	ComputeDownsampler::Resources ComputeDownsampler::record(const vk::raii::CommandBuffer &commandBuffer, const DownsampleTarget &target) const {
+		Resources resources;
+		if (target.mipLevels <= 1) {
+			return resources;
+		}
+
+		// Split the chain in dispatches of at most 12 mips, or 6 while the source is too big for the last workgroup.
+		std::vector<std::pair<uint32_t, uint32_t>> dispatches; // (base level, mip count)
+		for (uint32_t base = 0; base + 1 < target.mipLevels;) {
+			const uint32_t baseSize = std::max(target.width >> base, target.height >> base);
+			const uint32_t maxMips = baseSize > c_MaxSingleDispatchSize ? 6 : c_MaxMipsPerDispatch;
+			const uint32_t mips = std::min(maxMips, target.mipLevels - 1 - base);
+			dispatches.emplace_back(base, mips);
+			base += mips;
+		}
+
+		const auto dispatchCount = static_cast<uint32_t>(dispatches.size());
+		const std::array poolSizes = {
+			vk::DescriptorPoolSize{vk::DescriptorType::eSampledImage, dispatchCount},
+			vk::DescriptorPoolSize{vk::DescriptorType::eStorageImage, dispatchCount * (c_MaxMipsPerDispatch + 1)},
+			vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, dispatchCount},
+		};
+		resources.pool = vk::raii::DescriptorPool(*m_Device, vk::DescriptorPoolCreateInfo{
+			                                          .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+			                                          .maxSets = dispatchCount,
+			                                          .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+			                                          .pPoolSizes = poolSizes.data()
+		                                          });
+		const std::vector layouts(dispatchCount, *m_DescriptorSetLayout);
+		resources.sets = m_Device->allocateDescriptorSets({.descriptorPool = resources.pool, .descriptorSetCount = dispatchCount, .pSetLayouts = layouts.data()});
+		resources.views.reserve(target.mipLevels);
+
+		const vk::ImageViewUsageCreateInfo storageUsage{.usage = vk::ImageUsageFlagBits::eStorage};
+		const vk::ImageViewUsageCreateInfo sampledUsage{.usage = vk::ImageUsageFlagBits::eSampled};
+		const auto createView = [&](const uint32_t level, const bool storage) -> vk::ImageView {
+			resources.views.emplace_back(*m_Device, vk::ImageViewCreateInfo{
+				                             .pNext = storage ? &storageUsage : &sampledUsage,
+				                             .image = target.image, .viewType = vk::ImageViewType::e2D,
+				                             .format = storage ? target.storageFormat : target.sampledFormat,
+				                             .subresourceRange = {vk::ImageAspectFlagBits::eColor, level, 1, 0, 1}
+			                             });
+			return *resources.views.back();
+		};
+
+		const vk::ImageSubresourceRange baseRange{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+		const bool srgb = IsSrgb(target.sampledFormat) && !IsSrgb(target.storageFormat);
+
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_Pipeline);
+
+		for (uint32_t d = 0; d < dispatchCount; ++d) {
+			const auto [base, mips] = dispatches[d];
+
+			// Descriptors: the unused array slots are filled with the last mip, the shader never touches them.
+			const vk::DescriptorImageInfo sourceInfo{.imageView = createView(base, false), .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal};
+			std::array<vk::DescriptorImageInfo, c_MaxMipsPerDispatch> destinationInfos{};
+			for (uint32_t mip = 0; mip < mips; ++mip) {
+				destinationInfos[mip] = {.imageView = createView(base + 1 + mip, true), .imageLayout = vk::ImageLayout::eGeneral};
+			}
+			std::fill(destinationInfos.begin() + mips, destinationInfos.end(), destinationInfos[mips - 1]);
+			const vk::DescriptorBufferInfo counterInfo{.buffer = m_CounterBuffer, .offset = 0, .range = sizeof(uint32_t)};
+
+			const std::array writes = {
+				vk::WriteDescriptorSet{.dstSet = resources.sets[d], .dstBinding = 0, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eSampledImage, .pImageInfo = &sourceInfo},
+				vk::WriteDescriptorSet{.dstSet = resources.sets[d], .dstBinding = 1, .descriptorCount = c_MaxMipsPerDispatch, .descriptorType = vk::DescriptorType::eStorageImage, .pImageInfo = destinationInfos.data()},
+				vk::WriteDescriptorSet{.dstSet = resources.sets[d], .dstBinding = 2, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eStorageImage, .pImageInfo = &destinationInfos[std::min(mips, 6u) - 1]},
+				vk::WriteDescriptorSet{.dstSet = resources.sets[d], .dstBinding = 3, .descriptorCount = 1, .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = &counterInfo},
+			};
+			m_Device->updateDescriptorSets(writes, {});
+
+			// The first source comes from the upload, the next ones were released by the previous dispatch.
+			// The global barrier orders the counter reset of the previous dispatch with this one.
+			std::vector<vk::ImageMemoryBarrier2> barriers;
+			if (base == 0) {
+				barriers.push_back({
+					.srcStageMask = vk::PipelineStageFlagBits2::eTransfer, .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+					.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader, .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+					.oldLayout = vk::ImageLayout::eTransferDstOptimal, .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+					.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+					.image = target.image, .subresourceRange = baseRange
+				});
+			}
+			barriers.push_back({
+				.srcStageMask = vk::PipelineStageFlagBits2::eNone, .srcAccessMask = vk::AccessFlagBits2::eNone,
+				.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader, .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+				.oldLayout = vk::ImageLayout::eUndefined, .newLayout = vk::ImageLayout::eGeneral,
+				.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.image = target.image, .subresourceRange = {vk::ImageAspectFlagBits::eColor, base + 1, mips, 0, 1}
+			});
+			const vk::MemoryBarrier2 counterBarrier{
+				.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader, .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+				.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader, .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+			};
+			commandBuffer.pipelineBarrier2({
+				.memoryBarrierCount = 1, .pMemoryBarriers = &counterBarrier,
+				.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size()), .pImageMemoryBarriers = barriers.data()
+			});
+
+			const uint32_t sourceWidth = std::max(1u, target.width >> base);
+			const uint32_t sourceHeight = std::max(1u, target.height >> base);
+			const uint32_t groupsX = (sourceWidth + c_TileSize - 1) / c_TileSize;
+			const uint32_t groupsY = (sourceHeight + c_TileSize - 1) / c_TileSize;
+			const DownsampleParameters parameters{
+				.sourceWidth = sourceWidth, .sourceHeight = sourceHeight,
+				.mips = mips, .workGroupCount = groupsX * groupsY,
+				.reduction = static_cast<uint32_t>(target.reduction),
+				.srgb = srgb ? 1u : 0u,
+			};
+
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_PipelineLayout, 0, *resources.sets[d], nullptr);
+			commandBuffer.pushConstants<DownsampleParameters>(m_PipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, parameters);
+			commandBuffer.dispatch(groupsX, groupsY, 1);
+
+			// Written levels become readable, by the next dispatch or by the fragment shaders.
+			const vk::ImageMemoryBarrier2 release{
+				.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader, .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+				.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eFragmentShader, .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+				.oldLayout = vk::ImageLayout::eGeneral, .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+				.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.image = target.image, .subresourceRange = {vk::ImageAspectFlagBits::eColor, base + 1, mips, 0, 1}
+			};
+			commandBuffer.pipelineBarrier2({.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &release});
+		}
+
+		return resources;
+	}
+
+	void ComputeDownsampler::clear() {
+		m_Pipeline.clear();
+		m_PipelineLayout.clear();
+		m_DescriptorSetLayout.clear();
+		m_CounterBuffer.clear();
+		m_CounterMemory.clear();
+		m_Device = nullptr;
+	}
+} // MVT
@@ -0,0 +1,28 @@
+//
+// Created by ianpo on 12/01/2026.
+//
+
+#include "MVT/DeletionQueue.hpp"
+
+#include <algorithm>
+
+namespace MVT {
+	void DeletionQueue::retire(std::function<void()> destroy, const uint64_t value) {
+		m_Entries.push_back(Entry{.value = value, .destroy = std::move(destroy)});
+	}
+
+	void DeletionQueue::collect(const uint64_t completedValue) {
+		// Newest first, like class members: an object retired after what it was built from goes before it.
+		const auto first = std::ranges::stable_partition(m_Entries, [completedValue](const Entry &entry) { return entry.value > completedValue; }).begin();
+		for (auto it = m_Entries.end(); it != first; --it) {
+			Entry &entry = *(it - 1);
+			if (entry.destroy) entry.destroy();
+			entry.object.reset();
+		}
+		m_Entries.erase(first, m_Entries.end());
+	}
+
+	void DeletionQueue::flush() {
+		collect(UINT64_MAX);
+	}
+} // MVT
@@ -0,0 +1,124 @@
+//
+// Created by ianpo on 13/01/2026.
+//
+
+#include "MVT/DrawQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <utility>
+
+#include "MVT/Log.hpp"
+
+namespace MVT {
+	static constexpr uint32_t c_RadixBits = 8;
+	static constexpr uint32_t c_RadixBuckets = 1u << c_RadixBits;
+	static constexpr uint32_t c_RadixPasses = 64 / c_RadixBits;
+
+	static uint64_t Field(const uint32_t value, const uint32_t bits) {
+		return std::min<uint64_t>(value, (1ull << bits) - 1);
+	}
+
+	uint64_t DrawQueue::MakeKey(const DrawPass pass, const uint32_t pipeline, const uint32_t material, const uint32_t mesh, const float depth) {
+		constexpr uint32_t depthMax = (1u << c_DepthBits) - 1;
+		const auto quantized = static_cast<uint32_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(depthMax));
+		const uint64_t state = Field(pipeline, c_PipelineBits) << (c_MaterialBits + c_MeshBits) | Field(material, c_MaterialBits) << c_MeshBits | Field(mesh, c_MeshBits);
+
+		// 4 bits of pass on top, the 60 others hold the state and the depth in the order the pass wants.
+		uint64_t key = static_cast<uint64_t>(pass) << 60;
+		if (pass == DrawPass::Transparent) {
+			key |= static_cast<uint64_t>(depthMax - quantized) << (c_PipelineBits + c_MaterialBits + c_MeshBits) | state;
+		}
+		else {
+			key |= state << c_DepthBits | quantized;
+		}
+		return key;
+	}
+
+	void DrawQueue::sort() {
+		const size_t count = m_Packets.size();
+		if (count < 2) return;
+		m_Scratch.resize(count);
+
+		// All the histograms in a single read of the keys.
+		std::array<std::array<uint32_t, c_RadixBuckets>, c_RadixPasses> histograms{};
+		for (const DrawPacket &packet: m_Packets) {
+			for (uint32_t pass = 0; pass < c_RadixPasses; ++pass) {
+				histograms[pass][(packet.key >> (pass * c_RadixBits)) & (c_RadixBuckets - 1)] += 1;
+			}
+		}
+
+		DrawPacket *source = m_Packets.data();
+		DrawPacket *destination = m_Scratch.data();
+		for (uint32_t pass = 0; pass < c_RadixPasses; ++pass) {
+			auto &histogram = histograms[pass];
+			const uint32_t shift = pass * c_RadixBits;
+
+			// Every key has the same digit: the pass would not move anything.
+			if (histogram[(source->key >> shift) & (c_RadixBuckets - 1)] == count) continue;
+
+			uint32_t offset = 0;
+			for (uint32_t &bucket: histogram) {
+				offset += std::exchange(bucket, offset);
+			}
+			for (size_t i = 0; i < count; ++i) {
+				destination[histogram[(source[i].key >> shift) & (c_RadixBuckets - 1)]++] = source[i];
+			}
+			std::swap(source, destination);
+		}
+
+		if (source != m_Packets.data()) {
+			m_Packets.swap(m_Scratch);
+		}
+	}
+
+	void DrawQueue::Benchmark(const uint32_t count) {
+		std::mt19937_64 random{42};
+		std::uniform_int_distribution<uint32_t> pipelines{0, 7}, materials{0, 255}, meshes{0, 1023};
+		std::uniform_real_distribution<float> depths{0.0f, 1.0f};
+
+		DrawQueue queue;
+		queue.reserve(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			const DrawPass pass = i % 8 == 0 ? DrawPass::Transparent : DrawPass::Opaque;
+			queue.push(MakeKey(pass, pipelines(random), materials(random), meshes(random), depths(random)), i);
+		}
+		std::vector<DrawPacket> reference{queue.m_Packets};
+
+		// Warm the scratch buffer, as it would be after the first frame.
+		DrawQueue warm = queue;
+		warm.sort();
+		queue.m_Scratch.swap(warm.m_Scratch);
+
+		const auto radixStart = std::chrono::high_resolution_clock::now();
+		queue.sort();
+		const double radixMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - radixStart).count();
+
+		const auto stdStart = std::chrono::high_resolution_clock::now();
+		std::ranges::stable_sort(reference, {}, &DrawPacket::key);
+		const double stdMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - stdStart).count();
+
+		const bool same = std::ranges::equal(queue.m_Packets, reference, [](const DrawPacket &a, const DrawPacket &b) { return a.key == b.key && a.draw == b.draw; });
+		MVT_LOG_INFO(Render, "[DrawQueue] {} keys: radix sort {:.3f} ms, std::stable_sort {:.3f} ms{}", count, radixMilliseconds, stdMilliseconds, same ? "" : " (MISMATCH)");
+
+		// A known layout, pushed out of order: opaque front-to-back within the same state, then transparent back-to-front.
+		struct Draw {
+			DrawPass pass;
+			float depth;
+		};
+		constexpr std::array<Draw, 6> pushed = {{
+			{DrawPass::Transparent, 0.2f}, {DrawPass::Opaque, 0.9f}, {DrawPass::Transparent, 0.8f},
+			{DrawPass::Opaque, 0.1f}, {DrawPass::Transparent, 0.5f}, {DrawPass::Opaque, 0.4f},
+		}};
+		constexpr std::array<uint32_t, 6> order = {3, 5, 1, 2, 4, 0};
+		DrawQueue layout;
+		for (uint32_t i = 0; i < pushed.size(); ++i) {
+			layout.push(MakeKey(pushed[i].pass, 0, 0, 0, pushed[i].depth), i);
+		}
+		layout.sort();
+		const bool ordered = std::ranges::equal(layout.m_Packets, order, {}, &DrawPacket::draw);
+		MVT_LOG_INFO(Render, "[DrawQueue] Known layout {}.", ordered ? "sorted as expected" : "MISORDERED");
+	}
+} // MVT
@@ -0,0 +1,59 @@
+//
+// Created by ianpo on 15/01/2026.
+//
+
+#include "MVT/DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "MVT/Log.hpp"
+
+namespace MVT {
+	DynamicResolution::DynamicResolution(const DynamicResolutionSettings &settings) : m_Settings(settings) {
+		m_Settings.minScale = std::clamp(m_Settings.minScale, 0.1, 1.0);
+		m_Settings.maxScale = std::clamp(m_Settings.maxScale, m_Settings.minScale, 1.0);
+		m_Output = m_Settings.maxScale;
+		m_Scale = m_Settings.maxScale;
+
+		if (m_Settings.enabled) {
+			MVT_LOG_INFO(Render, "[DynamicResolution] Scale between {} and {} for a {} ms GPU frame.", m_Settings.minScale, m_Settings.maxScale, m_Settings.targetMilliseconds);
+		}
+	}
+
+	vk::Extent2D DynamicResolution::getRenderExtent(const vk::Extent2D extent) const {
+		return {
+			std::max(1u, static_cast<uint32_t>(std::lround(extent.width * m_Scale))),
+			std::max(1u, static_cast<uint32_t>(std::lround(extent.height * m_Scale))),
+		};
+	}
+
+	bool DynamicResolution::update(const double gpuMilliseconds) {
+		if (!m_Settings.enabled || m_Settings.targetMilliseconds <= 0.0) return false;
+
+		// Positive with headroom, negative over budget.
+		double error = (m_Settings.targetMilliseconds - gpuMilliseconds) / m_Settings.targetMilliseconds;
+		if (std::abs(error) < c_DeadBand) {
+			error = 0.0;
+		}
+
+		const double derivative = error - m_PreviousError;
+		m_PreviousError = error;
+
+		// Around the maximum scale: once the error is in the dead band, the integral alone holds the reduced scale.
+		const double integral = m_Integral + error;
+		const double output = m_Settings.maxScale + m_Settings.proportional * error + m_Settings.integral * integral + m_Settings.derivative * derivative;
+		m_Output = std::clamp(output, m_Settings.minScale, m_Settings.maxScale);
+		// No integration while saturated, the scale reacts as soon as the error changes sign.
+		if (output == m_Output) {
+			m_Integral = integral;
+		}
+
+		// Hysteresis: small corrections are accumulated until they are worth a new viewport, the bounds are always reached.
+		if (std::abs(m_Output - m_Scale) < c_MinStep && m_Output != m_Settings.minScale && m_Output != m_Settings.maxScale) return false;
+		if (m_Output == m_Scale) return false;
+
+		m_Scale = m_Output;
+		return true;
+	}
+} // MVT
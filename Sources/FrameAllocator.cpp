@@ -0,0 +1,93 @@
+//
+// Created by ianpo on 10/01/2026.
+//
+
+#include "MVT/FrameAllocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace MVT {
+	static vk::DeviceSize AlignUp(const vk::DeviceSize value, const vk::DeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	FrameAllocator::FrameAllocator(VmaAllocator allocator, const vk::raii::PhysicalDevice &physicalDevice, const vk::DeviceSize regionSize) {
+		const vk::PhysicalDeviceLimits limits = physicalDevice.getProperties().limits;
+		// Both limits are powers of two, the biggest one satisfies the other.
+		m_Alignment = std::max({limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment, vk::DeviceSize{16}});
+		m_RegionSize = AlignUp(regionSize, m_Alignment);
+
+		// The tail lets a descriptor of `c_MaxBindingRange` bytes start at the last block of the last region.
+		const VkBufferCreateInfo bufferInfo{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.size = m_RegionSize * FrameScheduler::c_MaxFramesInFlight + c_MaxBindingRange,
+			.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+		};
+
+		VmaAllocationCreateInfo allocInfo{};
+		allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+		allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+		// No flush per frame.
+		allocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+		m_Buffer = VmaBuffer(allocator, &bufferInfo, &allocInfo);
+		if (!m_Buffer.IsValid()) {
+			throw std::runtime_error("[Vulkan] Failed to create the frame allocator buffer!");
+		}
+		m_Mapped = static_cast<std::byte *>(m_Buffer.GetAllocationInfo().pMappedData);
+	}
+
+	FrameAllocator::FrameAllocator(FrameAllocator &&o) noexcept {
+		swap(o);
+	}
+
+	FrameAllocator &FrameAllocator::operator=(FrameAllocator &&o) noexcept {
+		swap(o);
+		return *this;
+	}
+
+	void FrameAllocator::swap(FrameAllocator &o) noexcept {
+		m_Buffer.swap(o.m_Buffer);
+		std::swap(m_Mapped, o.m_Mapped);
+		std::swap(m_Alignment, o.m_Alignment);
+		std::swap(m_RegionSize, o.m_RegionSize);
+		std::swap(m_RegionBegin, o.m_RegionBegin);
+		m_Head.store(o.m_Head.exchange(m_Head.load()));
+	}
+
+	void FrameAllocator::beginFrame(const uint32_t slot) {
+		m_RegionBegin = m_RegionSize * slot;
+		m_Head.store(0, std::memory_order_relaxed);
+	}
+
+	FrameAllocation FrameAllocator::allocate(const vk::DeviceSize size) {
+		// Every block keeps the head aligned.
+		const vk::DeviceSize alignedSize = AlignUp(std::max<vk::DeviceSize>(size, 1), m_Alignment);
+		const vk::DeviceSize offset = m_Head.fetch_add(alignedSize, std::memory_order_relaxed);
+		if (offset + alignedSize > m_RegionSize) {
+			throw std::runtime_error("[Vulkan] The frame allocator region is full!");
+		}
+
+		const vk::DeviceSize absolute = m_RegionBegin + offset;
+		return FrameAllocation{.buffer = *m_Buffer, .offset = absolute, .data = m_Mapped + absolute};
+	}
+
+	vk::DescriptorBufferInfo FrameAllocator::getDescriptorInfo(const vk::DeviceSize range) const {
+		return vk::DescriptorBufferInfo{.buffer = *m_Buffer, .offset = 0, .range = std::min(range, c_MaxBindingRange)};
+	}
+
+	vk::DeviceSize FrameAllocator::getUsedBytes() const {
+		return std::min(m_Head.load(std::memory_order_relaxed), m_RegionSize);
+	}
+
+	void FrameAllocator::clear() {
+		m_Buffer = VmaBuffer{};
+		m_Mapped = nullptr;
+		m_RegionSize = 0;
+		m_RegionBegin = 0;
+		m_Head = 0;
+	}
+} // MVT
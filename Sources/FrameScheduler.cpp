@@ -0,0 +1,129 @@
+//
+// Created by ianpo on 08/01/2026.
+//
+
+#include "MVT/FrameScheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "MVT/Log.hpp"
+
+namespace MVT {
+	// Signals passed alongside the timeline value (render finished...), kept on the stack.
+	static inline constexpr uint32_t c_MaxSignals = 4;
+
+	FrameScheduler::FrameScheduler(const vk::raii::Device &device, const uint32_t framesInFlight) : m_Device(&device) {
+		const vk::SemaphoreTypeCreateInfo typeInfo{.semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0};
+		m_Timeline = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{.pNext = &typeInfo});
+		setFramesInFlight(framesInFlight);
+		m_FramesInFlight = m_RequestedFramesInFlight;
+	}
+
+	void FrameScheduler::setFramesInFlight(const uint32_t framesInFlight) {
+		m_RequestedFramesInFlight = std::clamp(framesInFlight, 1u, c_MaxFramesInFlight);
+	}
+
+	uint32_t FrameScheduler::beginFrame() {
+		m_FramesInFlight = m_RequestedFramesInFlight;
+
+		const uint64_t frame = m_FrameCount;
+		m_Slot = static_cast<uint32_t>(frame % m_FramesInFlight);
+
+		// The slot's resources must be free, and no more than `m_FramesInFlight` frames may be pending, even right after the depth changed.
+		uint64_t value = m_SlotValues[m_Slot];
+		if (frame >= m_FramesInFlight) {
+			value = std::max(value, m_FrameValues[(frame - m_FramesInFlight) % c_MaxFramesInFlight]);
+		}
+		wait(value);
+
+		m_FrameValues[frame % c_MaxFramesInFlight] = 0;
+		m_FrameCount += 1;
+		return m_Slot;
+	}
+
+	uint64_t FrameScheduler::submitFrame(const vk::Queue queue, const std::span<const vk::CommandBufferSubmitInfo> commandBuffers, const std::span<const vk::SemaphoreSubmitInfo> waits, const std::span<const vk::SemaphoreSubmitInfo> signals) {
+		const uint64_t value = submitAndSignal(queue, commandBuffers, waits, signals);
+		m_SlotValues[m_Slot] = value;
+		m_FrameValues[(m_FrameCount - 1) % c_MaxFramesInFlight] = value;
+		return value;
+	}
+
+	uint64_t FrameScheduler::submit(const vk::Queue queue, const std::span<const vk::CommandBufferSubmitInfo> commandBuffers, const std::span<const vk::SemaphoreSubmitInfo> waits, const std::span<const vk::SemaphoreSubmitInfo> signals) {
+		return submitAndSignal(queue, commandBuffers, waits, signals);
+	}
+
+	uint64_t FrameScheduler::submitAndSignal(const vk::Queue queue, const std::span<const vk::CommandBufferSubmitInfo> commandBuffers, const std::span<const vk::SemaphoreSubmitInfo> waits, const std::span<const vk::SemaphoreSubmitInfo> signals) {
+		if (signals.size() >= c_MaxSignals) {
+			throw std::runtime_error("[Vulkan] Too many semaphores signaled by a single submission!");
+		}
+
+		// Values are handed out at submission, so they increase in the order the queue sees them.
+		const uint64_t value = m_LastValue + 1;
+
+		std::array<vk::SemaphoreSubmitInfo, c_MaxSignals> signalInfos{};
+		std::ranges::copy(signals, signalInfos.begin());
+		signalInfos[signals.size()] = vk::SemaphoreSubmitInfo{.semaphore = m_Timeline, .value = value, .stageMask = vk::PipelineStageFlagBits2::eAllCommands};
+
+		const vk::SubmitInfo2 submitInfo{
+			.waitSemaphoreInfoCount = static_cast<uint32_t>(waits.size()),
+			.pWaitSemaphoreInfos = waits.data(),
+			.commandBufferInfoCount = static_cast<uint32_t>(commandBuffers.size()),
+			.pCommandBufferInfos = commandBuffers.data(),
+			.signalSemaphoreInfoCount = static_cast<uint32_t>(signals.size() + 1),
+			.pSignalSemaphoreInfos = signalInfos.data(),
+		};
+		queue.submit2(submitInfo);
+
+		m_LastValue = value;
+		return value;
+	}
+
+	uint64_t FrameScheduler::getCompletedFrameCount() {
+		getCompletedValue();
+
+		// Older frames were waited on by `beginFrame`.
+		const uint64_t first = m_FrameCount > c_MaxFramesInFlight ? m_FrameCount - c_MaxFramesInFlight : 0;
+		for (uint64_t frame = first; frame < m_FrameCount; ++frame) {
+			const uint64_t value = m_FrameValues[frame % c_MaxFramesInFlight];
+			if (value == 0) {
+				// Never submitted: either the frame is being recorded, or it was dropped and has no work to wait for.
+				if (frame + 1 == m_FrameCount) return frame;
+				continue;
+			}
+			if (value > m_CompletedValue) return frame;
+		}
+
+		return m_FrameCount;
+	}
+
+	uint64_t FrameScheduler::getCompletedValue() {
+		m_CompletedValue = std::max(m_CompletedValue, m_Timeline.getCounterValue());
+		return m_CompletedValue;
+	}
+
+	bool FrameScheduler::isComplete(const uint64_t value) {
+		return value <= m_CompletedValue || value <= getCompletedValue();
+	}
+
+	void FrameScheduler::wait(const uint64_t value) {
+		if (value <= m_CompletedValue) return;
+
+		const vk::SemaphoreWaitInfo waitInfo{.semaphoreCount = 1, .pSemaphores = &*m_Timeline, .pValues = &value};
+		while (vk::Result::eTimeout == m_Device->waitSemaphores(waitInfo, UINT64_MAX)) {
+			MVT_LOG_LIMITED(WARN, Vulkan, "Waiting for the frame timeline timed out. Waiting again.");
+		}
+		m_CompletedValue = std::max(m_CompletedValue, value);
+	}
+
+	void FrameScheduler::clear() {
+		m_Timeline.clear();
+		m_Device = nullptr;
+		m_Slot = 0;
+		m_FrameCount = 0;
+		m_LastValue = 0;
+		m_CompletedValue = 0;
+		m_SlotValues = {};
+		m_FrameValues = {};
+	}
+} // MVT
@@ -0,0 +1,87 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#include "MVT/FrameScratch.hpp"
+
+#include <algorithm>
+
+#include "MVT/Log.hpp"
+
+namespace MVT {
+	static size_t AlignUp(const size_t value, const size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	FrameScratch::FrameScratch(const size_t capacity) : m_Capacity(AlignUp(std::max<size_t>(capacity, c_Alignment), c_Alignment)) {
+		m_Buffer = static_cast<std::byte *>(::operator new(m_Capacity, std::align_val_t{c_Alignment}));
+	}
+
+	FrameScratch::~FrameScratch() {
+		releaseSpills();
+		::operator delete(m_Buffer, std::align_val_t{c_Alignment});
+	}
+
+	void FrameScratch::reset() {
+		const size_t used = getUsedBytes();
+		const size_t spilled = m_SpilledBytes;
+		releaseSpills();
+		m_Head.store(0, std::memory_order_relaxed);
+		if (spilled == 0) return;
+
+		// The last frame didn't fit: make room for all of it, with some margin for the next ones.
+		const size_t capacity = AlignUp(std::max(2 * m_Capacity, 2 * (used + spilled)), c_Alignment);
+		::operator delete(m_Buffer, std::align_val_t{c_Alignment});
+		m_Buffer = static_cast<std::byte *>(::operator new(capacity, std::align_val_t{c_Alignment}));
+		m_Capacity = capacity;
+		MVT_LOG_DEBUG(Core, "[FrameScratch] {} byte(s) spilled to the heap, grown to {} KiB.", spilled, capacity / 1024);
+	}
+
+	size_t FrameScratch::getUsedBytes() const {
+		return std::min(m_Head.load(std::memory_order_relaxed), m_Capacity);
+	}
+
+	size_t FrameScratch::getSpilledBytes() const {
+		std::lock_guard lock(m_SpillMutex);
+		return m_SpilledBytes;
+	}
+
+	void *FrameScratch::do_allocate(const size_t bytes, const size_t alignment) {
+		if (alignment > c_Alignment) {
+			return spill(bytes, alignment);
+		}
+
+		// The arena is aligned on `c_Alignment`: aligning the offset aligns the address.
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		size_t offset = 0;
+		do {
+			offset = AlignUp(head, alignment);
+			if (offset + bytes > m_Capacity) {
+				return spill(bytes, alignment);
+			}
+		} while (!m_Head.compare_exchange_weak(head, offset + bytes, std::memory_order_relaxed));
+
+		return m_Buffer + offset;
+	}
+
+	void *FrameScratch::spill(const size_t bytes, const size_t alignment) {
+		const size_t blockAlignment = std::max(alignment, alignof(Spill));
+		const size_t header = AlignUp(sizeof(Spill), blockAlignment);
+		auto *block = static_cast<std::byte *>(::operator new(header + bytes, std::align_val_t{blockAlignment}));
+
+		std::lock_guard lock(m_SpillMutex);
+		m_Spills = new(block) Spill{.next = m_Spills, .alignment = blockAlignment};
+		m_SpilledBytes += bytes;
+		return block + header;
+	}
+
+	void FrameScratch::releaseSpills() {
+		std::lock_guard lock(m_SpillMutex);
+		while (m_Spills) {
+			Spill *spill = m_Spills;
+			m_Spills = spill->next;
+			::operator delete(spill, std::align_val_t{spill->alignment});
+		}
+		m_SpilledBytes = 0;
+	}
+} // MVT
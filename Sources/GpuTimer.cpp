@@ -0,0 +1,55 @@
+//
+// Created by ianpo on 05/01/2026.
+//
+
+#include "MVT/GpuTimer.hpp"
+
+namespace MVT {
+	GpuTimer::GpuTimer(const vk::raii::Device &device, const vk::raii::PhysicalDevice &physicalDevice, const uint32_t queueFamily, const uint32_t queryCount) {
+		const std::vector<vk::QueueFamilyProperties> families = physicalDevice.getQueueFamilyProperties();
+		const uint32_t validBits = queueFamily < families.size() ? families[queueFamily].timestampValidBits : 0;
+		if (validBits == 0 || queryCount == 0) {
+			// The queue doesn't support timestamps, the timer stays invalid.
+			return;
+		}
+
+		m_ValidBitsMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+		m_TimestampPeriod = physicalDevice.getProperties().limits.timestampPeriod;
+		m_QueryCount = queryCount;
+		m_QueryPool = vk::raii::QueryPool(device, vk::QueryPoolCreateInfo{.queryType = vk::QueryType::eTimestamp, .queryCount = queryCount});
+	}
+
+	void GpuTimer::reset(const vk::raii::CommandBuffer &commandBuffer, const uint32_t firstQuery, const uint32_t queryCount) const {
+		if (!isValid()) return;
+		commandBuffer.resetQueryPool(m_QueryPool, firstQuery, queryCount);
+	}
+
+	void GpuTimer::write(const vk::raii::CommandBuffer &commandBuffer, const vk::PipelineStageFlags2 stage, const uint32_t query) const {
+		if (!isValid()) return;
+		commandBuffer.writeTimestamp2(stage, m_QueryPool, query);
+	}
+
+	std::optional<double> GpuTimer::getElapsedMilliseconds(const uint32_t beginQuery, const uint32_t endQuery) const {
+		if (!isValid()) return std::nullopt;
+
+		// Read in place: the `vk::raii` overload returns a vector per call, and this runs every frame.
+		const vk::Device device = m_QueryPool.getDevice();
+		uint64_t begin = 0;
+		uint64_t end = 0;
+		const vk::Result beginResult = device.getQueryPoolResults(*m_QueryPool, beginQuery, 1, sizeof(uint64_t), &begin, sizeof(uint64_t), vk::QueryResultFlagBits::e64, *m_QueryPool.getDispatcher());
+		const vk::Result endResult = device.getQueryPoolResults(*m_QueryPool, endQuery, 1, sizeof(uint64_t), &end, sizeof(uint64_t), vk::QueryResultFlagBits::e64, *m_QueryPool.getDispatcher());
+		if (beginResult != vk::Result::eSuccess || endResult != vk::Result::eSuccess) {
+			return std::nullopt;
+		}
+
+		const uint64_t beginTicks = begin & m_ValidBitsMask;
+		const uint64_t endTicks = end & m_ValidBitsMask;
+		const uint64_t elapsed = endTicks >= beginTicks ? endTicks - beginTicks : 0;
+		return static_cast<double>(elapsed) * m_TimestampPeriod / 1'000'000.0;
+	}
+
+	void GpuTimer::clear() {
+		m_QueryPool.clear();
+		m_QueryCount = 0;
+	}
+} // MVT
@@ -0,0 +1,370 @@
+//
+// Created by ianpo on 17/01/2026.
+//
+
+#include "MVT/JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include "MVT/Log.hpp"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace MVT {
+	bool JobSystem::WorkDeque::push(Job *job) {
+		const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+		const int64_t top = m_Top.load(std::memory_order_acquire);
+		if (bottom - top >= static_cast<int64_t>(c_DequeCapacity)) return false;
+
+		m_Jobs[bottom & (c_DequeCapacity - 1)].store(job, std::memory_order_relaxed);
+		// Publishes the job to the thieves, they acquire the bottom.
+		m_Bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	JobSystem::Job *JobSystem::WorkDeque::pop() {
+		const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+		m_Bottom.store(bottom, std::memory_order_relaxed);
+		// The bottom must be visible before the top is read, a thief reads them the other way around.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_Top.load(std::memory_order_relaxed);
+
+		if (top > bottom) {
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job *job = m_Jobs[bottom & (c_DequeCapacity - 1)].load(std::memory_order_relaxed);
+		if (top == bottom) {
+			// Last job: race the thieves for it on the top.
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				job = nullptr;
+			}
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	JobSystem::Job *JobSystem::WorkDeque::steal() {
+		int64_t top = m_Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+		if (top >= bottom) return nullptr;
+
+		Job *job = m_Jobs[top & (c_DequeCapacity - 1)].load(std::memory_order_relaxed);
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return job;
+	}
+
+	void JobSystem::Initialize(const JobSystemSettings &settings) {
+		if (IsInitialized()) {
+			throw std::runtime_error("[JobSystem] Already initialized.");
+		}
+
+		const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		const uint32_t workerCount = settings.threadCount == 0 ? std::max(1u, hardwareThreads - 1) : settings.threadCount;
+
+		s_Stop.store(false, std::memory_order_relaxed);
+		s_Deques.clear();
+		for (uint32_t worker = 0; worker < workerCount; ++worker) {
+			s_Deques.push_back(std::make_unique<WorkDeque>());
+		}
+		s_Workers.reserve(workerCount);
+		for (uint32_t worker = 0; worker < workerCount; ++worker) {
+			s_Workers.emplace_back(&JobSystem::WorkerLoop, worker);
+			if (settings.pinThreads) {
+				Pin(s_Workers.back(), (worker + 1) % hardwareThreads);
+			}
+		}
+
+		MVT_LOG_INFO(Jobs, "{} worker(s){}.", workerCount, settings.pinThreads ? ", pinned" : "");
+	}
+
+	void JobSystem::Shutdown() {
+		if (!IsInitialized()) return;
+
+		Help(s_Detached);
+		s_Stop.store(true, std::memory_order_release);
+		s_Epoch.fetch_add(1, std::memory_order_release);
+		s_Epoch.notify_all();
+		for (std::thread &worker: s_Workers) {
+			worker.join();
+		}
+		s_Workers.clear();
+
+		// A job submitted while the workers were leaving.
+		while (true) {
+			Job *job = nullptr;
+			{
+				std::lock_guard lock(s_SharedMutex);
+				if (s_SharedCount == 0) break;
+				job = s_SharedJobs[s_SharedHead];
+				s_SharedHead = (s_SharedHead + 1) % c_DequeCapacity;
+				s_SharedCount -= 1;
+			}
+			Execute(job);
+		}
+		s_Deques.clear();
+	}
+
+	void JobSystem::Run(JobFunction function, JobCounter &counter) {
+		counter.m_Pending.fetch_add(1, std::memory_order_relaxed);
+		Job *job = GetPool().acquire();
+		job->function = std::move(function);
+		job->counter = &counter;
+		job->category = AllocationTracker::GetCategory();
+		if (!IsInitialized()) {
+			Execute(job);
+			return;
+		}
+		Submit(job);
+	}
+
+	void JobSystem::Run(JobFunction function, JobCounter &counter, const JobCounter &dependency) {
+		// The dependent job helps until the dependency is done, its worker never blocks.
+		Run([&dependency, function = std::move(function)]() {
+			Help(dependency);
+			function();
+		}, counter);
+	}
+
+	void JobSystem::Spawn(JobFunction function) {
+		Run(std::move(function), s_Detached);
+	}
+
+	void JobSystem::Wait(JobCounter &counter) {
+		Help(counter);
+		if (counter.m_Failed.exchange(false, std::memory_order_acquire)) {
+			std::rethrow_exception(std::exchange(counter.m_Error, nullptr));
+		}
+	}
+
+	void JobSystem::Help(const JobCounter &counter) {
+		while (!counter.isDone()) {
+			// Read before searching: a job submitted or a counter finished in between wakes the wait up.
+			const uint32_t epoch = s_Epoch.load(std::memory_order_acquire);
+			if (Job *job = FindJob()) {
+				Execute(job);
+				continue;
+			}
+			if (counter.isDone()) break;
+			s_Epoch.wait(epoch, std::memory_order_acquire);
+		}
+	}
+
+	uint32_t JobSystem::ParallelFor(const uint32_t count, const uint32_t minItemsPerJob, const RangeFunction function, uint32_t maxJobs) {
+		if (count == 0) return 0;
+
+		if (maxJobs == 0) maxJobs = GetWorkerCount() + 1;
+		const uint32_t minItems = std::max(1u, minItemsPerJob);
+		const uint32_t chunkCount = std::clamp((count + minItems - 1) / minItems, 1u, maxJobs);
+		const uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+		JobCounter counter;
+		for (uint32_t chunk = 1; chunk < chunkCount; ++chunk) {
+			const uint32_t begin = std::min(chunk * chunkSize, count);
+			const uint32_t end = std::min(begin + chunkSize, count);
+			// Small enough for the inline storage of `JobFunction`.
+			Run([&function, begin, end]() { function(begin, end); }, counter);
+		}
+
+		// The calling thread takes the first chunk, then helps with the rest.
+		std::exception_ptr error;
+		try {
+			function(0, std::min(chunkSize, count));
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		Wait(counter);
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		return chunkCount;
+	}
+
+	void JobSystem::Benchmark(const uint32_t jobCount) {
+		using Clock = std::chrono::high_resolution_clock;
+		std::atomic<uint64_t> sum{0};
+		const auto job = [&sum]() { sum.fetch_add(1, std::memory_order_relaxed); };
+
+		const auto serialStart = Clock::now();
+		for (uint32_t i = 0; i < jobCount; ++i) {
+			const JobFunction function{job};
+			function();
+		}
+		const double serialMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - serialStart).count();
+
+		// Spawned from a worker, the jobs go through its deque and get stolen by the others.
+		const auto runStart = Clock::now();
+		JobCounter root;
+		Run([&job, jobCount]() {
+			JobCounter children;
+			for (uint32_t i = 0; i < jobCount; ++i) {
+				Run(job, children);
+			}
+			Wait(children);
+		}, root);
+		Wait(root);
+		const double runMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - runStart).count();
+
+		const auto parallelStart = Clock::now();
+		const uint32_t chunks = ParallelFor(jobCount, 1, [&sum](const uint32_t begin, const uint32_t end) {
+			sum.fetch_add(end - begin, std::memory_order_relaxed);
+		});
+		const double parallelMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - parallelStart).count();
+
+		const bool complete = sum.load() == 3ull * jobCount;
+		MVT_LOG_INFO(Jobs, "{} empty jobs: serial {:.3f} ms, Run {:.3f} ms ({:.1f} ns per job), ParallelFor {:.3f} ms over {} chunk(s){}", jobCount, serialMilliseconds, runMilliseconds, runMilliseconds * 1000000.0 / std::max(1u, jobCount), parallelMilliseconds, chunks, complete ? "" : " (MISSING JOBS)");
+	}
+
+	void JobSystem::WorkerLoop(const uint32_t worker) {
+		s_Worker = worker;
+		s_Victim = worker + 1;
+		while (true) {
+			const uint32_t epoch = s_Epoch.load(std::memory_order_acquire);
+			if (Job *job = FindJob()) {
+				Execute(job);
+				continue;
+			}
+			// Only leave once nothing is left to run.
+			if (s_Stop.load(std::memory_order_acquire)) break;
+			s_Epoch.wait(epoch, std::memory_order_acquire);
+		}
+		s_Worker = UINT32_MAX;
+	}
+
+	JobSystem::Job *JobSystem::FindJob() {
+		if (s_Worker != UINT32_MAX) {
+			if (Job *job = s_Deques[s_Worker]->pop()) return job;
+		}
+
+		{
+			std::lock_guard lock(s_SharedMutex);
+			if (s_SharedCount > 0) {
+				Job *job = s_SharedJobs[s_SharedHead];
+				s_SharedHead = (s_SharedHead + 1) % c_DequeCapacity;
+				s_SharedCount -= 1;
+				return job;
+			}
+		}
+
+		// Round robin over the victims, starting after the last one robbed.
+		const auto dequeCount = static_cast<uint32_t>(s_Deques.size());
+		for (uint32_t i = 0; i < dequeCount; ++i) {
+			const uint32_t victim = (s_Victim + i) % dequeCount;
+			if (victim == s_Worker) continue;
+			if (Job *job = s_Deques[victim]->steal()) {
+				s_Victim = victim;
+				return job;
+			}
+		}
+		return nullptr;
+	}
+
+	void JobSystem::Execute(Job *job) {
+		JobCounter &counter = *job->counter;
+		try {
+			const AllocationScope scope{job->category};
+			job->function();
+		}
+		catch (...) {
+			if (!counter.m_Failed.exchange(true, std::memory_order_relaxed)) {
+				counter.m_Error = std::current_exception();
+			}
+		}
+		job->pool->release(job);
+
+		// The waiter may destroy the counter as soon as it reads 0, it is not touched past this point.
+		if (counter.m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			s_Epoch.fetch_add(1, std::memory_order_release);
+			s_Epoch.notify_all();
+		}
+	}
+
+	void JobSystem::Submit(Job *job) {
+		if (s_Worker != UINT32_MAX) {
+			if (!s_Deques[s_Worker]->push(job)) {
+				Execute(job);
+				return;
+			}
+		}
+		else {
+			std::unique_lock lock(s_SharedMutex);
+			if (s_SharedCount == c_DequeCapacity) {
+				lock.unlock();
+				Execute(job);
+				return;
+			}
+			s_SharedJobs[(s_SharedHead + s_SharedCount) % c_DequeCapacity] = job;
+			s_SharedCount += 1;
+		}
+		s_Epoch.fetch_add(1, std::memory_order_release);
+		s_Epoch.notify_one();
+	}
+
+	JobSystem::JobPool::~JobPool() {
+		for (Job *list: {free, returned.load(std::memory_order_acquire)}) {
+			while (list) {
+				delete std::exchange(list, list->next);
+			}
+		}
+	}
+
+	JobSystem::Job *JobSystem::JobPool::acquire() {
+		if (!free) {
+			free = returned.exchange(nullptr, std::memory_order_acquire);
+		}
+		if (!free) {
+			Job *job = new Job{};
+			job->pool = this;
+			return job;
+		}
+		return std::exchange(free, free->next);
+	}
+
+	void JobSystem::JobPool::release(Job *job) {
+		// Whatever the function captured goes now, not when the job is reused.
+		job->function = nullptr;
+		job->counter = nullptr;
+		// Push only, the owner takes the whole list at once: no ABA.
+		job->next = returned.load(std::memory_order_relaxed);
+		while (!returned.compare_exchange_weak(job->next, job, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+
+	JobSystem::JobPool &JobSystem::GetPool() {
+		if (!s_Pool) {
+			std::lock_guard lock(s_PoolsMutex);
+			s_Pool = s_Pools.emplace_back(std::make_unique<JobPool>()).get();
+		}
+		return *s_Pool;
+	}
+
+	void JobSystem::Pin(std::thread &thread, const uint32_t core) {
+#if defined(_WIN32)
+		if (core < 64 && SetThreadAffinityMask(thread.native_handle(), 1ull << core) == 0) {
+			MVT_LOG_WARN(Jobs, "Failed to pin a worker on core {}.", core);
+		}
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+		if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0) {
+			MVT_LOG_WARN(Jobs, "Failed to pin a worker on core {}.", core);
+		}
+#else
+		MVT_LOG_WARN(Jobs, "Thread pinning is not supported on this platform.");
+#endif
+	}
+} // MVT
@@ -0,0 +1,302 @@
+//
+// Created by ianpo on 03/01/2026.
+//
+
+#include "MVT/KTX2.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace MVT {
+	namespace {
+		constexpr std::array<uint8_t, 12> c_Identifier = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+		struct Ktx2Header {
+			uint32_t vkFormat;
+			uint32_t typeSize;
+			uint32_t pixelWidth;
+			uint32_t pixelHeight;
+			uint32_t pixelDepth;
+			uint32_t layerCount;
+			uint32_t faceCount;
+			uint32_t levelCount;
+			uint32_t supercompressionScheme;
+		};
+		static_assert(sizeof(Ktx2Header) == 36);
+
+		struct Ktx2Index {
+			uint32_t dfdByteOffset;
+			uint32_t dfdByteLength;
+			uint32_t kvdByteOffset;
+			uint32_t kvdByteLength;
+			uint64_t sgdByteOffset;
+			uint64_t sgdByteLength;
+		};
+		static_assert(sizeof(Ktx2Index) == 32);
+
+		struct Ktx2LevelIndex {
+			uint64_t byteOffset;
+			uint64_t byteLength;
+			uint64_t uncompressedByteLength;
+		};
+		static_assert(sizeof(Ktx2LevelIndex) == 24);
+
+		// Khronos Data Format values used by the Data Format Descriptor.
+		enum DfdModel : uint32_t { RGBSDA = 1, BC1A = 128, BC3 = 130, BC5 = 132, BC7 = 134 };
+		enum DfdTransfer : uint32_t { Linear = 1, SRGB = 2 };
+		constexpr uint32_t c_DfdPrimariesBT709 = 1;
+		constexpr uint32_t c_DfdQualifierLinear = 0x10;
+
+		struct DfdSample {
+			uint32_t channel;
+			uint32_t bitOffset;
+			uint32_t bitLength;
+			uint32_t upper;
+			bool linear;
+		};
+
+		bool IsSrgb(const vk::Format format) {
+			switch (format) {
+				case vk::Format::eR8G8B8A8Srgb:
+				case vk::Format::eBc1RgbSrgbBlock:
+				case vk::Format::eBc3SrgbBlock:
+				case vk::Format::eBc7SrgbBlock:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		std::vector<uint32_t> BuildDataFormatDescriptor(const vk::Format format) {
+			const FormatBlockInfo info = GetFormatBlockInfo(format);
+			const bool srgb = IsSrgb(format);
+
+			uint32_t model = RGBSDA;
+			std::vector<DfdSample> samples;
+			switch (format) {
+				case vk::Format::eR8G8B8A8Unorm:
+				case vk::Format::eR8G8B8A8Srgb:
+					samples = {{0, 0, 8, 255, false}, {1, 8, 8, 255, false}, {2, 16, 8, 255, false}, {15, 24, 8, 255, srgb}};
+					break;
+				case vk::Format::eBc1RgbUnormBlock:
+				case vk::Format::eBc1RgbSrgbBlock:
+					model = BC1A;
+					samples = {{0, 0, 64, 0xFFFFFFFF, false}};
+					break;
+				case vk::Format::eBc3UnormBlock:
+				case vk::Format::eBc3SrgbBlock:
+					model = BC3;
+					samples = {{15, 0, 64, 0xFFFFFFFF, srgb}, {0, 64, 64, 0xFFFFFFFF, false}};
+					break;
+				case vk::Format::eBc5UnormBlock:
+					model = BC5;
+					samples = {{0, 0, 64, 0xFFFFFFFF, false}, {1, 64, 64, 0xFFFFFFFF, false}};
+					break;
+				case vk::Format::eBc7UnormBlock:
+				case vk::Format::eBc7SrgbBlock:
+					model = BC7;
+					samples = {{0, 0, 128, 0xFFFFFFFF, false}};
+					break;
+				default:
+					break;
+			}
+
+			const uint32_t blockByteSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+			std::vector<uint32_t> dfd;
+			dfd.reserve(1 + blockByteSize / 4);
+			dfd.push_back(4 + blockByteSize); // dfdTotalSize
+			dfd.push_back(0); // vendorId = Khronos, descriptorType = basic
+			dfd.push_back(2u | (blockByteSize << 16)); // version 1.3
+			dfd.push_back(model | (c_DfdPrimariesBT709 << 8) | ((srgb ? SRGB : Linear) << 16));
+			dfd.push_back((info.blockWidth - 1) | ((info.blockHeight - 1) << 8));
+			dfd.push_back(info.blockSize);
+			dfd.push_back(0);
+			for (const DfdSample &sample: samples) {
+				const uint32_t channelType = sample.channel | (sample.linear ? c_DfdQualifierLinear : 0);
+				dfd.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16) | (channelType << 24));
+				dfd.push_back(0);
+				dfd.push_back(0);
+				dfd.push_back(sample.upper);
+			}
+
+			return dfd;
+		}
+
+		uint64_t AlignUp(const uint64_t value, const uint64_t alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	FormatBlockInfo GetFormatBlockInfo(const vk::Format format) {
+		switch (format) {
+			case vk::Format::eR8G8B8A8Unorm:
+			case vk::Format::eR8G8B8A8Srgb:
+				return {1, 1, 4};
+			case vk::Format::eBc1RgbUnormBlock:
+			case vk::Format::eBc1RgbSrgbBlock:
+				return {4, 4, 8};
+			case vk::Format::eBc3UnormBlock:
+			case vk::Format::eBc3SrgbBlock:
+			case vk::Format::eBc5UnormBlock:
+			case vk::Format::eBc7UnormBlock:
+			case vk::Format::eBc7SrgbBlock:
+				return {4, 4, 16};
+			default:
+				return {1, 1, 0};
+		}
+	}
+
+	uint64_t GetImageLevelSize(const vk::Format format, const uint32_t width, const uint32_t height) {
+		const FormatBlockInfo info = GetFormatBlockInfo(format);
+		const uint64_t blocksX = (width + info.blockWidth - 1) / info.blockWidth;
+		const uint64_t blocksY = (height + info.blockHeight - 1) / info.blockHeight;
+		return blocksX * blocksY * info.blockSize;
+	}
+
+	Expected<Ktx2Texture, std::string> Ktx2Texture::Load(const std::filesystem::path &path) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: Couldn't open '{}'.", path.string()));
+		}
+
+		const auto fileSize = static_cast<uint64_t>(file.tellg());
+		std::vector<uint8_t> bytes(fileSize);
+		file.seekg(0);
+		file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(fileSize));
+		if (!file || static_cast<uint64_t>(file.gcount()) != fileSize) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: Couldn't read '{}'.", path.string()));
+		}
+
+		if (fileSize < c_Identifier.size() + sizeof(Ktx2Header) + sizeof(Ktx2Index) || std::memcmp(bytes.data(), c_Identifier.data(), c_Identifier.size()) != 0) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: '{}' is not a KTX2 file.", path.string()));
+		}
+
+		Ktx2Header header{};
+		std::memcpy(&header, bytes.data() + c_Identifier.size(), sizeof(header));
+
+		if (header.supercompressionScheme != 0 || header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: '{}' uses an unsupported layout (only 2D, single layer, no supercompression).", path.string()));
+		}
+
+		Ktx2Texture texture{};
+		texture.format = static_cast<vk::Format>(header.vkFormat);
+		texture.width = header.pixelWidth;
+		texture.height = std::max(1u, header.pixelHeight);
+
+		if (GetFormatBlockInfo(texture.format).blockSize == 0) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: '{}' uses the unsupported format '{}'.", path.string(), vk::to_string(texture.format)));
+		}
+
+		// The level extents are shifts of the base one: more levels than the full chain would shift past it.
+		const uint32_t levelCount = std::max(1u, header.levelCount);
+		if (texture.width == 0 || levelCount > static_cast<uint32_t>(std::bit_width(std::max(texture.width, texture.height)))) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: '{}' has an invalid extent or level count.", path.string()));
+		}
+		const uint64_t levelIndexOffset = c_Identifier.size() + sizeof(Ktx2Header) + sizeof(Ktx2Index);
+		if (levelIndexOffset + levelCount * sizeof(Ktx2LevelIndex) > fileSize) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: '{}' is truncated.", path.string()));
+		}
+
+		texture.levels.resize(levelCount);
+		for (uint32_t level = 0; level < levelCount; ++level) {
+			Ktx2LevelIndex index{};
+			std::memcpy(&index, bytes.data() + levelIndexOffset + level * sizeof(Ktx2LevelIndex), sizeof(index));
+
+			const uint64_t expected = GetImageLevelSize(texture.format, texture.GetLevelWidth(level), texture.GetLevelHeight(level));
+			if (index.byteLength != expected || index.byteOffset + index.byteLength > fileSize) {
+				return Expected<Ktx2Texture, std::string>::unexpected(std::format("KTX2 ERR: '{}' has an invalid level {}.", path.string(), level));
+			}
+
+			texture.levels[level].assign(bytes.begin() + static_cast<std::ptrdiff_t>(index.byteOffset), bytes.begin() + static_cast<std::ptrdiff_t>(index.byteOffset + index.byteLength));
+		}
+
+		return Expected<Ktx2Texture, std::string>::expected(std::move(texture));
+	}
+
+	Expected<uint64_t, std::string> Ktx2Texture::Save(const std::filesystem::path &path) const {
+		const FormatBlockInfo info = GetFormatBlockInfo(format);
+		if (info.blockSize == 0 || levels.empty()) {
+			return Expected<uint64_t, std::string>::unexpected(std::format("KTX2 ERR: Cannot save '{}' with format '{}'.", path.string(), vk::to_string(format)));
+		}
+
+		const std::vector<uint32_t> dfd = BuildDataFormatDescriptor(format);
+		const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+
+		Ktx2Header header{
+			.vkFormat = static_cast<uint32_t>(format),
+			.typeSize = 1,
+			.pixelWidth = width,
+			.pixelHeight = height,
+			.pixelDepth = 0,
+			.layerCount = 0,
+			.faceCount = 1,
+			.levelCount = levelCount,
+			.supercompressionScheme = 0,
+		};
+
+		const uint64_t levelIndexOffset = c_Identifier.size() + sizeof(Ktx2Header) + sizeof(Ktx2Index);
+		Ktx2Index index{
+			.dfdByteOffset = static_cast<uint32_t>(levelIndexOffset + levelCount * sizeof(Ktx2LevelIndex)),
+			.dfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t)),
+			.kvdByteOffset = 0,
+			.kvdByteLength = 0,
+			.sgdByteOffset = 0,
+			.sgdByteLength = 0,
+		};
+
+		// Levels are stored from the smallest to the largest, each one aligned on lcm(blockSize, 4).
+		const uint64_t alignment = std::max<uint64_t>(info.blockSize, 4);
+		std::vector<Ktx2LevelIndex> indices(levelCount);
+		uint64_t offset = index.dfdByteOffset + index.dfdByteLength;
+		for (uint32_t i = levelCount; i-- > 0;) {
+			offset = AlignUp(offset, alignment);
+			indices[i] = {offset, levels[i].size(), levels[i].size()};
+			offset += levels[i].size();
+		}
+
+		std::vector<uint8_t> bytes(offset, 0);
+		std::memcpy(bytes.data(), c_Identifier.data(), c_Identifier.size());
+		std::memcpy(bytes.data() + c_Identifier.size(), &header, sizeof(header));
+		std::memcpy(bytes.data() + c_Identifier.size() + sizeof(header), &index, sizeof(index));
+		std::memcpy(bytes.data() + levelIndexOffset, indices.data(), indices.size() * sizeof(Ktx2LevelIndex));
+		std::memcpy(bytes.data() + index.dfdByteOffset, dfd.data(), index.dfdByteLength);
+		for (uint32_t i = 0; i < levelCount; ++i) {
+			std::memcpy(bytes.data() + indices[i].byteOffset, levels[i].data(), levels[i].size());
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+
+		// Written aside then renamed over the cache: a cook of the same texture running meanwhile never reads it half written.
+		std::filesystem::path temporary = path;
+		temporary += std::format(".{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			if (!file || !file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+				file.close();
+				std::filesystem::remove(temporary, ec);
+				return Expected<uint64_t, std::string>::unexpected(std::format("KTX2 ERR: Couldn't write '{}'.", path.string()));
+			}
+		}
+		std::filesystem::rename(temporary, path, ec);
+		if (ec) {
+			std::filesystem::remove(temporary, ec);
+			return Expected<uint64_t, std::string>::unexpected(std::format("KTX2 ERR: Couldn't write '{}'.", path.string()));
+		}
+
+		return Expected<uint64_t, std::string>::expected(bytes.size());
+	}
+
+	uint64_t Ktx2Texture::GetTotalSize() const {
+		uint64_t size = 0;
+		for (const auto &level: levels) {
+			size += level.size();
+		}
+		return size;
+	}
+} // MVT
@@ -0,0 +1,99 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#include "MVT/Log.hpp"
+
+#include <stdexcept>
+#include <vector>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+namespace MVT {
+	namespace {
+		constexpr std::array<const char *, static_cast<size_t>(LogCategory::Count)> c_CategoryNames = {
+			"core", "vulkan", "validation", "render", "shaders", "assets", "jobs",
+		};
+
+		// Time, thread, category, level.
+		constexpr const char *c_Pattern = "[%H:%M:%S.%e] [%t] [%n] [%^%l%$] %v";
+	}
+
+	void Log::Initialize(const LogSettings &settings) {
+		if (IsInitialized()) {
+			throw std::runtime_error("[Log] Already initialized.");
+		}
+
+		// A single flush thread: the messages keep their order across the categories.
+		spdlog::init_thread_pool(settings.queueSize, 1);
+		const std::vector<spdlog::sink_ptr> sinks = {std::make_shared<spdlog::sinks::stdout_color_sink_mt>()};
+
+		for (size_t category = 0; category < s_Loggers.size(); ++category) {
+			auto logger = std::make_shared<spdlog::async_logger>(c_CategoryNames[category], sinks.begin(), sinks.end(), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+			logger->set_pattern(c_Pattern);
+			logger->set_level(settings.level);
+			// Still asynchronous: queues a flush behind the error instead of writing it in place.
+			logger->flush_on(spdlog::level::err);
+			// Registered for `flush_every`.
+			spdlog::register_logger(logger);
+			s_Loggers[category] = std::move(logger);
+		}
+		spdlog::flush_every(settings.flushInterval);
+	}
+
+	void Log::Shutdown() {
+		if (!IsInitialized()) return;
+
+		for (std::shared_ptr<spdlog::logger> &logger: s_Loggers) {
+			logger->flush();
+			logger.reset();
+		}
+		// Joins the flusher and the thread pool once the queue is drained.
+		spdlog::shutdown();
+	}
+
+	spdlog::logger *Log::GetFallback() {
+		static const auto fallback = []() {
+			auto logger = std::make_shared<spdlog::logger>("mvt", std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+			logger->set_pattern(c_Pattern);
+			return logger;
+		}();
+		return fallback.get();
+	}
+
+	void Log::SetLevel(const spdlog::level::level_enum level) {
+		for (size_t category = 0; category < s_Loggers.size(); ++category) {
+			SetLevel(static_cast<LogCategory>(category), level);
+		}
+	}
+
+	void Log::SetLevel(const LogCategory category, const spdlog::level::level_enum level) {
+		Get(category)->set_level(level);
+	}
+
+	spdlog::level::level_enum Log::ParseLevel(const std::string_view name) {
+		const spdlog::level::level_enum level = spdlog::level::from_str(std::string(name));
+		// `from_str` returns `off` for unknown names.
+		return level == spdlog::level::off && name != "off" ? spdlog::level::info : level;
+	}
+
+	size_t Log::GetOverrunCount() {
+		return IsInitialized() ? spdlog::thread_pool()->overrun_counter() : 0;
+	}
+
+	bool LogRateLimiter::allow(uint32_t &suppressed) {
+		const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		int64_t windowStart = m_WindowStart.load(std::memory_order_relaxed);
+		// One thread opens the next window. A message counted in the old one meanwhile only shifts the budget.
+		if (now - windowStart >= c_Window.count() && m_WindowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+			m_Count.store(0, std::memory_order_relaxed);
+		}
+
+		if (m_Count.fetch_add(1, std::memory_order_relaxed) < m_Burst) {
+			suppressed = m_Suppressed.exchange(0, std::memory_order_relaxed);
+			return true;
+		}
+		m_Suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+} // MVT
@@ -42,9 +42,15 @@ namespace MVT {
 		// std::swap(uniformBuffersMapped, o.uniformBuffersMapped);
 		std::swap(m_VertexBuffer, o.m_VertexBuffer);
 		std::swap(m_VertexMemory, o.m_VertexMemory);
+		std::swap(m_PositionBuffer, o.m_PositionBuffer);
+		std::swap(m_PositionMemory, o.m_PositionMemory);
 		std::swap(m_IndexBuffer, o.m_IndexBuffer);
 		std::swap(m_IndicesMemory, o.m_IndicesMemory);
 		std::swap(indicesCount, o.indicesCount);
 		std::swap(vertexCount, o.vertexCount);
+		std::swap(materialIndex, o.materialIndex);
+		std::swap(streamedTextures, o.streamedTextures);
+		std::swap(boundsCenter, o.boundsCenter);
+		std::swap(boundsRadius, o.boundsRadius);
 	}
 } // MVT
\ No newline at end of file
@@ -0,0 +1,74 @@
+//
+// Created by ianpo on 04/01/2026.
+//
+
+#include "MVT/MipGenerator.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stb_image_resize2.h>
+
+#include "MVT/JobSystem.hpp"
+
+namespace MVT {
+	uint32_t MipGenerator::GetMipLevelCount(const uint32_t width, const uint32_t height) {
+		return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1u;
+	}
+
+	void MipGenerator::ResizeLevel(const uint8_t *src, const uint32_t srcWidth, const uint32_t srcHeight, uint8_t *dst, const uint32_t dstWidth, const uint32_t dstHeight, const bool srgb, const bool parallel) {
+		if (!parallel || static_cast<uint64_t>(dstWidth) * dstHeight < c_MinParallelPixels) {
+			if (srgb) {
+				stbir_resize_uint8_srgb(src, static_cast<int>(srcWidth), static_cast<int>(srcHeight), 0, dst, static_cast<int>(dstWidth), static_cast<int>(dstHeight), 0, STBIR_RGBA);
+			}
+			else {
+				stbir_resize_uint8_linear(src, static_cast<int>(srcWidth), static_cast<int>(srcHeight), 0, dst, static_cast<int>(dstWidth), static_cast<int>(dstHeight), 0, STBIR_RGBA);
+			}
+			return;
+		}
+
+		// The same resize split in bands of output rows, one job each.
+		STBIR_RESIZE resize;
+		stbir_resize_init(&resize, src, static_cast<int>(srcWidth), static_cast<int>(srcHeight), 0, dst, static_cast<int>(dstWidth), static_cast<int>(dstHeight), 0, STBIR_RGBA, srgb ? STBIR_TYPE_UINT8_SRGB : STBIR_TYPE_UINT8);
+		const int splits = stbir_build_samplers_with_splits(&resize, static_cast<int>(JobSystem::GetWorkerCount()) + 1);
+		JobSystem::ParallelFor(static_cast<uint32_t>(splits), 1, [&resize](const uint32_t begin, const uint32_t end) {
+			stbir_resize_extended_split(&resize, static_cast<int>(begin), static_cast<int>(end - begin));
+		}, static_cast<uint32_t>(splits));
+		stbir_free_samplers(&resize);
+	}
+
+	MipChain MipGenerator::Generate(const uint8_t *rgba, const uint32_t width, const uint32_t height, const bool srgb, const bool parallel) {
+		MipChain chain{};
+		chain.width = width;
+		chain.height = height;
+		chain.srgb = srgb;
+
+		const uint32_t levelCount = GetMipLevelCount(width, height);
+		chain.levels.resize(levelCount);
+		for (uint32_t level = 0; level < levelCount; ++level) {
+			chain.levels[level].resize(static_cast<uint64_t>(chain.GetLevelWidth(level)) * chain.GetLevelHeight(level) * 4);
+		}
+		std::memcpy(chain.levels[0].data(), rgba, chain.levels[0].size());
+
+		// Each level from the previous one: the whole chain costs about a third of the base level, instead of a base
+		// level per mip. The levels depend on each other, the large ones are split across the workers instead.
+		for (uint32_t level = 1; level < levelCount; ++level) {
+			ResizeLevel(chain.levels[level - 1].data(), chain.GetLevelWidth(level - 1), chain.GetLevelHeight(level - 1), chain.levels[level].data(), chain.GetLevelWidth(level), chain.GetLevelHeight(level), chain.srgb, parallel);
+		}
+
+		return chain;
+	}
+
+	std::vector<MipChain> MipGenerator::Generate(const std::span<const MipChainRequest> requests) {
+		std::vector<MipChain> chains(requests.size());
+		const auto count = static_cast<uint32_t>(requests.size());
+		// A job per texture, each splits its levels again: the workers steal whatever is left.
+		JobSystem::ParallelFor(count, 1, [&chains, requests](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				const MipChainRequest &request = requests[i];
+				chains[i] = Generate(request.rgba, request.width, request.height, request.srgb, true);
+			}
+		}, count);
+
+		return chains;
+	}
+} // MVT
@@ -0,0 +1,71 @@
+//
+// Created by ianpo on 09/01/2026.
+//
+
+#include "MVT/ParallelRecorder.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "MVT/AllocationTracker.hpp"
+#include "MVT/JobSystem.hpp"
+
+namespace MVT {
+	ParallelRecorder::ParallelRecorder(const vk::raii::Device &device, const uint32_t queueFamily, uint32_t threadCount) : m_Device(&device) {
+		if (threadCount == 0) threadCount = JobSystem::GetWorkerCount() + 1;
+
+		m_Contexts.resize(threadCount);
+		for (ThreadContext &context: m_Contexts) {
+			for (auto &pool: context.pools) {
+				// Transient and never reset per buffer: the whole pool is recycled with its frame slot.
+				pool = vk::raii::CommandPool(device, vk::CommandPoolCreateInfo{.flags = vk::CommandPoolCreateFlagBits::eTransient, .queueFamilyIndex = queueFamily});
+			}
+		}
+
+		m_Recorded.resize(threadCount);
+	}
+
+	void ParallelRecorder::beginFrame(const uint32_t slot) {
+		for (ThreadContext &context: m_Contexts) {
+			context.pools[slot].reset();
+			context.used[slot] = 0;
+		}
+	}
+
+	std::span<const vk::CommandBuffer> ParallelRecorder::record(const uint32_t slot, const vk::CommandBufferInheritanceRenderingInfo &rendering, const uint32_t itemCount, const uint32_t minItemsPerThread, const RecordFunction &function) {
+		const uint32_t minItems = std::max(1u, minItemsPerThread);
+		const uint32_t chunkCount = std::clamp((itemCount + minItems - 1) / minItems, 1u, getThreadCount());
+		const uint32_t chunkSize = (itemCount + chunkCount - 1) / chunkCount;
+
+		// One job per chunk: a pool is only ever used by the job recording its chunk, whichever worker runs it.
+		JobSystem::ParallelFor(chunkCount, 1, [&](const uint32_t beginChunk, const uint32_t endChunk) {
+			for (uint32_t chunk = beginChunk; chunk < endChunk; ++chunk) {
+				const uint32_t begin = std::min(chunk * chunkSize, itemCount);
+				const uint32_t end = std::min(begin + chunkSize, itemCount);
+				recordChunk(chunk, slot, rendering, begin, end, function);
+			}
+		}, chunkCount);
+
+		return {m_Recorded.data(), chunkCount};
+	}
+
+	void ParallelRecorder::recordChunk(const uint32_t chunk, const uint32_t slot, const vk::CommandBufferInheritanceRenderingInfo &rendering, const uint32_t begin, const uint32_t end, const RecordFunction &function) {
+		ThreadContext &context = m_Contexts[chunk];
+		auto &commandBuffers = context.commandBuffers[slot];
+		uint32_t &used = context.used[slot];
+		if (used == commandBuffers.size()) {
+			const AllocationScope scope{AllocationCategory::Resources};
+			const vk::CommandBufferAllocateInfo allocInfo{.commandPool = context.pools[slot], .level = vk::CommandBufferLevel::eSecondary, .commandBufferCount = 1};
+			commandBuffers.push_back(std::move(m_Device->allocateCommandBuffers(allocInfo).front()));
+		}
+		const vk::raii::CommandBuffer &commandBuffer = commandBuffers[used++];
+
+		const vk::CommandBufferInheritanceInfo inheritance{.pNext = &rendering};
+		commandBuffer.begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, .pInheritanceInfo = &inheritance});
+
+		function(commandBuffer, begin, end);
+
+		commandBuffer.end();
+		m_Recorded[chunk] = commandBuffer;
+	}
+} // MVT
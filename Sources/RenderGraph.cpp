@@ -0,0 +1,625 @@
+//
+// Created by ianpo on 11/01/2026.
+//
+
+#include "MVT/RenderGraph.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "MVT/AllocationTracker.hpp"
+#include "MVT/Log.hpp"
+
+namespace MVT {
+	static constexpr vk::AccessFlags2 c_WriteAccess = vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+	                                                  vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eShaderWrite |
+	                                                  vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eMemoryWrite;
+
+	static uint64_t HashCombine(const uint64_t hash, const uint64_t value) {
+		return (hash ^ value) * 0x100000001b3ull;
+	}
+
+	static vk::DeviceSize AlignUp(const vk::DeviceSize value, const vk::DeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	RenderGraph::PassBuilder &RenderGraph::PassBuilder::read(const RenderGraphHandle resource, const RenderGraphAccess access) {
+		m_Graph->addUse(m_Pass, resource, access);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder &RenderGraph::PassBuilder::write(const RenderGraphHandle resource, const RenderGraphAccess access) {
+		m_Graph->addUse(m_Pass, resource, access);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder &RenderGraph::PassBuilder::sideEffect() {
+		m_Graph->m_Passes[m_Pass].sideEffect = true;
+		return *this;
+	}
+
+	RenderGraph::RenderGraph(const vk::raii::Device &device, VmaAllocator allocator) : m_Device(&device), m_Allocator(allocator) {
+	}
+
+	RenderGraph::~RenderGraph() {
+		clear();
+	}
+
+	RenderGraph::RenderGraph(RenderGraph &&o) noexcept {
+		*this = std::move(o);
+	}
+
+	RenderGraph &RenderGraph::operator=(RenderGraph &&o) noexcept {
+		std::swap(m_Device, o.m_Device);
+		std::swap(m_Allocator, o.m_Allocator);
+		std::swap(m_Scratch, o.m_Scratch);
+		std::swap(m_Passes, o.m_Passes);
+		std::swap(m_Resources, o.m_Resources);
+		std::swap(m_TransientCount, o.m_TransientCount);
+		std::swap(m_ImageBarriers, o.m_ImageBarriers);
+		std::swap(m_BufferBarriers, o.m_BufferBarriers);
+		std::swap(m_FinalBarrierOffset, o.m_FinalBarrierOffset);
+		std::swap(m_Transients, o.m_Transients);
+		std::swap(m_Slot, o.m_Slot);
+		std::swap(m_Stats, o.m_Stats);
+		return *this;
+	}
+
+	RenderGraphAccessInfo RenderGraph::GetAccessInfo(const RenderGraphAccess access) {
+		using Stage = vk::PipelineStageFlagBits2;
+		using Access = vk::AccessFlagBits2;
+		using Layout = vk::ImageLayout;
+		using Usage = vk::ImageUsageFlagBits;
+
+		switch (access) {
+			case RenderGraphAccess::ColorAttachmentWrite:
+				return {Stage::eColorAttachmentOutput, Access::eColorAttachmentRead | Access::eColorAttachmentWrite, Layout::eColorAttachmentOptimal, Usage::eColorAttachment, true};
+			case RenderGraphAccess::DepthAttachmentWrite:
+				return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests, Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite, Layout::eDepthStencilAttachmentOptimal, Usage::eDepthStencilAttachment, true};
+			case RenderGraphAccess::DepthAttachmentRead:
+				return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests, Access::eDepthStencilAttachmentRead, Layout::eDepthStencilReadOnlyOptimal, Usage::eDepthStencilAttachment, false};
+			case RenderGraphAccess::SampledRead:
+				return {Stage::eFragmentShader | Stage::eComputeShader, Access::eShaderSampledRead, Layout::eShaderReadOnlyOptimal, Usage::eSampled, false};
+			case RenderGraphAccess::StorageRead:
+				return {Stage::eComputeShader, Access::eShaderStorageRead, Layout::eGeneral, Usage::eStorage, false};
+			case RenderGraphAccess::StorageWrite:
+				return {Stage::eComputeShader, Access::eShaderStorageRead | Access::eShaderStorageWrite, Layout::eGeneral, Usage::eStorage, true};
+			case RenderGraphAccess::TransferRead:
+				return {Stage::eAllTransfer, Access::eTransferRead, Layout::eTransferSrcOptimal, Usage::eTransferSrc, false};
+			case RenderGraphAccess::TransferWrite:
+				return {Stage::eAllTransfer, Access::eTransferWrite, Layout::eTransferDstOptimal, Usage::eTransferDst, true};
+			case RenderGraphAccess::UniformRead:
+				return {Stage::eVertexShader | Stage::eFragmentShader | Stage::eComputeShader, Access::eUniformRead, Layout::eUndefined, {}, false};
+			case RenderGraphAccess::VertexRead:
+				return {Stage::eVertexAttributeInput | Stage::eIndexInput, Access::eVertexAttributeRead | Access::eIndexRead, Layout::eUndefined, {}, false};
+			case RenderGraphAccess::IndirectRead:
+				return {Stage::eDrawIndirect, Access::eIndirectCommandRead, Layout::eUndefined, {}, false};
+		}
+
+		return {};
+	}
+
+	RenderGraphAccessInfo RenderGraph::GetLayoutAccessInfo(const vk::ImageLayout layout) {
+		switch (layout) {
+			case vk::ImageLayout::eTransferDstOptimal: return GetAccessInfo(RenderGraphAccess::TransferWrite);
+			case vk::ImageLayout::eTransferSrcOptimal: return GetAccessInfo(RenderGraphAccess::TransferRead);
+			case vk::ImageLayout::eShaderReadOnlyOptimal: return GetAccessInfo(RenderGraphAccess::SampledRead);
+			case vk::ImageLayout::eGeneral: return GetAccessInfo(RenderGraphAccess::StorageWrite);
+			case vk::ImageLayout::eColorAttachmentOptimal: return GetAccessInfo(RenderGraphAccess::ColorAttachmentWrite);
+			case vk::ImageLayout::eDepthAttachmentOptimal:
+			case vk::ImageLayout::eDepthStencilAttachmentOptimal: {
+				RenderGraphAccessInfo info = GetAccessInfo(RenderGraphAccess::DepthAttachmentWrite);
+				info.layout = layout;
+				return info;
+			}
+			case vk::ImageLayout::eDepthReadOnlyOptimal:
+			case vk::ImageLayout::eDepthStencilReadOnlyOptimal: {
+				RenderGraphAccessInfo info = GetAccessInfo(RenderGraphAccess::DepthAttachmentRead);
+				info.layout = layout;
+				return info;
+			}
+			case vk::ImageLayout::eUndefined:
+			case vk::ImageLayout::ePresentSrcKHR:
+			default:
+				return {.stages = vk::PipelineStageFlagBits2::eNone, .access = vk::AccessFlagBits2::eNone, .layout = layout};
+		}
+	}
+
+	vk::ImageAspectFlags RenderGraph::GetAspect(const vk::Format format) {
+		switch (format) {
+			case vk::Format::eD16Unorm:
+			case vk::Format::eD32Sfloat:
+			case vk::Format::eX8D24UnormPack32:
+				return vk::ImageAspectFlagBits::eDepth;
+			case vk::Format::eD16UnormS8Uint:
+			case vk::Format::eD24UnormS8Uint:
+			case vk::Format::eD32SfloatS8Uint:
+				return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+			case vk::Format::eS8Uint:
+				return vk::ImageAspectFlagBits::eStencil;
+			default:
+				return vk::ImageAspectFlagBits::eColor;
+		}
+	}
+
+	void RenderGraph::reset(FrameScratch &scratch) {
+		clearDeclarations();
+		m_Scratch = &scratch;
+	}
+
+	void RenderGraph::clearDeclarations() {
+		// Capacities are kept, the uses of the passes were in the previous frame's scratch.
+		m_Passes.clear();
+		m_Resources.clear();
+		m_TransientCount = 0;
+		m_ImageBarriers.clear();
+		m_BufferBarriers.clear();
+		m_FinalBarrierOffset = 0;
+	}
+
+	RenderGraphHandle RenderGraph::importImage(const char *name, const RenderGraphImportedImage &image) {
+		Resource resource{.name = name, .imported = true, .desc = image.desc, .image = image.image, .view = image.view, .finalLayout = image.finalLayout};
+		// The first barrier chains with whatever made the image available (the acquire semaphore wait for a swapchain image).
+		resource.state = State{.layout = image.initialLayout, .writeStages = image.initialStages};
+		m_Resources.push_back(std::move(resource));
+		return static_cast<RenderGraphHandle>(m_Resources.size() - 1);
+	}
+
+	RenderGraphHandle RenderGraph::importBuffer(const char *name, const vk::Buffer buffer, const vk::DeviceSize size) {
+		m_Resources.push_back(Resource{.name = name, .buffer = true, .imported = true, .bufferHandle = buffer, .size = size});
+		return static_cast<RenderGraphHandle>(m_Resources.size() - 1);
+	}
+
+	RenderGraphHandle RenderGraph::createImage(const char *name, const RenderGraphImageDesc &desc) {
+		m_Resources.push_back(Resource{.name = name, .desc = desc, .transient = m_TransientCount++});
+		return static_cast<RenderGraphHandle>(m_Resources.size() - 1);
+	}
+
+	RenderGraph::PassBuilder RenderGraph::addPass(const char *name, const ExecuteFunction execute) {
+		m_Passes.push_back(Pass{.name = name, .execute = execute, .uses = std::pmr::vector<Use>(m_Scratch)});
+		return PassBuilder{*this, static_cast<uint32_t>(m_Passes.size() - 1)};
+	}
+
+	void RenderGraph::addUse(const uint32_t pass, const RenderGraphHandle resource, const RenderGraphAccess access) {
+		if (resource >= m_Resources.size()) {
+			throw std::runtime_error("[RenderGraph] Unknown resource used by pass '" + std::string(m_Passes[pass].name) + "'!");
+		}
+
+		Resource &res = m_Resources[resource];
+		const RenderGraphAccessInfo info = GetAccessInfo(access);
+		if (!res.buffer && info.layout == vk::ImageLayout::eUndefined) {
+			throw std::runtime_error("[RenderGraph] '" + std::string(res.name) + "' is an image, it cannot be accessed as a buffer!");
+		}
+		for (const Use &use: m_Passes[pass].uses) {
+			if (use.resource == resource && !res.buffer && GetAccessInfo(use.access).layout != info.layout) {
+				throw std::runtime_error("[RenderGraph] Pass '" + std::string(m_Passes[pass].name) + "' uses '" + res.name + "' in two layouts!");
+			}
+		}
+
+		res.usage |= info.usage;
+		m_Passes[pass].uses.push_back(Use{.resource = resource, .access = access});
+	}
+
+	void RenderGraph::cull() {
+		// Walk backward: a pass lives if it writes something imported, or something a living pass uses.
+		for (auto &pass: std::ranges::reverse_view(m_Passes)) {
+			pass.alive = pass.sideEffect;
+			for (const Use &use: pass.uses) {
+				const Resource &resource = m_Resources[use.resource];
+				if (GetAccessInfo(use.access).write && (resource.imported || resource.needed)) {
+					pass.alive = true;
+				}
+			}
+
+			if (!pass.alive) continue;
+
+			// Writes count as uses too: the pass may load what an earlier pass wrote.
+			for (const Use &use: pass.uses) {
+				m_Resources[use.resource].needed = true;
+			}
+		}
+
+		m_Stats.passes = 0;
+		m_Stats.culledPasses = 0;
+		for (uint32_t i = 0; i < m_Passes.size(); ++i) {
+			if (!m_Passes[i].alive) {
+				m_Stats.culledPasses += 1;
+				continue;
+			}
+
+			m_Stats.passes += 1;
+			for (const Use &use: m_Passes[i].uses) {
+				Resource &resource = m_Resources[use.resource];
+				resource.firstPass = std::min(resource.firstPass, i);
+				resource.lastPass = std::max(resource.lastPass, i);
+			}
+		}
+	}
+
+	void RenderGraph::markMemoryless() {
+		constexpr vk::ImageUsageFlags attachmentUsage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment |
+		                                                vk::ImageUsageFlagBits::eInputAttachment | vk::ImageUsageFlagBits::eTransientAttachment;
+		for (Resource &resource: m_Resources) {
+			if (resource.transient == ~0u || !resource.usage || (resource.usage & ~attachmentUsage)) continue;
+			resource.usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+		}
+	}
+
+	uint64_t RenderGraph::computeTransientKey() const {
+		uint64_t key = HashCombine(0xcbf29ce484222325ull, m_TransientCount);
+		for (const Resource &resource: m_Resources) {
+			if (resource.transient == ~0u) continue;
+
+			key = HashCombine(key, static_cast<uint64_t>(resource.desc.format));
+			key = HashCombine(key, (static_cast<uint64_t>(resource.desc.extent.width) << 32) | resource.desc.extent.height);
+			key = HashCombine(key, (static_cast<uint64_t>(resource.desc.samples) << 32) | resource.desc.mipLevels);
+			key = HashCombine(key, static_cast<uint64_t>(static_cast<VkImageUsageFlags>(resource.usage)));
+			key = HashCombine(key, resource.needed ? (static_cast<uint64_t>(resource.firstPass) << 32) | resource.lastPass : ~0ull);
+		}
+		return key;
+	}
+
+	void RenderGraph::compile(const uint32_t slot) {
+		m_Slot = slot;
+		cull();
+		markMemoryless();
+
+		TransientSet &set = m_Transients[slot];
+		const uint64_t key = computeTransientKey();
+		if (set.key != key || set.images.size() != m_TransientCount) {
+			// The slot's previous frame completed, its images can go right away.
+			const AllocationScope scope{AllocationCategory::Resources};
+			buildTransients(set);
+			set.key = key;
+		}
+
+		for (Resource &resource: m_Resources) {
+			if (resource.transient == ~0u) continue;
+			const TransientImage &transient = set.images[resource.transient];
+			resource.image = *transient.image;
+			resource.view = *transient.view;
+		}
+		m_Stats.transientBytes = set.bytes;
+		m_Stats.unaliasedBytes = set.unaliasedBytes;
+		m_Stats.memorylessBytes = set.memorylessBytes;
+
+		computeBarriers(set);
+	}
+
+	void RenderGraph::buildTransients(TransientSet &set) {
+		releaseTransients(set);
+		set.images.resize(m_TransientCount);
+
+		struct Heap {
+			uint32_t memoryTypeBits = 0;
+			vk::DeviceSize alignment = 1;
+			vk::DeviceSize size = 0;
+		};
+		std::vector<Heap> heaps;
+		std::vector<uint32_t> order;
+		std::vector<uint32_t> memoryless;
+		std::vector<vk::MemoryRequirements> requirements(m_TransientCount);
+
+		for (const Resource &resource: m_Resources) {
+			if (resource.transient == ~0u || !resource.needed) continue;
+
+			TransientImage &transient = set.images[resource.transient];
+			const vk::ImageCreateInfo imageInfo{
+				.imageType = vk::ImageType::e2D, .format = resource.desc.format,
+				.extent = {resource.desc.extent.width, resource.desc.extent.height, 1}, .mipLevels = resource.desc.mipLevels, .arrayLayers = 1,
+				.samples = resource.desc.samples, .tiling = vk::ImageTiling::eOptimal, .usage = resource.usage,
+				.sharingMode = vk::SharingMode::eExclusive, .initialLayout = vk::ImageLayout::eUndefined,
+			};
+			transient.image = vk::raii::Image(*m_Device, imageInfo);
+			transient.firstPass = resource.firstPass;
+			transient.lastPass = resource.lastPass;
+			requirements[resource.transient] = transient.image.getMemoryRequirements();
+			transient.size = requirements[resource.transient].size;
+
+			// Lazily allocated memory is only committed if the content leaves the tile, it is not worth aliasing.
+			VmaAllocationCreateInfo lazyInfo{};
+			lazyInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+			uint32_t memoryType = 0;
+			if (resource.usage & vk::ImageUsageFlagBits::eTransientAttachment &&
+			    vmaFindMemoryTypeIndex(m_Allocator, requirements[resource.transient].memoryTypeBits, &lazyInfo, &memoryType) == VK_SUCCESS) {
+				memoryless.push_back(resource.transient);
+				continue;
+			}
+
+			set.unaliasedBytes += transient.size;
+			order.push_back(resource.transient);
+		}
+
+		// Biggest first, each image takes the lowest offset not used by an image alive at the same time.
+		std::ranges::sort(order, [&set](const uint32_t a, const uint32_t b) { return set.images[a].size > set.images[b].size; });
+		std::vector<uint32_t> placed;
+		for (const uint32_t index: order) {
+			TransientImage &transient = set.images[index];
+			const vk::MemoryRequirements &requirement = requirements[index];
+
+			auto heap = std::ranges::find(heaps, requirement.memoryTypeBits, &Heap::memoryTypeBits);
+			if (heap == heaps.end()) {
+				heaps.push_back(Heap{.memoryTypeBits = requirement.memoryTypeBits});
+				heap = heaps.end() - 1;
+			}
+			transient.heap = static_cast<uint32_t>(heap - heaps.begin());
+			heap->alignment = std::max(heap->alignment, requirement.alignment);
+
+			const auto overlaps = [&transient](const TransientImage &other) {
+				return other.heap == transient.heap && other.firstPass <= transient.lastPass && transient.firstPass <= other.lastPass;
+			};
+
+			std::vector<vk::DeviceSize> candidates{0};
+			for (const uint32_t other: placed) {
+				if (overlaps(set.images[other])) {
+					candidates.push_back(AlignUp(set.images[other].offset + set.images[other].size, requirement.alignment));
+				}
+			}
+			std::ranges::sort(candidates);
+
+			for (const vk::DeviceSize candidate: candidates) {
+				const bool free = std::ranges::none_of(placed, [&](const uint32_t other) {
+					const TransientImage &o = set.images[other];
+					return overlaps(o) && candidate < o.offset + o.size && o.offset < candidate + transient.size;
+				});
+				if (free) {
+					transient.offset = candidate;
+					break;
+				}
+			}
+
+			heap->size = std::max(heap->size, transient.offset + transient.size);
+			placed.push_back(index);
+		}
+
+		// An image reusing memory must wait for the images that used it before in the frame.
+		for (const uint32_t a: placed) {
+			for (const uint32_t b: placed) {
+				const TransientImage &earlier = set.images[b];
+				TransientImage &later = set.images[a];
+				if (a != b && earlier.heap == later.heap && earlier.lastPass < later.firstPass &&
+				    later.offset < earlier.offset + earlier.size && earlier.offset < later.offset + later.size) {
+					later.aliases.push_back(b);
+				}
+			}
+		}
+
+		for (const Heap &heap: heaps) {
+			const VkMemoryRequirements memoryRequirements{.size = heap.size, .alignment = heap.alignment, .memoryTypeBits = heap.memoryTypeBits};
+			VmaAllocationCreateInfo allocInfo{};
+			allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+			VmaAllocation allocation = nullptr;
+			if (vmaAllocateMemory(m_Allocator, &memoryRequirements, &allocInfo, &allocation, nullptr) != VK_SUCCESS) {
+				releaseTransients(set);
+				throw std::runtime_error("[RenderGraph] Failed to allocate the transient memory!");
+			}
+			set.heaps.push_back(allocation);
+			set.bytes += heap.size;
+		}
+
+		for (const uint32_t index: memoryless) {
+			TransientImage &transient = set.images[index];
+			const VkMemoryRequirements memoryRequirements = requirements[index];
+			VmaAllocationCreateInfo allocInfo{};
+			allocInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+
+			VmaAllocation allocation = nullptr;
+			if (vmaAllocateMemory(m_Allocator, &memoryRequirements, &allocInfo, &allocation, nullptr) != VK_SUCCESS) {
+				releaseTransients(set);
+				throw std::runtime_error("[RenderGraph] Failed to allocate the memoryless attachments!");
+			}
+			transient.heap = static_cast<uint32_t>(set.heaps.size());
+			transient.offset = 0;
+			set.heaps.push_back(allocation);
+			set.memorylessBytes += transient.size;
+		}
+
+		for (const Resource &resource: m_Resources) {
+			if (resource.transient == ~0u || !resource.needed) continue;
+
+			TransientImage &transient = set.images[resource.transient];
+			vmaBindImageMemory2(m_Allocator, set.heaps[transient.heap], transient.offset, *transient.image, nullptr);
+
+			const vk::ImageAspectFlags aspect = GetAspect(resource.desc.format);
+			const vk::ImageViewCreateInfo viewInfo{
+				.image = *transient.image, .viewType = vk::ImageViewType::e2D, .format = resource.desc.format,
+				// Attachments views only see the depth of depth/stencil formats.
+				.subresourceRange = {aspect & vk::ImageAspectFlagBits::eDepth ? vk::ImageAspectFlags{vk::ImageAspectFlagBits::eDepth} : aspect, 0, resource.desc.mipLevels, 0, 1},
+			};
+			transient.view = vk::raii::ImageView(*m_Device, viewInfo);
+		}
+
+		if (memoryless.empty()) {
+			MVT_LOG_INFO(Render, "[RenderGraph] Slot {}: {} transient image(s) in {} KiB ({} KiB without aliasing).", m_Slot, placed.size(), set.bytes / 1024, set.unaliasedBytes / 1024);
+		}
+		else {
+			MVT_LOG_INFO(Render, "[RenderGraph] Slot {}: {} transient image(s) in {} KiB ({} KiB without aliasing), {} memoryless attachment(s) saving {} KiB.", m_Slot, placed.size(), set.bytes / 1024, set.unaliasedBytes / 1024, memoryless.size(), set.memorylessBytes / 1024);
+		}
+	}
+
+	void RenderGraph::releaseTransients(TransientSet &set) {
+		set.images.clear();
+		for (VmaAllocation allocation: set.heaps) {
+			vmaFreeMemory(m_Allocator, allocation);
+		}
+		set.heaps.clear();
+		set.key = 0;
+		set.bytes = 0;
+		set.unaliasedBytes = 0;
+		set.memorylessBytes = 0;
+	}
+
+	void RenderGraph::synchronize(Resource &resource, const RenderGraphAccessInfo &info, const vk::PipelineStageFlags2 aliasStages, const vk::AccessFlags2 aliasAccess) {
+		State &state = resource.state;
+		const bool layoutChange = !resource.buffer && state.layout != info.layout;
+
+		vk::PipelineStageFlags2 srcStages{};
+		vk::AccessFlags2 srcAccess{};
+		bool needed = false;
+		if (layoutChange || info.write) {
+			// Write after write, write after read, or a layout transition which is a write as well.
+			srcStages = state.writeStages | state.readStages | aliasStages;
+			srcAccess = state.writeAccess | aliasAccess;
+			needed = layoutChange || srcStages;
+		}
+		else {
+			// Read after write, unless an earlier barrier already made the write visible to these stages.
+			srcStages = state.writeStages;
+			srcAccess = state.writeAccess;
+			needed = state.writeStages && ((info.stages & ~state.visibleStages) || (info.access & ~state.visibleAccess));
+		}
+
+		if (needed) {
+			if (resource.buffer) {
+				m_BufferBarriers.push_back(vk::BufferMemoryBarrier2{
+					.srcStageMask = srcStages, .srcAccessMask = srcAccess,
+					.dstStageMask = info.stages, .dstAccessMask = info.access,
+					.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+					.buffer = resource.bufferHandle, .offset = 0, .size = resource.size,
+				});
+			}
+			else {
+				m_ImageBarriers.push_back(vk::ImageMemoryBarrier2{
+					.srcStageMask = srcStages, .srcAccessMask = srcAccess,
+					.dstStageMask = info.stages, .dstAccessMask = info.access,
+					.oldLayout = state.layout, .newLayout = info.layout,
+					.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+					.image = resource.image,
+					.subresourceRange = {GetAspect(resource.desc.format), 0, vk::RemainingMipLevels, 0, vk::RemainingArrayLayers},
+				});
+			}
+		}
+
+		if (layoutChange || info.write) {
+			if (!resource.buffer) state.layout = info.layout;
+			state.writeStages = info.stages;
+			state.writeAccess = info.write ? info.access & c_WriteAccess : vk::AccessFlags2{};
+			state.readStages = info.write ? vk::PipelineStageFlags2{} : info.stages;
+			state.visibleStages = info.stages;
+			state.visibleAccess = info.access;
+		}
+		else {
+			state.readStages |= info.stages;
+			if (needed) {
+				state.visibleStages |= info.stages;
+				state.visibleAccess |= info.access;
+			}
+		}
+	}
+
+	void RenderGraph::computeBarriers(const TransientSet &set) {
+		m_ImageBarriers.clear();
+		m_BufferBarriers.clear();
+
+		std::pmr::vector<RenderGraphHandle> transientResources(m_TransientCount, ~0u, m_Scratch);
+		for (RenderGraphHandle i = 0; i < m_Resources.size(); ++i) {
+			if (m_Resources[i].transient != ~0u) transientResources[m_Resources[i].transient] = i;
+		}
+
+		for (uint32_t i = 0; i < m_Passes.size(); ++i) {
+			Pass &pass = m_Passes[i];
+			pass.firstImageBarrier = static_cast<uint32_t>(m_ImageBarriers.size());
+			pass.firstBufferBarrier = static_cast<uint32_t>(m_BufferBarriers.size());
+
+			if (pass.alive) {
+				for (const Use &use: pass.uses) {
+					Resource &resource = m_Resources[use.resource];
+
+					vk::PipelineStageFlags2 aliasStages{};
+					vk::AccessFlags2 aliasAccess{};
+					if (resource.transient != ~0u && resource.firstPass == i && resource.state.layout == vk::ImageLayout::eUndefined) {
+						for (const uint32_t alias: set.images[resource.transient].aliases) {
+							const State &previous = m_Resources[transientResources[alias]].state;
+							aliasStages |= previous.writeStages | previous.readStages;
+							aliasAccess |= previous.writeAccess;
+						}
+					}
+
+					synchronize(resource, GetAccessInfo(use.access), aliasStages, aliasAccess);
+				}
+			}
+
+			pass.imageBarrierCount = static_cast<uint32_t>(m_ImageBarriers.size()) - pass.firstImageBarrier;
+			pass.bufferBarrierCount = static_cast<uint32_t>(m_BufferBarriers.size()) - pass.firstBufferBarrier;
+		}
+
+		// Hand the imported images over in the layout expected after the graph.
+		m_FinalBarrierOffset = static_cast<uint32_t>(m_ImageBarriers.size());
+		for (Resource &resource: m_Resources) {
+			if (!resource.imported || resource.buffer || resource.finalLayout == vk::ImageLayout::eUndefined || resource.finalLayout == resource.state.layout) continue;
+
+			m_ImageBarriers.push_back(vk::ImageMemoryBarrier2{
+				.srcStageMask = resource.state.writeStages | resource.state.readStages, .srcAccessMask = resource.state.writeAccess,
+				.dstStageMask = vk::PipelineStageFlagBits2::eNone, .dstAccessMask = vk::AccessFlagBits2::eNone,
+				.oldLayout = resource.state.layout, .newLayout = resource.finalLayout,
+				.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.image = resource.image,
+				.subresourceRange = {GetAspect(resource.desc.format), 0, vk::RemainingMipLevels, 0, vk::RemainingArrayLayers},
+			});
+			resource.state.layout = resource.finalLayout;
+		}
+
+		m_Stats.barriers = static_cast<uint32_t>(m_ImageBarriers.size() + m_BufferBarriers.size());
+		m_Stats.barrierBatches = 0;
+		for (const Pass &pass: m_Passes) {
+			if (pass.imageBarrierCount + pass.bufferBarrierCount > 0) m_Stats.barrierBatches += 1;
+		}
+		if (m_FinalBarrierOffset < m_ImageBarriers.size()) m_Stats.barrierBatches += 1;
+	}
+
+	void RenderGraph::execute(const vk::raii::CommandBuffer &commandBuffer) const {
+		for (const Pass &pass: m_Passes) {
+			if (!pass.alive) continue;
+
+			if (pass.imageBarrierCount + pass.bufferBarrierCount > 0) {
+				commandBuffer.pipelineBarrier2(vk::DependencyInfo{
+					.bufferMemoryBarrierCount = pass.bufferBarrierCount,
+					.pBufferMemoryBarriers = m_BufferBarriers.data() + pass.firstBufferBarrier,
+					.imageMemoryBarrierCount = pass.imageBarrierCount,
+					.pImageMemoryBarriers = m_ImageBarriers.data() + pass.firstImageBarrier,
+				});
+			}
+
+			pass.execute.function(pass.execute.closure, commandBuffer, *this);
+		}
+
+		if (m_FinalBarrierOffset < m_ImageBarriers.size()) {
+			commandBuffer.pipelineBarrier2(vk::DependencyInfo{
+				.imageMemoryBarrierCount = static_cast<uint32_t>(m_ImageBarriers.size()) - m_FinalBarrierOffset,
+				.pImageMemoryBarriers = m_ImageBarriers.data() + m_FinalBarrierOffset,
+			});
+		}
+	}
+
+	vk::Image RenderGraph::getImage(const RenderGraphHandle resource) const {
+		return m_Resources[resource].image;
+	}
+
+	vk::ImageView RenderGraph::getImageView(const RenderGraphHandle resource) const {
+		return m_Resources[resource].view;
+	}
+
+	vk::Buffer RenderGraph::getBuffer(const RenderGraphHandle resource) const {
+		return m_Resources[resource].bufferHandle;
+	}
+
+	const RenderGraphImageDesc &RenderGraph::getImageDesc(const RenderGraphHandle resource) const {
+		return m_Resources[resource].desc;
+	}
+
+	void RenderGraph::clear() {
+		if (m_Allocator) {
+			for (TransientSet &set: m_Transients) {
+				releaseTransients(set);
+			}
+		}
+		clearDeclarations();
+		m_Scratch = nullptr;
+		m_Device = nullptr;
+		m_Allocator = nullptr;
+	}
+} // MVT
@@ -14,6 +14,7 @@
 #include <slang/slang-com-helper.h>
 
 #include "MVT/Expected.hpp"
+#include "MVT/Log.hpp"
 
 #define MVT_ARG1(arg1, ...) arg1
 #define MVT_ARG2(arg1, arg2, ...) arg2
@@ -38,20 +39,20 @@ namespace MVT {
 
 	void diagnoseIfNeeded(Slang::ComPtr<slang::IBlob> diagnosticsBlob, const char *preMsg = "Slang Diag ERR: ", const char *postMsg = "") {
 		if (diagnosticsBlob != nullptr) {
-			std::cerr << preMsg << (const char *) diagnosticsBlob->getBufferPointer() << postMsg << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}{}{}", preMsg, (const char *) diagnosticsBlob->getBufferPointer(), postMsg);
 		}
 	}
 
 	void diagnoseIfNeeded(slang::IBlob *diagnosticsBlob, const char *preMsg = "Slang Diag ERR: ", const char *postMsg = "") {
 		if (diagnosticsBlob != nullptr) {
-			std::cerr << preMsg << (const char *) diagnosticsBlob->getBufferPointer() << postMsg << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}{}{}", preMsg, (const char *) diagnosticsBlob->getBufferPointer(), postMsg);
 		}
 	}
 
 	void SlangCompiler::Initialize() {
 		s_GlobalSessionResult = slang::createGlobalSession(&s_GlobalSession);
 		if (SLANG_FAILED(s_GlobalSessionResult)) {
-			std::cerr << "Slang ERR: Failed to create the global session. (Facility :" << SLANG_GET_RESULT_FACILITY(s_GlobalSessionResult) << " ; Code :" << SLANG_GET_RESULT_CODE(s_GlobalSessionResult) << ")" << std::endl;
+			MVT_LOG_CRITICAL(Shaders, "Slang ERR: Failed to create the global session. (Facility :{} ; Code :{})", SLANG_GET_RESULT_FACILITY(s_GlobalSessionResult), SLANG_GET_RESULT_CODE(s_GlobalSessionResult));
 		}
 
 		s_MainCompiler = std::make_unique<SlangCompiler>();
@@ -67,8 +68,7 @@ namespace MVT {
 
 		const uint64_t compilerInUse = s_SlangCompilersInUse.load(std::memory_order::acquire);
 		if (compilerInUse > 0) {
-			std::cerr << "Slang ERR: Trying to shutdown but " << compilerInUse << " compilers are still in use." <<
-					std::endl;
+			MVT_LOG_ERROR(Shaders, "Slang ERR: Trying to shutdown but {} compilers are still in use.", compilerInUse);
 		}
 
 		slang::shutdown();
@@ -192,13 +192,13 @@ namespace MVT {
 
 		auto msg = checkDiagnostics(diagnostics);
 		if (msg) {
-			std::cerr << std::format("Compile Error [{0}] [{1}]\n", shaderName, entryPointName) << msg.value() << std::endl;
+			MVT_LOG_ERROR(Shaders, "Compile Error [{}] [{}]\n{}", shaderName, entryPointName, msg.value());
 			return std::move(msg.value());
 		}
 
 		if (!mdl) {
 			std::string error = std::format("Slang ERR: module '{}' not found.", shaderName);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return Expected<std::vector<char>, std::string>::unexpected(std::move(error));
 		}
 
@@ -211,14 +211,14 @@ namespace MVT {
 		const auto pStr = shaderPath.string();
 		if (!std::filesystem::exists(shaderPath)) {
 			std::string error = std::format("Slang ERR: The shader '{0}' doesn't exist", pStr);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return std::move(error);
 		}
 
 		const std::uintmax_t file_size = std::filesystem::file_size(shaderPath);
 		if (file_size == static_cast<std::uintmax_t>(-1)) {
 			std::string error = std::format("File ERR: The shader '{0}' couldn't be sized.", pStr);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return std::move(error);
 		}
 
@@ -228,7 +228,7 @@ namespace MVT {
 
 			if (!shaderFile) {
 				std::string error = std::format("Slang ERR: The shader '{0}' couldn't be opened.", pStr);
-				std::cerr << error << std::endl;
+				MVT_LOG_ERROR(Shaders, "{}", error);
 				return std::move(error);
 			}
 
@@ -247,13 +247,13 @@ namespace MVT {
 
 		auto msg = checkDiagnostics(diagnostics);
 		if (msg) {
-			std::cerr << std::format("Compile Error [{0}] [{1}]\n", pStr, entryPointName) << msg.value() << std::endl;
+			MVT_LOG_ERROR(Shaders, "Compile Error [{}] [{}]\n{}", pStr, entryPointName, msg.value());
 			return std::move(msg.value());
 		}
 
 		if (!mdl) {
 			std::string error = std::format("Slang ERR: module '{}' not found.", moduleName);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return Expected<std::vector<char>, std::string>::unexpected(std::move(error));
 		}
 
@@ -271,13 +271,13 @@ namespace MVT {
 
 		auto msg = checkDiagnostics(diagnostics);
 		if (msg) {
-			std::cerr << std::format("Compile Error [{0}]\n", shaderName) << msg.value() << std::endl;
+			MVT_LOG_ERROR(Shaders, "Compile Error [{}]\n{}", shaderName, msg.value());
 			return std::move(msg.value());
 		}
 
 		if (!mdl) {
 			std::string error = std::format("Slang ERR: module '{}' not found.", shaderName);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return Expected<std::vector<char>, std::string>::unexpected(std::move(error));
 		}
 
@@ -290,14 +290,14 @@ namespace MVT {
 		const auto pStr = shaderPath.string();
 		if (!std::filesystem::exists(shaderPath)) {
 			std::string error = std::format("Slang ERR: The shader '{0}' doesn't exist", pStr);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return std::move(error);
 		}
 
 		const std::uintmax_t file_size = std::filesystem::file_size(shaderPath);
 		if (file_size == static_cast<std::uintmax_t>(-1)) {
 			std::string error = std::format("File ERR: The shader '{0}' couldn't be sized.", pStr);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return std::move(error);
 		}
 
@@ -307,7 +307,7 @@ namespace MVT {
 
 			if (!shaderFile) {
 				std::string error = std::format("Slang ERR: The shader '{0}' couldn't be opened.", pStr);
-				std::cerr << error << std::endl;
+				MVT_LOG_ERROR(Shaders, "{}", error);
 				return std::move(error);
 			}
 
@@ -326,13 +326,13 @@ namespace MVT {
 
 		auto msg = checkDiagnostics(diagnostics);
 		if (msg) {
-			std::cerr << std::format("Compile Error [{0}]\n", pStr) << msg.value() << std::endl;
+			MVT_LOG_ERROR(Shaders, "Compile Error [{}]\n{}", pStr, msg.value());
 			return std::move(msg.value());
 		}
 
 		if (!mdl) {
 			std::string error = std::format("Slang ERR: module '{}' not found.", moduleName);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return Expected<std::vector<char>, std::string>::unexpected(std::move(error));
 		}
 		return CompileModule(std::move(slangModule), moduleName.c_str());
@@ -345,7 +345,7 @@ namespace MVT {
 	Expected<std::vector<char>, std::string> SlangCompiler::CompileModule(Slang::ComPtr<slang::IModule> slangModule, const char *moduleName, const char *entryPointName) {
 		if (!slangModule) {
 			std::string error = std::format("Slang ERR: module '{}' not found.", moduleName);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return Expected<std::vector<char>, std::string>::unexpected(std::move(error));
 		}
 
@@ -427,7 +427,7 @@ namespace MVT {
 	Expected<std::vector<char>, std::string> SlangCompiler::CompileModule(Slang::ComPtr<slang::IModule> slangModule, const char *moduleName) {
 		if (!slangModule) {
 			std::string error = std::format("Slang ERR: module '{}' not found.", moduleName);
-			std::cerr << error << std::endl;
+			MVT_LOG_ERROR(Shaders, "{}", error);
 			return Expected<std::vector<char>, std::string>::unexpected(std::move(error));
 		}
 
@@ -0,0 +1,68 @@
+//
+// Created by ianpo on 19/01/2026.
+//
+
+#include "MVT/StartupTrace.hpp"
+
+#include <algorithm>
+
+#include "MVT/Log.hpp"
+
+namespace MVT {
+	void StartupTrace::start() {
+		std::lock_guard lock(m_Mutex);
+		m_Start = Clock::now();
+		m_MainThread = std::this_thread::get_id();
+		m_Phases.clear();
+	}
+
+	void StartupTrace::record(const char *name, const Clock::time_point begin, const Clock::time_point end) {
+		std::lock_guard lock(m_Mutex);
+		m_Phases.push_back(Phase{.name = name, .begin = begin, .end = end, .thread = std::this_thread::get_id()});
+	}
+
+	void StartupTrace::report(const char *milestone) const {
+		const Clock::time_point now = Clock::now();
+		const auto milliseconds = [](const Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+		std::vector<Phase> phases;
+		{
+			std::lock_guard lock(m_Mutex);
+			phases = m_Phases;
+		}
+		std::ranges::sort(phases, {}, &Phase::begin);
+
+		// The other threads are numbered in the order they first show up.
+		std::vector<std::thread::id> threads;
+		Clock::duration phaseSum{};
+		Clock::duration covered{};
+		Clock::time_point coveredEnd = m_Start;
+		for (const Phase &phase: phases) {
+			uint32_t thread = 0;
+			if (phase.thread != m_MainThread) {
+				auto found = std::ranges::find(threads, phase.thread);
+				if (found == threads.end()) {
+					found = threads.insert(threads.end(), phase.thread);
+				}
+				thread = static_cast<uint32_t>(found - threads.begin()) + 1;
+			}
+
+			if (thread == 0) {
+				MVT_LOG_INFO(Core, "[Startup] {}: {:.2f} -> {:.2f} ms ({:.2f} ms) on the main thread.", phase.name, milliseconds(phase.begin - m_Start), milliseconds(phase.end - m_Start), milliseconds(phase.end - phase.begin));
+			}
+			else {
+				MVT_LOG_INFO(Core, "[Startup] {}: {:.2f} -> {:.2f} ms ({:.2f} ms) on worker {}.", phase.name, milliseconds(phase.begin - m_Start), milliseconds(phase.end - m_Start), milliseconds(phase.end - phase.begin), thread);
+			}
+
+			phaseSum += phase.end - phase.begin;
+			// Union of the phases, sorted by start: only what goes past the covered end counts.
+			const Clock::time_point begin = std::max(phase.begin, coveredEnd);
+			if (phase.end > begin) {
+				covered += phase.end - begin;
+				coveredEnd = phase.end;
+			}
+		}
+
+		MVT_LOG_INFO(Core, "[Startup] {} after {:.2f} ms. The phases took {:.2f} ms, {:.2f} ms of it side by side.", milestone, milliseconds(now - m_Start), milliseconds(phaseSum), milliseconds(phaseSum - covered));
+	}
+} // MVT
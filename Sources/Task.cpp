@@ -0,0 +1,88 @@
+//
+// Created by ianpo on 18/01/2026.
+//
+
+#include "MVT/Task.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace MVT {
+	namespace {
+		struct WhenAllAwaiter {
+			std::vector<Task<void>> &tasks;
+			std::atomic<size_t> remaining{0};
+			std::coroutine_handle<> continuation{};
+
+			[[nodiscard]] bool await_ready() const noexcept { return tasks.empty(); }
+
+			bool await_suspend(const std::coroutine_handle<> handle) {
+				continuation = handle;
+				// One more for this function: the last task may finish before every task was started.
+				remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+				for (Task<void> &task: tasks) {
+					Drive(task, *this);
+				}
+				return remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+			}
+
+			void await_resume() const noexcept {}
+
+			static Detail::DetachedTask Drive(Task<void> &task, WhenAllAwaiter &awaiter) {
+				co_await ScheduleOnJobs{};
+				co_await task.whenReady();
+				if (awaiter.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					awaiter.continuation.resume();
+				}
+			}
+		};
+	}
+
+	void TimelineResumer::Awaiter::await_suspend(const std::coroutine_handle<> handle) const {
+		std::lock_guard lock(resumer->m_Mutex);
+		resumer->m_Waiting.push_back(Waiting{.value = value, .handle = handle});
+	}
+
+	void TimelineResumer::resume(const uint64_t completedValue) {
+		m_Ready.clear();
+		{
+			std::lock_guard lock(m_Mutex);
+			const auto ready = std::ranges::stable_partition(m_Waiting, [completedValue](const Waiting &waiting) { return waiting.value > completedValue; });
+			m_Ready.assign(ready.begin(), ready.end());
+			m_Waiting.erase(ready.begin(), ready.end());
+		}
+
+		// Outside of the lock, a resumed coroutine may wait again.
+		for (const Waiting &waiting: m_Ready) {
+			waiting.handle.resume();
+		}
+	}
+
+	std::optional<uint64_t> TimelineResumer::getNextValue() const {
+		std::lock_guard lock(m_Mutex);
+		if (m_Waiting.empty()) return std::nullopt;
+		return std::ranges::min(m_Waiting, {}, &Waiting::value).value;
+	}
+
+	Task<void> WhenAll(std::vector<Task<void>> tasks) {
+		co_await WhenAllAwaiter{tasks};
+		for (Task<void> &task: tasks) {
+			task.getResult();
+		}
+	}
+
+	Task<std::vector<char>> ReadFileAsync(const std::filesystem::path path) {
+		co_await ScheduleOnJobs{};
+
+		std::ifstream file(path, std::ios::ate | std::ios::binary);
+		if (!file.is_open()) {
+			throw std::runtime_error("Failed to open " + path.string() + ".");
+		}
+
+		std::vector<char> buffer(static_cast<size_t>(file.tellg()));
+		file.seekg(0, std::ios::beg);
+		file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		co_return buffer;
+	}
+} // MVT
@@ -0,0 +1,136 @@
+//
+// Created by ianpo on 03/01/2026.
+//
+
+#include "MVT/TextureCooker.hpp"
+
+#include <array>
+#include <format>
+#include <optional>
+#include <stb_image.h>
+
+#include "MVT/JobSystem.hpp"
+#include "MVT/Log.hpp"
+#include "MVT/MipGenerator.hpp"
+
+namespace MVT {
+	namespace {
+		constexpr std::array c_ColorFormats = {vk::Format::eBc7SrgbBlock, vk::Format::eBc3SrgbBlock, vk::Format::eR8G8B8A8Srgb};
+		constexpr std::array c_ColorOpaqueFormats = {vk::Format::eBc7SrgbBlock, vk::Format::eBc1RgbSrgbBlock, vk::Format::eR8G8B8A8Srgb};
+		constexpr std::array c_NormalFormats = {vk::Format::eBc5UnormBlock, vk::Format::eR8G8B8A8Unorm};
+		constexpr std::array c_DataFormats = {vk::Format::eBc7UnormBlock, vk::Format::eBc3UnormBlock, vk::Format::eR8G8B8A8Unorm};
+	}
+
+	std::span<const vk::Format> TextureCooker::GetFormatCandidates(const TextureUsage usage) {
+		switch (usage) {
+			case TextureUsage::Color: return c_ColorFormats;
+			case TextureUsage::ColorOpaque: return c_ColorOpaqueFormats;
+			case TextureUsage::Normal: return c_NormalFormats;
+			case TextureUsage::Data: return c_DataFormats;
+		}
+		return c_ColorFormats;
+	}
+
+	std::optional<BlockFormat> TextureCooker::GetBlockFormat(const vk::Format format) {
+		switch (format) {
+			case vk::Format::eBc1RgbUnormBlock:
+			case vk::Format::eBc1RgbSrgbBlock:
+				return BlockFormat::BC1;
+			case vk::Format::eBc3UnormBlock:
+			case vk::Format::eBc3SrgbBlock:
+				return BlockFormat::BC3;
+			case vk::Format::eBc5UnormBlock:
+				return BlockFormat::BC5;
+			case vk::Format::eBc7UnormBlock:
+			case vk::Format::eBc7SrgbBlock:
+				return BlockFormat::BC7;
+			default:
+				return std::nullopt;
+		}
+	}
+
+	bool TextureCooker::IsSrgb(const vk::Format format) {
+		switch (format) {
+			case vk::Format::eR8G8B8A8Srgb:
+			case vk::Format::eBc1RgbSrgbBlock:
+			case vk::Format::eBc3SrgbBlock:
+			case vk::Format::eBc7SrgbBlock:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	std::filesystem::path TextureCooker::GetCachePath(const std::filesystem::path &source, const vk::Format format) {
+		const uint64_t hash = std::hash<std::string>{}(source.lexically_normal().generic_string());
+		return s_CacheDirectory / std::format("{}_{:016x}_{}.ktx2", source.stem().string(), hash, vk::to_string(format));
+	}
+
+	Expected<Ktx2Texture, std::string> TextureCooker::Cook(const std::filesystem::path &source, const vk::Format format, const bool persist) {
+		const std::filesystem::path cachePath = GetCachePath(source, format);
+
+		std::error_code ec;
+		if (persist && std::filesystem::exists(cachePath, ec) && std::filesystem::last_write_time(cachePath, ec) >= std::filesystem::last_write_time(source, ec)) {
+			auto cached = Ktx2Texture::Load(cachePath);
+			if (cached.has_value() && cached->format == format) {
+				return cached;
+			}
+		}
+
+		int texWidth, texHeight, texChannels;
+		stbi_uc *const pixels = stbi_load(source.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+		if (!pixels) {
+			return Expected<Ktx2Texture, std::string>::unexpected(std::format("Texture ERR: failed to load '{}'.", source.string()));
+		}
+
+		Ktx2Texture texture{};
+		texture.format = format;
+		texture.width = static_cast<uint32_t>(texWidth);
+		texture.height = static_cast<uint32_t>(texHeight);
+
+		const std::optional<BlockFormat> blockFormat = GetBlockFormat(format);
+		MipChain chain = MipGenerator::Generate(pixels, texture.width, texture.height, IsSrgb(format));
+		stbi_image_free(pixels);
+
+		texture.levels.resize(chain.levels.size());
+		for (uint32_t level = 0; level < chain.levels.size(); ++level) {
+			if (blockFormat) {
+				texture.levels[level] = BlockCompression::Encode(*blockFormat, chain.levels[level].data(), chain.GetLevelWidth(level), chain.GetLevelHeight(level));
+			}
+			else {
+				texture.levels[level] = std::move(chain.levels[level]);
+			}
+		}
+
+		if (!persist) {
+			return Expected<Ktx2Texture, std::string>::expected(std::move(texture));
+		}
+
+		auto saved = texture.Save(cachePath);
+		if (saved.has_error()) {
+			MVT_LOG_WARN(Assets, "{}", saved.error());
+		}
+
+		return Expected<Ktx2Texture, std::string>::expected(std::move(texture));
+	}
+
+	std::vector<Expected<Ktx2Texture, std::string>> TextureCooker::Cook(const std::span<const TextureCookRequest> requests) {
+		// A job per texture. Decode, mips and encode split again inside, a waiting cook runs the other jobs meanwhile.
+		std::vector<std::optional<Expected<Ktx2Texture, std::string>>> results(requests.size());
+		const auto count = static_cast<uint32_t>(requests.size());
+		JobSystem::ParallelFor(count, 1, [&results, requests](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				const TextureCookRequest &request = requests[i];
+				results[i].emplace(Cook(request.source, request.format, request.persist));
+			}
+		}, count);
+
+		std::vector<Expected<Ktx2Texture, std::string>> textures;
+		textures.reserve(requests.size());
+		for (auto &result: results) {
+			textures.push_back(std::move(*result));
+		}
+
+		return textures;
+	}
+} // MVT
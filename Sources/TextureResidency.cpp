@@ -0,0 +1,385 @@
+//
+// Created by ianpo on 07/01/2026.
+//
+
+#include "MVT/TextureResidency.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory_resource>
+#include <numeric>
+#include <utility>
+
+#include "MVT/AllocationTracker.hpp"
+
+namespace MVT {
+	// Offsets in the staging buffers stay aligned on the biggest block size.
+	static constexpr vk::DeviceSize c_StagingAlignment = 16;
+
+	static vk::DeviceSize AlignStaging(const vk::DeviceSize offset) {
+		return (offset + c_StagingAlignment - 1) & ~(c_StagingAlignment - 1);
+	}
+
+	TextureResidency::TextureResidency(const vk::raii::Device &device, VmaAllocator allocator, BindlessTable &bindlessTable, const vk::Sampler sampler, const uint32_t fallbackTextureSlot, const ResidencySettings settings) : m_Device(&device), m_Allocator(allocator), m_BindlessTable(&bindlessTable), m_FallbackSlot(fallbackTextureSlot), m_Settings(settings) {
+		m_SamplerSlot = m_BindlessTable->allocateSampler(sampler);
+	}
+
+	uint32_t TextureResidency::ComputeDesiredMip(const uint32_t width, const uint32_t height, const uint32_t mipLevels, const float screenExtent) {
+		const float texelsPerPixel = static_cast<float>(std::max(width, height)) / std::max(screenExtent, 1.0f);
+		if (texelsPerPixel <= 1.0f) {
+			return 0;
+		}
+
+		const auto mip = static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel)));
+		return std::min(mip, mipLevels - 1);
+	}
+
+	uint32_t TextureResidency::add(Ktx2Texture source) {
+		if (source.levels.empty()) {
+			return c_InvalidHandle;
+		}
+
+		StreamedTexture texture{};
+		texture.source = std::move(source);
+
+		const auto levelCount = static_cast<uint32_t>(texture.source.levels.size());
+		texture.lowestMip = levelCount - 1;
+		for (uint32_t level = 0; level < levelCount; ++level) {
+			if (std::max(texture.source.GetLevelWidth(level), texture.source.GetLevelHeight(level)) <= m_Settings.initialMaxExtent) {
+				texture.lowestMip = level;
+				break;
+			}
+		}
+		texture.requestedMip = texture.lowestMip;
+
+		m_Textures.push_back(std::move(texture));
+		return static_cast<uint32_t>(m_Textures.size() - 1);
+	}
+
+	void TextureResidency::request(const uint32_t handle, const uint32_t mip, const float priority, const uint64_t frame) {
+		if (handle >= m_Textures.size()) return;
+
+		StreamedTexture &texture = m_Textures[handle];
+		const uint32_t requested = std::min(mip, texture.lowestMip);
+		if (texture.lastRequestFrame != frame) {
+			// First request of the frame replaces the previous ones.
+			texture.requestedMip = requested;
+			texture.priority = priority;
+			texture.lastRequestFrame = frame;
+		}
+		else {
+			texture.requestedMip = std::min(texture.requestedMip, requested);
+			texture.priority = std::max(texture.priority, priority);
+		}
+	}
+
+	void TextureResidency::requestExtent(const uint32_t handle, const float screenExtent, const uint64_t frame) {
+		if (handle >= m_Textures.size()) return;
+
+		const Ktx2Texture &source = m_Textures[handle].source;
+		const uint32_t mip = ComputeDesiredMip(source.width, source.height, static_cast<uint32_t>(source.levels.size()), screenExtent);
+		request(handle, mip, screenExtent, frame);
+	}
+
+	uint64_t TextureResidency::GetRangeSize(const StreamedTexture &texture, const uint32_t firstMip, const uint32_t lastMip) {
+		uint64_t size = 0;
+		for (uint32_t level = firstMip; level < lastMip && level < texture.source.levels.size(); ++level) {
+			size += texture.source.levels[level].size();
+		}
+		return size;
+	}
+
+	void TextureResidency::queryBudget(uint64_t &usage, uint64_t &limit) const {
+		if (m_Settings.textureBudget != 0) {
+			usage = std::accumulate(m_Textures.begin(), m_Textures.end(), uint64_t{0}, [](const uint64_t sum, const StreamedTexture &texture) { return sum + texture.residentBytes; });
+			limit = m_Settings.textureBudget;
+			return;
+		}
+
+		const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+		vmaGetMemoryProperties(m_Allocator, &memoryProperties);
+		VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+		vmaGetHeapBudgets(m_Allocator, budgets);
+
+		uint64_t heapUsage = 0;
+		uint64_t heapBudget = 0;
+		for (uint32_t heap = 0; heap < memoryProperties->memoryHeapCount; ++heap) {
+			if (memoryProperties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+				heapUsage += budgets[heap].usage;
+				heapBudget += budgets[heap].budget;
+			}
+		}
+
+		// What is waiting for retirement is already as good as freed.
+		usage = heapUsage > m_RetiringBytes ? heapUsage - m_RetiringBytes : 0;
+		limit = static_cast<uint64_t>(static_cast<double>(heapBudget) * m_Settings.budgetFraction);
+	}
+
+	bool TextureResidency::changeResidency(StreamedTexture &texture, const uint32_t mip, const uint64_t frame, Batch &batch) {
+		// New image, view, staging buffer and copies: not a steady state frame.
+		const AllocationScope scope{AllocationCategory::Streaming};
+		const Ktx2Texture &source = texture.source;
+		const auto levelCount = static_cast<uint32_t>(source.levels.size());
+		const uint32_t oldMip = texture.residentMip;
+		const bool hadImage = oldMip != c_NotResident;
+
+		VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.format = static_cast<VkFormat>(source.format);
+		imageInfo.extent = {source.GetLevelWidth(mip), source.GetLevelHeight(mip), 1};
+		imageInfo.mipLevels = levelCount - mip;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// Growing fails instead of oversubscribing, the texture simply keeps its current mips. Shrinking allocates the
+		// smaller image before the larger one is freed: over budget is exactly when it must not fail.
+		VmaAllocationCreateInfo imageAllocInfo{};
+		imageAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+		if (!hadImage || mip < oldMip) {
+			imageAllocInfo.flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+		}
+
+		VmaImage image(m_Allocator, &imageInfo, &imageAllocInfo);
+		if (!image.IsValid()) {
+			return false;
+		}
+
+		// The previous image provides the mips both share, the others come from the cooked chain.
+		const uint32_t uploadEnd = hadImage ? std::min(oldMip, levelCount) : levelCount;
+		Copy copy{.source = hadImage ? *texture.image : vk::Image{}, .destination = *image};
+
+		VmaBuffer staging;
+		if (mip < uploadEnd) {
+			vk::DeviceSize stagingSize = 0;
+			for (uint32_t level = mip; level < uploadEnd; ++level) {
+				stagingSize = AlignStaging(stagingSize);
+				copy.bufferCopies.push_back(vk::BufferImageCopy{
+					.bufferOffset = stagingSize, .bufferRowLength = 0, .bufferImageHeight = 0,
+					.imageSubresource = {vk::ImageAspectFlagBits::eColor, level - mip, 0, 1},
+					.imageOffset = {0, 0, 0}, .imageExtent = {source.GetLevelWidth(level), source.GetLevelHeight(level), 1}
+				});
+				stagingSize += source.levels[level].size();
+			}
+
+			VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+			bufferInfo.size = stagingSize;
+			bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			VmaAllocationCreateInfo stagingAllocInfo{};
+			stagingAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+			stagingAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+			staging = VmaBuffer(m_Allocator, &bufferInfo, &stagingAllocInfo);
+			if (!staging.IsValid()) {
+				return false;
+			}
+
+			auto *data = static_cast<uint8_t *>(staging.GetAllocationInfo().pMappedData);
+			for (uint32_t level = mip; level < uploadEnd; ++level) {
+				std::memcpy(data + copy.bufferCopies[level - mip].bufferOffset, source.levels[level].data(), source.levels[level].size());
+			}
+			copy.staging = *staging;
+			m_Stats.uploadedBytes += stagingSize;
+		}
+
+		if (hadImage) {
+			for (uint32_t level = std::max(mip, oldMip); level < levelCount; ++level) {
+				copy.imageCopies.push_back(vk::ImageCopy{
+					.srcSubresource = {vk::ImageAspectFlagBits::eColor, level - oldMip, 0, 1}, .srcOffset = {0, 0, 0},
+					.dstSubresource = {vk::ImageAspectFlagBits::eColor, level - mip, 0, 1}, .dstOffset = {0, 0, 0},
+					.extent = {source.GetLevelWidth(level), source.GetLevelHeight(level), 1}
+				});
+			}
+
+			// Earlier frames may still be sampling it, the barrier orders the copy after them.
+			batch.before.push_back({
+				.srcStageMask = vk::PipelineStageFlagBits2::eFragmentShader, .srcAccessMask = vk::AccessFlagBits2::eNone,
+				.dstStageMask = vk::PipelineStageFlagBits2::eTransfer, .dstAccessMask = vk::AccessFlagBits2::eTransferRead,
+				.oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal, .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+				.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.image = copy.source, .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, levelCount - oldMip, 0, 1}
+			});
+		}
+
+		batch.before.push_back({
+			.srcStageMask = vk::PipelineStageFlagBits2::eNone, .srcAccessMask = vk::AccessFlagBits2::eNone,
+			.dstStageMask = vk::PipelineStageFlagBits2::eTransfer, .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.oldLayout = vk::ImageLayout::eUndefined, .newLayout = vk::ImageLayout::eTransferDstOptimal,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.image = copy.destination, .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, levelCount - mip, 0, 1}
+		});
+		batch.after.push_back({
+			.srcStageMask = vk::PipelineStageFlagBits2::eTransfer, .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader, .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+			.oldLayout = vk::ImageLayout::eTransferDstOptimal, .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored, .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.image = copy.destination, .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, levelCount - mip, 0, 1}
+		});
+		batch.copies.push_back(std::move(copy));
+
+		// A new slot: pending frames keep sampling the previous one.
+		vk::raii::ImageView view(*m_Device, vk::ImageViewCreateInfo{
+			                         .image = *image, .viewType = vk::ImageViewType::e2D, .format = source.format,
+			                         .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, levelCount - mip, 0, 1}
+		                         });
+		const uint32_t slot = m_BindlessTable->allocateTexture(*view);
+
+		if (hadImage) {
+			m_RetiringBytes += texture.residentBytes;
+			m_Retired.push_back(Retired{.frame = frame, .image = std::move(texture.image), .view = std::move(texture.view), .slot = texture.slot, .bytes = texture.residentBytes});
+		}
+		if (staging.IsValid()) {
+			m_Retired.push_back(Retired{.frame = frame, .staging = std::move(staging)});
+		}
+
+		texture.residentBytes = image.GetAllocationInfo().size;
+		texture.image = std::move(image);
+		texture.view = std::move(view);
+		texture.slot = slot;
+		texture.residentMip = mip;
+		texture.lastChangeFrame = frame;
+		m_SlotsChanged = true;
+		return true;
+	}
+
+	void TextureResidency::record(const vk::raii::CommandBuffer &commandBuffer, const uint64_t frame, FrameScratch &scratch) {
+		m_Stats.uploadedBytes = 0;
+		m_Stats.streamedIn = 0;
+		m_Stats.evicted = 0;
+
+		Batch batch;
+
+		// New textures get their lowest mips right away, whatever the budget says.
+		for (StreamedTexture &texture: m_Textures) {
+			if (texture.residentMip == c_NotResident) {
+				changeResidency(texture, texture.lowestMip, frame, batch);
+			}
+		}
+
+		uint64_t usage = 0;
+		uint64_t limit = 0;
+		queryBudget(usage, limit);
+
+		std::pmr::vector<uint32_t> order(m_Textures.size(), &scratch);
+		std::iota(order.begin(), order.end(), 0u);
+		std::ranges::sort(order, [this](const uint32_t a, const uint32_t b) { return m_Textures[a].priority < m_Textures[b].priority; });
+
+		// A texture changes once per batch: its new image is only in TRANSFER_DST until the barriers after the copies,
+		// another change this frame would read it before the first one wrote it.
+		const auto canChange = [frame](const StreamedTexture &texture) { return texture.residentMip != c_NotResident && texture.lastChangeFrame != frame; };
+
+		// Over budget: first drop what isn't requested anymore, then lower the least important textures one mip at a time.
+		const auto evict = [&](StreamedTexture &texture, const uint32_t mip) {
+			const uint64_t newSize = GetRangeSize(texture, mip, static_cast<uint32_t>(texture.source.levels.size()));
+			const uint64_t oldSize = texture.residentBytes;
+			if (changeResidency(texture, mip, frame, batch)) {
+				usage -= std::min(usage, oldSize > newSize ? oldSize - newSize : 0);
+				m_Stats.evicted += 1;
+			}
+		};
+
+		for (const uint32_t index: order) {
+			if (usage <= limit) break;
+			StreamedTexture &texture = m_Textures[index];
+			if (canChange(texture) && texture.residentMip < texture.requestedMip) {
+				evict(texture, texture.requestedMip);
+			}
+		}
+
+		for (const uint32_t index: order) {
+			if (usage <= limit) break;
+			StreamedTexture &texture = m_Textures[index];
+			if (canChange(texture) && texture.residentMip < texture.lowestMip) {
+				evict(texture, texture.residentMip + 1);
+			}
+		}
+
+		// Under budget: stream the most important textures in, as far as the budget and the upload cap allow.
+		for (auto it = order.rbegin(); it != order.rend(); ++it) {
+			StreamedTexture &texture = m_Textures[*it];
+			if (!canChange(texture) || texture.requestedMip >= texture.residentMip) continue;
+
+			const auto levelCount = static_cast<uint32_t>(texture.source.levels.size());
+			uint32_t target = texture.requestedMip;
+			for (; target < texture.residentMip; ++target) {
+				const uint64_t newSize = GetRangeSize(texture, target, levelCount);
+				const uint64_t upload = GetRangeSize(texture, target, texture.residentMip);
+				const bool fitsBudget = usage + newSize - std::min(newSize, texture.residentBytes) <= limit;
+				// Always let one step through, a single level may be bigger than the cap.
+				const bool fitsUpload = m_Stats.uploadedBytes == 0 || m_Stats.uploadedBytes + upload <= m_Settings.maxUploadBytesPerFrame;
+				if (fitsBudget && fitsUpload) break;
+			}
+
+			if (target == texture.residentMip) continue;
+
+			const uint64_t oldSize = texture.residentBytes;
+			if (changeResidency(texture, target, frame, batch)) {
+				usage += texture.residentBytes - std::min(texture.residentBytes, oldSize);
+				m_Stats.streamedIn += 1;
+			}
+
+			if (m_Stats.uploadedBytes >= m_Settings.maxUploadBytesPerFrame) break;
+		}
+
+		m_Stats.usageBytes = usage;
+		m_Stats.limitBytes = limit;
+		m_Stats.residentBytes = std::accumulate(m_Textures.begin(), m_Textures.end(), uint64_t{0}, [](const uint64_t sum, const StreamedTexture &texture) { return sum + texture.residentBytes; });
+
+		if (batch.copies.empty()) {
+			return;
+		}
+
+		commandBuffer.pipelineBarrier2({.imageMemoryBarrierCount = static_cast<uint32_t>(batch.before.size()), .pImageMemoryBarriers = batch.before.data()});
+		for (const Copy &copy: batch.copies) {
+			if (!copy.imageCopies.empty()) {
+				commandBuffer.copyImage(copy.source, vk::ImageLayout::eTransferSrcOptimal, copy.destination, vk::ImageLayout::eTransferDstOptimal, copy.imageCopies);
+			}
+			if (!copy.bufferCopies.empty()) {
+				commandBuffer.copyBufferToImage(copy.staging, copy.destination, vk::ImageLayout::eTransferDstOptimal, copy.bufferCopies);
+			}
+		}
+		commandBuffer.pipelineBarrier2({.imageMemoryBarrierCount = static_cast<uint32_t>(batch.after.size()), .pImageMemoryBarriers = batch.after.data()});
+	}
+
+	void TextureResidency::retire(const uint64_t completedFrame) {
+		std::erase_if(m_Retired, [this, completedFrame](Retired &retired) {
+			if (retired.frame > completedFrame) return false;
+			m_BindlessTable->release(BindlessResource::Texture, retired.slot);
+			m_RetiringBytes -= std::min(m_RetiringBytes, retired.bytes);
+			return true;
+		});
+	}
+
+	bool TextureResidency::consumeSlotChanges() {
+		return std::exchange(m_SlotsChanged, false);
+	}
+
+	uint32_t TextureResidency::getTextureSlot(const uint32_t handle) const {
+		if (handle >= m_Textures.size() || m_Textures[handle].slot == BindlessTable::c_InvalidSlot) {
+			return m_FallbackSlot;
+		}
+		return m_Textures[handle].slot;
+	}
+
+	uint32_t TextureResidency::getResidentMip(const uint32_t handle) const {
+		return handle < m_Textures.size() ? m_Textures[handle].residentMip : c_NotResident;
+	}
+
+	void TextureResidency::clear() {
+		m_Retired.clear();
+		m_Textures.clear();
+		m_RetiringBytes = 0;
+		m_SlotsChanged = false;
+		m_Stats = {};
+		m_SamplerSlot = BindlessTable::c_InvalidSlot;
+		m_BindlessTable = nullptr;
+		m_Allocator = nullptr;
+		m_Device = nullptr;
+	}
+} // MVT
@@ -6,7 +6,9 @@
 
 namespace MVT {
 	VmaBuffer::VmaBuffer(VmaAllocator allocator, const VkBufferCreateInfo* pBufferInfo, const VmaAllocationCreateInfo* pAllocInfo) {
-		vmaCreateBuffer(allocator, pBufferInfo, pAllocInfo, reinterpret_cast<VkBuffer*>(&buffer), &allocation, nullptr);
+		if (vmaCreateBuffer(allocator, pBufferInfo, pAllocInfo, reinterpret_cast<VkBuffer*>(&buffer), &allocation, nullptr) == VK_SUCCESS) {
+			this->allocator = allocator;
+		}
 	}
 
 	VmaBuffer::~VmaBuffer() {
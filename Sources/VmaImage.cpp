@@ -0,0 +1,51 @@
+//
+// Created by ianpo on 07/01/2026.
+//
+
+#include "MVT/VmaImage.hpp"
+
+namespace MVT {
+	VmaImage::VmaImage(VmaAllocator allocator, const VkImageCreateInfo* pImageInfo, const VmaAllocationCreateInfo* pAllocInfo) {
+		if (vmaCreateImage(allocator, pImageInfo, pAllocInfo, reinterpret_cast<VkImage*>(&image), &allocation, nullptr) == VK_SUCCESS) {
+			this->allocator = allocator;
+		}
+	}
+
+	VmaImage::~VmaImage() {
+		reset();
+	}
+
+	VmaImage::VmaImage(VmaImage &&o) noexcept {
+		swap(o);
+	}
+
+	VmaImage & VmaImage::operator=(VmaImage &&o) noexcept {
+		swap(o);
+		return *this;
+	}
+
+	void VmaImage::swap(VmaImage &o) noexcept {
+		std::swap(allocator, o.allocator);
+		std::swap(image, o.image);
+		std::swap(allocation, o.allocation);
+	}
+
+	void VmaImage::reset() {
+		if (allocator) {
+			vmaDestroyImage(allocator, image, allocation);
+		}
+		image = nullptr;
+		allocator = nullptr;
+		allocation = nullptr;
+	}
+
+	VmaAllocationInfo VmaImage::GetAllocationInfo() const {
+		VmaAllocationInfo allocationInfo{};
+
+		if (allocator) {
+			vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+		}
+
+		return allocationInfo;
+	}
+} // MVT
@@ -6,6 +6,8 @@
 #include <stdexcept>
 #include <string>
 
+#include "MVT/Log.hpp"
+
 using namespace std::string_literals;
 
 
@@ -156,8 +158,7 @@ namespace MVT {
 			if (count) {
 				++total_count;
 				const std::string name = alloc->m_Name.value_or("#"s + std::to_string(id));
-				const std::string err = name + " has still "s + std::to_string(count) + " allocations";
-				std::cerr << err << std::endl;
+				MVT_LOG_ERROR(Vulkan, "{} has still {} allocations", name, count);
 			}
 		}
 	}
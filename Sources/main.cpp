@@ -1,29 +1,125 @@
 
 
-#include <iostream>
-
 #include "MVT/Application.hpp"
+#include "MVT/JobSystem.hpp"
+#include "MVT/Log.hpp"
 #include "MVT/SlangCompiler.hpp"
 
-#include <iostream>
+#include <algorithm>
 #include <stdexcept>
 #include <cstdlib>
+#include <string_view>
+
+int main(int argc, char **argv) {
+	// First in, last out: every other system logs through it.
+	MVT::LogSettings log{};
+#ifndef NDEBUG
+	log.level = spdlog::level::debug;
+#endif
+	MVT::Log::Initialize(log);
 
-int main() {
 	MVT::SlangCompiler::AddPath(std::filesystem::current_path() / "EngineAssets/Shaders");
 	MVT::SlangCompiler::Initialize();
 
 	try {
 		std::unique_ptr<MVT::Application> app = std::make_unique<MVT::Application>();
+		MVT::AntiAliasingSettings antiAliasing{};
+		MVT::DynamicResolutionSettings dynamicResolution{};
+		MVT::JobSystemSettings jobs{};
+		uint32_t jobBenchmark = 0;
+		for (int i = 1; i + 1 < argc; ++i) {
+			const std::string_view option{argv[i]};
+			const auto value = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+			if (option == "--frames-in-flight") {
+				app->setFramesInFlight(value);
+			}
+			else if (option == "--record-threads") {
+				app->setRecordingThreads(value);
+			}
+			else if (option == "--stress-draws") {
+				app->setStressDraws(value);
+			}
+			else if (option == "--per-draw") {
+				app->setPerDrawPath(std::string_view{argv[i + 1]} == "uniform" ? MVT::PerDrawPath::DynamicUniform : MVT::PerDrawPath::PushConstants);
+			}
+			else if (option == "--per-draw-benchmark") {
+				app->setPerDrawBenchmark(value != 0);
+			}
+			else if (option == "--static-draws") {
+				app->setStaticDraws(value != 0);
+			}
+			else if (option == "--depth-prepass") {
+				app->setDepthPrepass(value != 0);
+			}
+			else if (option == "--single-sided") {
+				app->setSingleSidedModels(value != 0);
+			}
+			else if (option == "--aa") {
+				const std::string_view mode{argv[i + 1]};
+				antiAliasing.mode = mode == "none" ? MVT::AntiAliasingMode::None : mode == "fxaa" ? MVT::AntiAliasingMode::Fxaa : MVT::AntiAliasingMode::Msaa;
+			}
+			else if (option == "--msaa-samples") {
+				antiAliasing.samples = static_cast<vk::SampleCountFlagBits>(std::max(value, 1u));
+			}
+			else if (option == "--gpu-budget-ms") {
+				antiAliasing.adaptive = true;
+				antiAliasing.budgetMilliseconds = std::strtod(argv[i + 1], nullptr);
+			}
+			else if (option == "--dynamic-resolution-ms") {
+				dynamicResolution.enabled = true;
+				dynamicResolution.targetMilliseconds = std::strtod(argv[i + 1], nullptr);
+			}
+			else if (option == "--min-render-scale") {
+				dynamicResolution.minScale = std::strtod(argv[i + 1], nullptr);
+			}
+			else if (option == "--on-demand") {
+				app->setRenderOnDemand(value != 0);
+			}
+			else if (option == "--animate") {
+				app->setAnimation(value != 0);
+			}
+			else if (option == "--fps-cap") {
+				app->setFrameRateCap(value);
+			}
+			else if (option == "--check-allocations") {
+				app->setAllocationCheck(value);
+			}
+			else if (option == "--job-threads") {
+				jobs.threadCount = value;
+			}
+			else if (option == "--pin-threads") {
+				jobs.pinThreads = value != 0;
+			}
+			else if (option == "--job-benchmark") {
+				jobBenchmark = value;
+			}
+			else if (option == "--sort-benchmark") {
+				MVT::DrawQueue::Benchmark(value);
+			}
+			else if (option == "--log-level") {
+				MVT::Log::SetLevel(MVT::Log::ParseLevel(argv[i + 1]));
+			}
+		}
+		// Before anything loads: imports, cooks and recording all run on it.
+		MVT::JobSystem::Initialize(jobs);
+		if (jobBenchmark > 0) {
+			MVT::JobSystem::Benchmark(jobBenchmark);
+		}
+		app->setAntiAliasing(antiAliasing);
+		app->setDynamicResolution(dynamicResolution);
 		app->run();
 		app.reset();
 	} catch (const std::exception &e) {
-		std::cerr << e.what() << std::endl;
+		MVT_LOG_CRITICAL(Core, "{}", e.what());
+		MVT::JobSystem::Shutdown();
 		MVT::SlangCompiler::Shutdown();
+		MVT::Log::Shutdown();
 		return EXIT_FAILURE;
 	}
 
+	MVT::JobSystem::Shutdown();
 	MVT::SlangCompiler::Shutdown();
+	MVT::Log::Shutdown();
 
 	return EXIT_SUCCESS;
 }